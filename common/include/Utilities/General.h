@@ -248,6 +248,15 @@ extern void MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mo
 
 extern void Munmap(void *base, size_t size);
 
+// Maps a block of memory which other processes can open by name.  With create set a new
+// zero-filled block is created, replacing any stale one of that name, otherwise it has to
+// exist already.
+// Returns NULL on failure.  The block stays mapped until the process exits.
+extern void *MapSharedMemory(const char *name, size_t size, bool create);
+
+// Removes the name of a shared block, so it can't be opened anymore (the mappings remain).
+extern void UnlinkSharedMemory(const char *name);
+
 template <uint size>
 void MemProtectStatic(u8 (&arr)[size], const PageProtectionMode &mode)
 {
@@ -0,0 +1,181 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Pcsx2Types.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+// --------------------------------------------------------------------------------------
+//  Telemetry
+// --------------------------------------------------------------------------------------
+// Live metrics (counters, gauges and histograms) published through a shared memory block,
+// so external tools can sample them at any rate without going through the emulator's
+// threads.  The emulator creates the block of its process, plugins attach to it, and the
+// block is laid out as a Header followed by MaxMetrics Metric slots.
+//
+// Updates are single atomic operations on the slot, and slots are allocated with an atomic
+// increment, so neither publishing nor reading takes a lock.  Each metric is expected to
+// be updated by a single thread.
+//
+// This header is also used by tools/telemetry, and must not depend on anything but the
+// basic types.
+//
+namespace Telemetry
+{
+static const u32 Magic = 0x4d4c4554; // "TELM"
+static const u32 Version = 1;
+static const u32 MaxMetrics = 256;
+static const u32 MaxNameLength = 48;
+static const u32 HistogramBuckets = 32;
+
+enum MetricType {
+    Metric_None = 0,
+    Metric_Counter,   // monotonic total, readers derive rates from it
+    Metric_Gauge,     // last value (a double, stored as its bits)
+    Metric_Histogram, // sample count, sum and log2 buckets
+};
+
+struct Header
+{
+    std::atomic<u32> magic; // Magic once the header is initialized, 0 before
+    u32 version;
+    u32 maxMetrics;
+    std::atomic<u32> count; // allocated slots, may exceed maxMetrics when full
+    u64 reserved[6];
+};
+
+struct Metric
+{
+    std::atomic<u32> type; // Metric_None while the slot is being filled in
+    u32 reserved;
+    char name[MaxNameLength];
+
+    std::atomic<u64> value; // counters: total, gauges: double bits, histograms: samples
+    std::atomic<u64> sum;   // histograms: sum of the samples
+
+    // histograms: bucket 0 counts samples of 0, bucket n samples in [2^(n-1), 2^n)
+    std::atomic<u64> buckets[HistogramBuckets];
+};
+
+static const size_t SegmentSize = sizeof(Header) + sizeof(Metric) * MaxMetrics;
+
+// Name of the block of a process.
+static inline void FormatSegmentName(char *dest, size_t size, u32 pid)
+{
+#ifdef _WIN32
+    snprintf(dest, size, "Local\\pcsx2-telemetry-%u", pid);
+#else
+    snprintf(dest, size, "/pcsx2-telemetry-%u", pid);
+#endif
+}
+
+// Creates the block of this process.  Metrics are only published once it exists.
+extern bool Create();
+
+// Attaches to the block of this process if it has been created (for use by plugins).
+extern bool Attach();
+
+// Removes the name of the block, which stays mapped for the metrics that still use it.
+extern void Unlink();
+
+extern bool IsOpen();
+
+// Returns the slot of a metric, allocating it if needed.  Returns NULL when the block
+// isn't open or is full.
+extern Metric *Register(const char *name, MetricType type);
+
+// --------------------------------------------------------------------------------------
+//  Counter / Gauge / Histogram
+// --------------------------------------------------------------------------------------
+// Metrics register themselves on their first update after the block has been opened, and
+// do nothing before.  They're meant to be declared static.
+
+class BaseMetric
+{
+protected:
+    const char *m_name;
+    MetricType m_type;
+    Metric *m_slot;
+
+    BaseMetric(const char *name, MetricType type)
+    {
+        m_name = name;
+        m_type = type;
+        m_slot = NULL;
+    }
+
+    Metric *GetSlot()
+    {
+        if (!m_slot)
+            m_slot = Register(m_name, m_type);
+        return m_slot;
+    }
+};
+
+class Counter : public BaseMetric
+{
+public:
+    Counter(const char *name)
+        : BaseMetric(name, Metric_Counter)
+    {
+    }
+
+    void Add(u64 count = 1)
+    {
+        if (Metric *slot = GetSlot())
+            slot->value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // For totals which are kept elsewhere, like thread CPU times.
+    void Set(u64 total)
+    {
+        if (Metric *slot = GetSlot())
+            slot->value.store(total, std::memory_order_relaxed);
+    }
+};
+
+class Gauge : public BaseMetric
+{
+public:
+    Gauge(const char *name)
+        : BaseMetric(name, Metric_Gauge)
+    {
+    }
+
+    void Set(double value)
+    {
+        if (Metric *slot = GetSlot()) {
+            u64 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            slot->value.store(bits, std::memory_order_relaxed);
+        }
+    }
+};
+
+class Histogram : public BaseMetric
+{
+public:
+    Histogram(const char *name)
+        : BaseMetric(name, Metric_Histogram)
+    {
+    }
+
+    void Record(u64 sample);
+};
+}
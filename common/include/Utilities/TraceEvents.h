@@ -0,0 +1,218 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// --------------------------------------------------------------------------------------
+//  TraceEvents
+// --------------------------------------------------------------------------------------
+// Scoped timeline markers, for seeing how the emulator's threads overlap within a frame.
+// Each thread which records markers owns a Track: a ring holding the last TrackEvents
+// completed scopes, so recording one is a few stores and never takes a lock.  The tracks
+// of a module are linked into the module's Registry, whose lock is only taken to add or
+// remove a track and to read the rings.
+//
+// Nothing is recorded (or allocated) until the registry is enabled, which also hands it
+// the clock to use.  The emulator enables its own registry and those of the plugins (see
+// the optional <plugin>traceRegistry export) with GetCPUTicks, so all the tracks share one
+// timeline, and writes them out as a Chrome trace on demand.
+//
+// This header is also used by plugins which don't link Utilities (nor share the emulator's
+// basic types), and must not depend on anything but the standard library.
+//
+namespace TraceEvents
+{
+static const uint32_t TrackEvents = 1 << 15; // per track, must be a power of two
+static const uint32_t MaxNameLength = 32;
+
+typedef uint64_t (*ClockFn)();
+
+struct Event
+{
+    uint64_t begin;
+    uint64_t end;
+    const char *name; // must outlive the module, so a literal
+};
+
+class Track;
+
+class Registry
+{
+public:
+    std::mutex lock;
+    Track *tracks;
+
+    Registry()
+        : tracks(NULL)
+        , m_clock(NULL)
+    {
+    }
+
+    // Recording starts with the next scopes when given a clock, and stops with a NULL one.
+    void Enable(ClockFn clock) { m_clock.store(clock, std::memory_order_relaxed); }
+
+    ClockFn GetClock() const { return m_clock.load(std::memory_order_relaxed); }
+
+protected:
+    std::atomic<ClockFn> m_clock;
+};
+
+// The registry of this module (inline rather than static, so there's one per module and
+// not one per translation unit).
+inline Registry &GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// --------------------------------------------------------------------------------------
+//  Track
+// --------------------------------------------------------------------------------------
+// Only one thread may record into a track at a time.  Tracks are meant to be declared
+// static, or to be members of objects which belong to a single thread.
+//
+class Track
+{
+public:
+    Track *next;
+
+    Track(const char *name)
+        : m_registry(GetRegistry())
+        , m_events(NULL)
+        , m_count(0)
+    {
+        uint32_t i = 0;
+        for (; name[i] && i < MaxNameLength - 1; i++)
+            m_name[i] = name[i];
+        m_name[i] = 0;
+
+        std::lock_guard<std::mutex> lock(m_registry.lock);
+        next = m_registry.tracks;
+        m_registry.tracks = this;
+    }
+
+    ~Track()
+    {
+        std::lock_guard<std::mutex> lock(m_registry.lock);
+        for (Track **link = &m_registry.tracks; *link; link = &(*link)->next) {
+            if (*link == this) {
+                *link = next;
+                break;
+            }
+        }
+        delete[] m_events.load(std::memory_order_relaxed);
+    }
+
+    const char *GetName() const { return m_name; }
+
+    ClockFn GetClock() const { return m_registry.GetClock(); }
+
+    void Record(const char *name, uint64_t begin, uint64_t end)
+    {
+        Event *events = m_events.load(std::memory_order_relaxed);
+        if (!events && !(events = Allocate()))
+            return;
+
+        const uint64_t count = m_count.load(std::memory_order_relaxed);
+
+        // Readers which see the slot being overwritten also see the count it was taken at
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Event &event = events[count & (TrackEvents - 1)];
+        event.begin = begin;
+        event.end = end;
+        event.name = name;
+        m_count.store(count + 1, std::memory_order_release);
+    }
+
+    // Appends the events still in the ring to dest, oldest first.  Must be called with
+    // the registry locked; events overwritten by the recording thread while they were
+    // being copied are dropped.
+    void Read(std::vector<Event> &dest) const
+    {
+        const Event *events = m_events.load(std::memory_order_acquire);
+        if (!events)
+            return;
+
+        const uint64_t end = m_count.load(std::memory_order_acquire);
+        uint64_t start = end > TrackEvents ? end - TrackEvents : 0;
+
+        const size_t base = dest.size();
+        for (uint64_t i = start; i < end; i++)
+            dest.push_back(events[i & (TrackEvents - 1)]);
+
+        // The slot of event n is rewritten while event n + TrackEvents is being recorded.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = m_count.load(std::memory_order_relaxed);
+        const uint64_t valid = now >= TrackEvents ? now - TrackEvents + 1 : 0;
+        if (valid > start)
+            dest.erase(dest.begin() + base, dest.begin() + base + (size_t)((valid < end ? valid : end) - start));
+    }
+
+protected:
+    Registry &m_registry;
+    char m_name[MaxNameLength];
+
+    std::atomic<Event *> m_events;  // allocated by the first event
+    std::atomic<uint64_t> m_count; // events recorded so far
+
+    Event *Allocate()
+    {
+        Event *events = new (std::nothrow) Event[TrackEvents];
+        if (events) {
+            std::lock_guard<std::mutex> lock(m_registry.lock);
+            m_events.store(events, std::memory_order_release);
+        }
+        return events;
+    }
+};
+
+// --------------------------------------------------------------------------------------
+//  Scope
+// --------------------------------------------------------------------------------------
+// Records an event spanning its own lifetime, when the registry is enabled.
+//
+class Scope
+{
+public:
+    Scope(Track &track, const char *name)
+        : m_track(track)
+        , m_name(name)
+        , m_clock(track.GetClock())
+    {
+        if (m_clock)
+            m_begin = m_clock();
+    }
+
+    ~Scope()
+    {
+        if (m_clock)
+            m_track.Record(m_name, m_begin, m_clock());
+    }
+
+protected:
+    Track &m_track;
+    const char *m_name;
+    ClockFn m_clock;
+    uint64_t m_begin;
+};
+}
@@ -0,0 +1,68 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Implement a subset of the AVX/AVX2 instruction set (VEX encoded integer ops)
+//
+// There is no dedicated ymm register type: the xRegisterSSE Id selects the register,
+// and the 'wide' parameter selects between the 128-bits (xmm) and 256-bits (ymm) form.
+
+namespace x86Emitter
+{
+
+struct xImplAVX_Move
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    // VMOVDQU, VPMOVZX*, VPMOVSX*
+    void operator()(const xRegisterSSE &to, const xIndirectVoid &from, bool wide) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from, bool wide) const;
+};
+
+struct xImplAVX_Store
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    // VMOVDQU (store form)
+    void operator()(const xIndirectVoid &to, const xRegisterSSE &from, bool wide) const;
+};
+
+struct xImplAVX_RVM
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    // VPADDD, VPXOR, ...
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, bool wide) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, bool wide) const;
+};
+
+struct xImplAVX_RVMI
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    // VPBLENDD, VINSERTI128 (only exists in the wide form)
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, u8 imm, bool wide) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, u8 imm, bool wide) const;
+};
+}
@@ -127,6 +127,13 @@ extern const xImpl_Set xSETA, xSETAE,
 // BMI extra instruction requires BMI1/BMI2
 extern const xImplBMI_RVM xMULX, xPDEP, xPEXT, xANDN_S; // Warning xANDN is already used by SSE
 
+// AVX/AVX2 (VEX encoded, see implement/avx.h)
+extern const xImplAVX_Move xVMOVDQU, xVPMOVZXWD, xVPMOVSXWD;
+extern const xImplAVX_Store xVMOVDQU_STORE;
+extern const xImplAVX_RVM xVPADDD, xVPXOR;
+extern const xImplAVX_RVMI xVPBLENDD, xVINSERTI128;
+extern void xVZEROUPPER();
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Miscellaneous Instructions
 // These are all defined inline or in ix86.cpp.
@@ -141,13 +141,16 @@ __emitinline void xOpWriteC5(u8 prefix, u8 opcode, const T1 &param1, const T2 &p
 }
 
 // VEX 3 Bytes Prefix
+// param2 is the extra source register (vvvv), pass xmm0 when the instruction doesn't use
+// one (it is then encoded as 1111b).  l selects 256 bits vectors (VEX.L), -1 autodetects it
+// from the register.
 template <typename T1, typename T2, typename T3>
-__emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int w = -1)
+__emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int w = -1, int l = -1)
 {
     pxAssert(prefix == 0 || prefix == 0x66 || prefix == 0xF3 || prefix == 0xF2);
     pxAssert(mb_prefix == 0x0F || mb_prefix == 0x38 || mb_prefix == 0x3A);
 
-    const xRegisterInt &reg = param1.IsReg() ? param1 : param2;
+    const xRegisterBase &reg = param1.IsReg() ? param1 : param2;
 
 #ifdef __M_X86_64
     u8 nR = reg.IsExtended() ? 0x00 : 0x80;
@@ -158,7 +161,7 @@ __emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param
     u8 nB = 0x20;
     u8 nX = 0x40;
 #endif
-    u8 L = reg.IsWideSIMD() ? 4 : 0;
+    u8 L = (l == -1) ? (reg.IsWideSIMD() ? 4 : 0) : 4 * l;
     u8 W = (w == -1) ? (reg.GetOperandSize() == 8 ? 0x80 : 0) : // autodetect the size
                0x80 * w;                                        // take directly the W value
 
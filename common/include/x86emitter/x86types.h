@@ -1189,3 +1189,4 @@ static __fi xAddressVoid operator+(s32 addr, const xAddressReg &reg)
 #include "implement/jmpcall.h"
 
 #include "implement/bmi.h"
+#include "implement/avx.h"
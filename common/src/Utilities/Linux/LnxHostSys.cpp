@@ -20,6 +20,8 @@
 #include <wx/thread.h>
 
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <errno.h>
 #include <unistd.h>
@@ -222,6 +224,33 @@ void HostSys::Munmap(uptr base, size_t size)
     munmap((void *)base, size);
 }
 
+void *HostSys::MapSharedMemory(const char *name, size_t size, bool create)
+{
+    // A block left behind by a crashed process (whose pid may have been reused) is
+    // dropped, so a created block always starts out zero-filled.
+    if (create)
+        shm_unlink(name);
+
+    int fd = shm_open(name, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+    if (fd < 0)
+        return NULL;
+
+    if (create && ftruncate(fd, size) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return (ptr == MAP_FAILED) ? NULL : ptr;
+}
+
+void HostSys::UnlinkSharedMemory(const char *name)
+{
+    shm_unlink(name);
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     if (!_memprotect(baseaddr, size, mode)) {
@@ -0,0 +1,138 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "Telemetry.h"
+
+#ifdef _WIN32
+#include "RedtapeWindows.h"
+#else
+#include <unistd.h>
+#endif
+
+namespace Telemetry
+{
+// Plugins have their own copy of this, and attach to the block created by the emulator.
+static std::atomic<Header *> s_header(NULL);
+
+static void GetSegmentName(char *dest, size_t size)
+{
+#ifdef _WIN32
+    FormatSegmentName(dest, size, (u32)GetCurrentProcessId());
+#else
+    FormatSegmentName(dest, size, (u32)getpid());
+#endif
+}
+
+static bool Open(bool create)
+{
+    if (s_header.load(std::memory_order_acquire))
+        return true;
+
+    char name[64];
+    GetSegmentName(name, sizeof(name));
+
+    Header *header = (Header *)HostSys::MapSharedMemory(name, SegmentSize, create);
+    if (!header)
+        return false;
+
+    if (create) {
+        // Never trust a previous owner's contents, the counters and slot count start over.
+        memset((void *)header, 0, SegmentSize);
+        header->version = Version;
+        header->maxMetrics = MaxMetrics;
+        header->magic.store(Magic, std::memory_order_release);
+    }
+
+    // The mapping is kept either way, so metrics never point to unmapped memory.
+    if (header->magic.load(std::memory_order_acquire) != Magic || header->version != Version)
+        return false;
+
+    s_header.store(header, std::memory_order_release);
+    return true;
+}
+
+bool Create()
+{
+    return Open(true);
+}
+
+bool Attach()
+{
+    return Open(false);
+}
+
+void Unlink()
+{
+    if (!s_header.load(std::memory_order_acquire))
+        return;
+
+    char name[64];
+    GetSegmentName(name, sizeof(name));
+    HostSys::UnlinkSharedMemory(name);
+}
+
+bool IsOpen()
+{
+    return s_header.load(std::memory_order_acquire) != NULL;
+}
+
+Metric *Register(const char *name, MetricType type)
+{
+    Header *header = s_header.load(std::memory_order_acquire);
+    if (!header)
+        return NULL;
+
+    Metric *metrics = (Metric *)(header + 1);
+
+    // Metrics of the same name are shared, for instance after a plugin has been reloaded.
+    // A slot which is still being filled in isn't matched, which at worst duplicates it.
+    const u32 count = std::min(header->count.load(std::memory_order_acquire), MaxMetrics);
+    for (u32 i = 0; i < count; i++) {
+        if (metrics[i].type.load(std::memory_order_acquire) == (u32)type && !strncmp(metrics[i].name, name, MaxNameLength - 1))
+            return &metrics[i];
+    }
+
+    if (header->count.load(std::memory_order_acquire) >= MaxMetrics)
+        return NULL;
+
+    const u32 index = header->count.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= MaxMetrics)
+        return NULL;
+
+    Metric &metric = metrics[index];
+    strncpy(metric.name, name, MaxNameLength - 1);
+    metric.name[MaxNameLength - 1] = 0;
+    metric.type.store(type, std::memory_order_release);
+
+    return &metric;
+}
+
+void Histogram::Record(u64 sample)
+{
+    Metric *slot = GetSlot();
+    if (!slot)
+        return;
+
+    u32 bucket = 0;
+    while (bucket < HistogramBuckets - 1 && (sample >> bucket))
+        bucket++;
+
+    slot->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    slot->sum.fetch_add(sample, std::memory_order_relaxed);
+    slot->value.fetch_add(1, std::memory_order_relaxed);
+}
+}
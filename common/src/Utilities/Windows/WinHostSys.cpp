@@ -131,6 +131,22 @@ void HostSys::Munmap(uptr base, size_t size)
     VirtualFree((void *)base, 0, MEM_RELEASE);
 }
 
+void *HostSys::MapSharedMemory(const char *name, size_t size, bool create)
+{
+    // The handle is never closed: the view keeps the block alive until the process exits.
+    HANDLE mapping = create ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, name)
+                            : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+    if (!mapping)
+        return NULL;
+
+    return MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+}
+
+void HostSys::UnlinkSharedMemory(const char *name)
+{
+    // Windows removes the name along with the last handle.
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     pxAssertDev(((size & (__pagesize - 1)) == 0), pxsFmt(
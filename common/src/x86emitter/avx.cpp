@@ -0,0 +1,76 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "internal.h"
+#include "tools.h"
+
+namespace x86Emitter
+{
+
+const xImplAVX_Move xVMOVDQU = {0xF3, 0x0F, 0x6F};
+const xImplAVX_Store xVMOVDQU_STORE = {0xF3, 0x0F, 0x7F};
+const xImplAVX_Move xVPMOVZXWD = {0x66, 0x38, 0x33};
+const xImplAVX_Move xVPMOVSXWD = {0x66, 0x38, 0x23};
+
+const xImplAVX_RVM xVPADDD = {0x66, 0x0F, 0xFE};
+const xImplAVX_RVM xVPXOR = {0x66, 0x0F, 0xEF};
+
+const xImplAVX_RVMI xVPBLENDD = {0x66, 0x3A, 0x02};
+const xImplAVX_RVMI xVINSERTI128 = {0x66, 0x3A, 0x38};
+
+void xImplAVX_Move::operator()(const xRegisterSSE &to, const xIndirectVoid &from, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, xmm0, from, 0, wide);
+}
+void xImplAVX_Move::operator()(const xRegisterSSE &to, const xRegisterSSE &from, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, xmm0, from, 0, wide);
+}
+
+void xImplAVX_Store::operator()(const xIndirectVoid &to, const xRegisterSSE &from, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, from, xmm0, to, 0, wide);
+}
+
+void xImplAVX_RVM::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, from1, from2, 0, wide);
+}
+void xImplAVX_RVM::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, from1, from2, 0, wide);
+}
+
+void xImplAVX_RVMI::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, u8 imm, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, from1, from2, 0, wide);
+    xWrite8(imm);
+}
+void xImplAVX_RVMI::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, u8 imm, bool wide) const
+{
+    xOpWriteC4(Prefix, MbPrefix, Opcode, to, from1, from2, 0, wide);
+    xWrite8(imm);
+}
+
+// Clears the upper half of all ymm registers. Must be emitted before returning to
+// (or falling back on) legacy SSE code to avoid the AVX/SSE transition penalty.
+void xVZEROUPPER()
+{
+    xWrite8(0xC5);
+    xWrite8(0xF8);
+    xWrite8(0x77);
+}
+}
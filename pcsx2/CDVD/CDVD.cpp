@@ -514,6 +514,7 @@ s32 cdvdReadSubQ(s32 lsn, cdvdSubQ* subq)
 
 static void cdvdDetectDisk()
 {
+	cdvdTimingMap.Valid = false;
 	cdvd.Type = DoCDVDdetectDiskType();
 	cdvdReloadElfInfo();
 }
@@ -580,9 +581,199 @@ static s32 cdvdReadDvdDualInfo(s32* dualType, u32* layer1Start)
 	return CDVD->getDualInfo(dualType,layer1Start);
 }
 
+// --------------------------------------------------------------------------------------
+//  Disc timing model (CdvdTimingMode::Disc and Fast)
+// --------------------------------------------------------------------------------------
+// The drive spins at constant angular velocity for CD speeds above x2 and for DVDs, with the
+// nominal speed reached at the outer edge, so outer sectors transfer more than twice as fast
+// as inner ones.  Seeks take longer the further the pickup has to travel, plus the rotational
+// latency and a refocus when changing layers.  The radius and layer of every region of the
+// disc are precomputed once per disc into cdvdTimingMap.
+
+static const uint CdvdTimingMapSize = 4096;
+
+struct cdvdTimingMapStruct
+{
+	bool	Valid;
+	bool	IsDvd;
+	uint	Shift;		// lsn >> Shift selects the bucket
+	float	Radius[CdvdTimingMapSize];
+	u8		Layer[CdvdTimingMapSize];
+};
+
+static cdvdTimingMapStruct cdvdTimingMap;
+
+// Emulated time spent seeking and reading, for comparing the timing modes on the same run.
+// Only collected while the disc model is in use, so that Legacy timing never builds the map.
+struct cdvdTimingStatsStruct
+{
+	uint	Seeks;
+	u64		Sectors;
+	u64		LegacyCycles;
+	u64		DiscCycles;
+};
+
+static cdvdTimingStatsStruct cdvdTimingStats;
+
+static void cdvdBuildTimingMap( bool isDvd )
+{
+	cdvdTD td;
+	td.lsn = 0;
+	CDVD->getTD(0, &td);
+
+	s32 dualType = 0;
+	u32 layer1Start = 0;
+	if (isDvd)
+		cdvdReadDvdDualInfo(&dualType, &layer1Start);
+
+	const float inner = isDvd ? Cdvd_DVD_InnerRadius : Cdvd_CD_InnerRadius;
+	const float outer = isDvd ? Cdvd_DVD_OuterRadius : Cdvd_CD_OuterRadius;
+	const float capacity = isDvd ? Cdvd_DVD_Capacity : Cdvd_CD_Capacity;
+
+	uint shift = 0;
+	while ((std::max<u32>(td.lsn, 1) - 1) >> shift >= CdvdTimingMapSize)
+		shift++;
+
+	for (uint i = 0; i < CdvdTimingMapSize; i++)
+	{
+		u32 lsn = i << shift;
+		u32 pos = lsn;
+		u8 layer = 0;
+
+		if ((dualType == 1) && (lsn >= layer1Start))
+		{
+			// parallel track path, layer 1 also starts at the inside
+			layer = 1;
+			pos = lsn - layer1Start;
+		}
+		else if ((dualType == 2) && (lsn >= layer1Start))
+		{
+			// opposite track path, layer 1 runs back towards the inside
+			layer = 1;
+			pos = (lsn - layer1Start < layer1Start) ? layer1Start - 1 - (lsn - layer1Start) : 0;
+		}
+
+		float r = sqrtf(inner * inner + (outer * outer - inner * inner) * (float)pos / capacity);
+		cdvdTimingMap.Radius[i] = std::min(r, outer);
+		cdvdTimingMap.Layer[i] = layer;
+	}
+
+	cdvdTimingMap.IsDvd = isDvd;
+	cdvdTimingMap.Shift = shift;
+	cdvdTimingMap.Valid = true;
+}
+
+static uint cdvdTimingBucket( CDVD_MODE_TYPE mode, u32 lsn )
+{
+	bool isDvd = (mode != MODE_CDROM);
+	if (!cdvdTimingMap.Valid || cdvdTimingMap.IsDvd != isDvd)
+		cdvdBuildTimingMap(isDvd);
+
+	return std::min<u32>(lsn >> cdvdTimingMap.Shift, CdvdTimingMapSize - 1);
+}
+
+static bool cdvdIsCAV( CDVD_MODE_TYPE mode )
+{
+	return (mode != MODE_CDROM) || (cdvd.Speed > 2);
+}
+
+static uint cdvdDiscBlockReadTime( CDVD_MODE_TYPE mode, u32 lsn )
+{
+	bool isDvd = (mode != MODE_CDROM);
+	u64 rate = (u64)(isDvd ? Cdvd_DVD_ReadSpeed : Cdvd_CD_ReadSpeed) * std::max<int>(cdvd.Speed, 1);
+
+	if (cdvdIsCAV(mode))
+	{
+		float r = cdvdTimingMap.Radius[cdvdTimingBucket(mode, lsn)];
+		rate = (u64)(rate * r / (isDvd ? Cdvd_DVD_OuterRadius : Cdvd_CD_OuterRadius));
+	}
+
+	return (uint)((PSXCLK * cdvd.BlockSize) / std::max<u64>(rate, 1));
+}
+
+static uint cdvdDiscSeekTime( CDVD_MODE_TYPE mode, u32 from, u32 to )
+{
+	bool isDvd = (mode != MODE_CDROM);
+	const float inner = isDvd ? Cdvd_DVD_InnerRadius : Cdvd_CD_InnerRadius;
+	const float outer = isDvd ? Cdvd_DVD_OuterRadius : Cdvd_CD_OuterRadius;
+
+	uint fromBucket = cdvdTimingBucket(mode, from);
+	uint toBucket = cdvdTimingBucket(mode, to);
+	float fromRadius = cdvdTimingMap.Radius[fromBucket];
+	float toRadius = cdvdTimingMap.Radius[toBucket];
+
+	// The sled accelerates and brakes, so travel time grows with the square root of the
+	// distance.  A full stroke takes as long as the legacy full seek.
+	float stroke = fabsf(toRadius - fromRadius) / (outer - inner);
+	uint seektime = (uint)(Cdvd_FullSeek_Cycles * sqrtf(stroke));
+
+	// Half a revolution on average before the target sector comes around
+	float velocity = (isDvd ? Cdvd_DVD_Velocity : Cdvd_CD_Velocity) * std::max<int>(cdvd.Speed, 1);
+	float rps = velocity / (2.0f * 3.14159265f * (cdvdIsCAV(mode) ? outer : toRadius));
+	seektime += (uint)(PSXCLK / (2.0f * rps));
+
+	if (cdvdTimingMap.Layer[fromBucket] != cdvdTimingMap.Layer[toBucket])
+		seektime += Cdvd_LayerJump_Cycles;
+
+	return seektime;
+}
+
+static uint cdvdScaleTiming( uint cycles, CdvdTimingMode timing )
+{
+	if (timing != CdvdTimingMode::Fast)
+		return cycles;
+
+	return std::max<uint>(cycles / std::max<uint>(EmuConfig.CdvdFastScale, 1), 1);
+}
+
+static uint cdvdBlockReadTime( CDVD_MODE_TYPE mode, CdvdTimingMode timing )
+{
+	if (timing == CdvdTimingMode::Legacy)
+		return (PSXCLK * cdvd.BlockSize) / (((mode==MODE_CDROM) ? PSX_CD_READSPEED : PSX_DVD_READSPEED) * cdvd.Speed);
+
+	return cdvdScaleTiming(cdvdDiscBlockReadTime(mode, cdvd.SeekToSector), timing);
+}
+
 static uint cdvdBlockReadTime( CDVD_MODE_TYPE mode )
 {
-	return (PSXCLK * cdvd.BlockSize) / (((mode==MODE_CDROM) ? PSX_CD_READSPEED : PSX_DVD_READSPEED) * cdvd.Speed);
+	return cdvdBlockReadTime(mode, EmuConfig.CdvdTiming);
+}
+
+static bool cdvdTimingStatsEnabled()
+{
+	return EmuConfig.CdvdTiming != CdvdTimingMode::Legacy;
+}
+
+// Accounts a read of nSectors blocks in both models, see cdvdTimingVsync
+static void cdvdAccountRead( CDVD_MODE_TYPE mode )
+{
+	if (!cdvdTimingStatsEnabled()) return;
+
+	cdvdTimingStats.Sectors += cdvd.nSectors;
+	cdvdTimingStats.LegacyCycles += (u64)cdvd.nSectors * cdvdBlockReadTime(mode, CdvdTimingMode::Legacy);
+	cdvdTimingStats.DiscCycles += (u64)cdvd.nSectors * cdvdBlockReadTime(mode, CdvdTimingMode::Disc);
+}
+
+// Reports the emulated time the drive spent seeking and reading under each timing mode
+// over the last ten seconds with disc activity, then starts over.  Modes can be compared
+// from a single run, since the games' requests don't depend on how long the drive takes
+// to serve them (to a first approximation).
+static void cdvdTimingVsync()
+{
+	static uint seconds = 0;
+
+	if (cdvdTimingStats.Seeks == 0 && cdvdTimingStats.Sectors == 0) return;
+	if (++seconds < 10) return;
+	seconds = 0;
+
+	const uint scale = std::max<uint>(EmuConfig.CdvdFastScale, 1);
+	DevCon.WriteLn( "(CDVD) %u seeks, %llu sectors: legacy %.2fs, disc %.2fs, fast (1/%u) %.2fs",
+		cdvdTimingStats.Seeks, (unsigned long long)cdvdTimingStats.Sectors,
+		(double)cdvdTimingStats.LegacyCycles / PSXCLK,
+		(double)cdvdTimingStats.DiscCycles / PSXCLK,
+		scale, (double)cdvdTimingStats.DiscCycles / scale / PSXCLK );
+
+	memzero(cdvdTimingStats);
 }
 
 void cdvdReset()
@@ -597,7 +788,9 @@ void cdvdReset()
 	cdvd.Speed = 4;
 	cdvd.BlockSize = 2064;
 	cdvd.Action = cdvdAction_None;
-	cdvd.ReadTime = cdvdBlockReadTime( MODE_DVDROM );
+	cdvdTimingMap.Valid = false;
+	memzero(cdvdTimingStats);
+	cdvd.ReadTime = cdvdBlockReadTime( MODE_DVDROM, CdvdTimingMode::Legacy );
 
 	// CDVD internally uses GMT+9.  If you think the time's wrong, you're wrong.
 	// Set up your time zone and winter/summer in the BIOS.  No PS2 BIOS I know of features automatic DST.
@@ -924,7 +1117,7 @@ static uint cdvdStartSeek( uint newsector, CDVD_MODE_TYPE mode )
 	if( !cdvd.Spinning )
 	{
 		CDVD_LOG( "CdSpinUp > Simulating CdRom Spinup Time, and seek to sector %d", cdvd.SeekToSector );
-		seektime = PSXCLK / 3;		// 333ms delay
+		seektime = cdvdScaleTiming( PSXCLK / 3, EmuConfig.CdvdTiming );		// 333ms delay
 		cdvd.Spinning = true;
 	}
 	else if( (tbl_ContigiousSeekDelta[mode] == 0) || (delta >= tbl_ContigiousSeekDelta[mode]) )
@@ -942,6 +1135,16 @@ static uint cdvdStartSeek( uint newsector, CDVD_MODE_TYPE mode )
 			CDVD_LOG( "CdSeek Begin > to sector %d, from %d - delta=%d [FAST]", cdvd.SeekToSector, cdvd.Sector, delta );
 			seektime = Cdvd_FastSeek_Cycles;
 		}
+
+		if( cdvdTimingStatsEnabled() )
+		{
+			uint disctime = cdvdDiscSeekTime( mode, cdvd.Sector, cdvd.SeekToSector );
+			cdvdTimingStats.Seeks++;
+			cdvdTimingStats.LegacyCycles += seektime;
+			cdvdTimingStats.DiscCycles += disctime;
+
+			seektime = cdvdScaleTiming( disctime, EmuConfig.CdvdTiming );
+		}
 	}
 	else
 	{
@@ -950,6 +1153,12 @@ static uint cdvdStartSeek( uint newsector, CDVD_MODE_TYPE mode )
 		// seektime is the time it takes to read to the destination block:
 		seektime = delta * cdvd.ReadTime;
 
+		if( cdvdTimingStatsEnabled() )
+		{
+			cdvdTimingStats.LegacyCycles += (u64)delta * cdvdBlockReadTime( mode, CdvdTimingMode::Legacy );
+			cdvdTimingStats.DiscCycles += (u64)delta * cdvdBlockReadTime( mode, CdvdTimingMode::Disc );
+		}
+
 		if( delta == 0 )
 		{
 			//cdvd.Status = CDVD_STATUS_PAUSE;
@@ -985,6 +1194,8 @@ void cdvdVsync() {
 		cdvd.TrayTimeout = 0;
 	}
 
+	cdvdTimingVsync();
+
 	cdvd.RTC.second++;
 	if (cdvd.RTC.second < 60) return;
 	cdvd.RTC.second = 0;
@@ -1220,6 +1431,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 					cdvd.SeekToSector, cdvd.nSectors,cdvd.BlockSize,cdvd.Speed);
 
 			cdvd.ReadTime = cdvdBlockReadTime( MODE_CDROM );
+			cdvdAccountRead( MODE_CDROM );
 			CDVDREAD_INT( cdvdStartSeek( cdvd.SeekToSector,MODE_CDROM ) );
 
 			// Read-ahead by telling the plugin about the track now.
@@ -1268,6 +1480,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 					cdvd.Sector, cdvd.nSectors,cdvd.BlockSize,cdvd.Speed);
 
 			cdvd.ReadTime = cdvdBlockReadTime( MODE_CDROM );
+			cdvdAccountRead( MODE_CDROM );
 			CDVDREAD_INT( cdvdStartSeek( cdvd.SeekToSector, MODE_CDROM ) );
 
 			// Read-ahead by telling the plugin about the track now.
@@ -1304,6 +1517,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 					cdvd.SeekToSector, cdvd.nSectors,cdvd.BlockSize,cdvd.Speed);
 
 			cdvd.ReadTime = cdvdBlockReadTime( MODE_DVDROM );
+			cdvdAccountRead( MODE_DVDROM );
 			CDVDREAD_INT( cdvdStartSeek( cdvd.SeekToSector, MODE_DVDROM ) );
 
 			// Read-ahead by telling the plugin about the track now.
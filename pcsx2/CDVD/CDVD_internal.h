@@ -136,6 +136,25 @@ static const uint PSX_DVD_READSPEED = 1382400 + 256000; // normal is 1 Byte Time
 
 static const uint Cdvd_FullSeek_Cycles = (PSXCLK*100) / 1000;		// average number of cycles per fullseek (100ms)
 static const uint Cdvd_FastSeek_Cycles = (PSXCLK*30) / 1000;		// average number of cycles per fastseek (37ms)
+
+// Disc geometry for CdvdTimingMode::Disc.  Data is written at constant linear density between
+// the inner and outer radius (in mm), so a sector's radius follows from its position relative to
+// the capacity of a full layer.  The linear velocity at x1 is in mm/s.
+static const float Cdvd_CD_InnerRadius = 25.0f;
+static const float Cdvd_CD_OuterRadius = 58.0f;
+static const float Cdvd_CD_Capacity = 360000.0f;			// 80 minute CD
+static const float Cdvd_CD_Velocity = 1300.0f;
+static const uint Cdvd_CD_ReadSpeed = 153600;				// bytes per second at x1
+
+static const float Cdvd_DVD_InnerRadius = 24.0f;
+static const float Cdvd_DVD_OuterRadius = 58.0f;
+static const float Cdvd_DVD_Capacity = 2295104.0f;			// single layer, 4.7GB
+static const float Cdvd_DVD_Velocity = 3490.0f;
+static const uint Cdvd_DVD_ReadSpeed = 1382400;
+
+// Switching layers refocuses the pickup instead of moving it.  Not measured, an assumption.
+static const uint Cdvd_LayerJump_Cycles = (PSXCLK*10) / 1000;
+
 short DiscSwapTimerSeconds = 0;
 bool trayState = 0; // Used to check if the CD tray status has changed since the last time
 
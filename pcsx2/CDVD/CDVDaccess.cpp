@@ -521,6 +521,7 @@ s32 DoCDVDdetectDiskType()
 void DoCDVDresetDiskTypeCache()
 {
 	diskTypeCached = -1;
+	IsoFSCDVD::ResetIndex();
 }
 
 ////////////////////////////////////////////////////////
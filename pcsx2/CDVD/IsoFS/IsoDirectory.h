@@ -28,9 +28,14 @@ public:
 	std::vector<IsoFileDescriptor>	files;
 	IsoFS_Type						m_fstype;
 
+protected:
+	u32								m_lba;
+	std::shared_ptr<IsoFSIndex>		m_index;
+
 public:
 	IsoDirectory(SectorSource& r);
 	IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry);
+	IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry, const std::shared_ptr<IsoFSIndex>& index);
 	virtual ~IsoDirectory() = default;
 
 	wxString FStype_ToString() const;
@@ -50,4 +55,5 @@ protected:
 
 	void Init(const IsoFileDescriptor& directoryEntry);
 	int GetIndexOf(const wxString& fileName) const;
+	IsoFileDescriptor WalkPath(const wxFileName& parts, const wxString& filePath) const;
 };
@@ -42,6 +42,7 @@ wxString IsoDirectory::FStype_ToString() const
 // Used to load the Root directory from an image
 IsoDirectory::IsoDirectory(SectorSource& r)
 	: internalReader(r)
+	, m_index(r.getIndex())
 {
 	IsoFileDescriptor rootDirEntry;
 	bool isValid = false;
@@ -50,10 +51,22 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 
 	m_fstype = FStype_ISO9660;
 
+	// The source still has the same disc as when its root was last read, so the volume
+	// descriptors can be skipped entirely.
+	if( m_index && m_index->GetRoot( rootDirEntry, m_fstype ) )
+	{
+		Init( rootDirEntry );
+		return;
+	}
+
+	IsoFSDiscKey key;
+	key.sectors = internalReader.getNumSectors();
+
 	while( !done )
 	{
 		u8 sector[2048];
 		internalReader.readSector(sector,i);
+		key.AddSector(sector, sizeof(sector));
 		if( memcmp( &sector[1], "CD001", 5 ) == 0 )
 		{
 		    switch (sector[0])
@@ -99,12 +112,23 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 			.SetDiagMsg(L"IsoFS could not find the root directory on the ISO image.");
 
 	DevCon.WriteLn( L"(IsoFS) Filesystem is " + FStype_ToString() );
+
+	m_index = internalReader.bindIndex( key );
+	if( m_index ) m_index->SetRoot( rootDirEntry, m_fstype );
+
 	Init( rootDirEntry );
 }
 
 // Used to load a specific directory from a file descriptor
 IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry)
+	: IsoDirectory(r, directoryEntry, nullptr)
+{
+}
+
+// Used to load a subdirectory of a directory that is backed by a disc index
+IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry, const std::shared_ptr<IsoFSIndex>& index)
 	: internalReader(r)
+	, m_index(index)
 {
 	m_fstype = FStype_ISO9660;
 	Init(directoryEntry);
@@ -112,6 +136,11 @@ IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry)
 
 void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 {
+	m_lba = directoryEntry.lba;
+
+	if( m_index && m_index->FindDirectory( m_lba, files ) )
+		return;
+
 	// parse directory sector
 	IsoFile dataStream (internalReader, directoryEntry);
 
@@ -138,6 +167,8 @@ void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 	}
 
 	b[0] = 0;
+
+	if( m_index ) m_index->AddDirectory( m_lba, files );
 }
 
 const IsoFileDescriptor& IsoDirectory::GetEntry(int index) const
@@ -167,6 +198,30 @@ IsoFileDescriptor IsoDirectory::FindFile(const wxString& filePath) const
 	// wxWidgets DOS-style parser should work fine for ISO 9660 path names.  Only practical difference
 	// is case sensitivity, and that won't matter for path splitting.
 	wxFileName parts( filePath, wxPATH_DOS );
+
+	if( !m_index ) return WalkPath( parts, filePath );
+
+	// Paths are remembered relative to the directory they were resolved from.  Lookups that fail
+	// aren't remembered; they throw, and are rare enough not to matter.
+	wxString keyPath( wxsFormat( L"%x:", m_lba ) );
+	for(uint i=0; i<parts.GetDirCount(); ++i)
+		keyPath += parts.GetDirs()[i] + L'\\';
+	keyPath += parts.GetFullName();
+
+	const std::string key( keyPath.ToUTF8().data() );
+	IsoFileDescriptor info;
+
+	if( !m_index->FindPath( key, info ) )
+	{
+		info = WalkPath( parts, filePath );
+		m_index->AddPath( key, info );
+	}
+
+	return info;
+}
+
+IsoFileDescriptor IsoDirectory::WalkPath(const wxFileName& parts, const wxString& filePath) const
+{
 	IsoFileDescriptor info;
 	const IsoDirectory* dir = this;
 	std::unique_ptr<IsoDirectory> deleteme;
@@ -179,7 +234,7 @@ IsoFileDescriptor IsoDirectory::FindFile(const wxString& filePath) const
 		info = dir->GetEntry(parts.GetDirs()[i]);
 		if(info.IsFile()) throw Exception::FileNotFound( filePath );
 
-		deleteme.reset(new IsoDirectory(internalReader, info));
+		deleteme.reset(new IsoDirectory(internalReader, info, m_index));
 		dir = deleteme.get();
 	}
 
@@ -17,10 +17,12 @@
 
 class IsoFile;
 class IsoDirectory;
+class IsoFSIndex;
 struct ISoFileDescriptor;
 
 #include "SectorSource.h"
 #include "IsoFileDescriptor.h"
 #include "IsoDirectory.h"
+#include "IsoFSIndex.h"
 #include "IsoFile.h"
 
@@ -16,9 +16,20 @@
 
 #include "PrecompiledHeader.h"
 
+#include "IsoFS.h"
 #include "IsoFSCDVD.h"
 #include "../CDVDaccess.h"
 
+using namespace Threading;
+
+// Number of discs whose directory index is kept around after they're closed, so that
+// reopening (or swapping back to) a recent disc doesn't parse its directories again.
+static const uint MaxRecentIndexes = 4;
+
+static Mutex									s_index_lock;
+static std::shared_ptr<IsoFSIndex>				s_index;		// disc in the drive, NULL until its root is read
+static std::list<std::shared_ptr<IsoFSIndex>>	s_recentIndexes;	// most recently used first
+
 IsoFSCDVD::IsoFSCDVD()
 {
 }
@@ -35,3 +46,39 @@ int IsoFSCDVD::getNumSectors()
 
 	return td.lsn;
 }
+
+std::shared_ptr<IsoFSIndex> IsoFSCDVD::getIndex()
+{
+	ScopedLock lock( s_index_lock );
+	return s_index;
+}
+
+std::shared_ptr<IsoFSIndex> IsoFSCDVD::bindIndex(const IsoFSDiscKey& key)
+{
+	ScopedLock lock( s_index_lock );
+
+	for( auto it = s_recentIndexes.begin(); it != s_recentIndexes.end(); ++it )
+	{
+		if( !((*it)->GetKey() == key) ) continue;
+
+		s_index = *it;
+		s_recentIndexes.erase( it );
+		s_recentIndexes.push_front( s_index );
+		return s_index;
+	}
+
+	s_index = std::make_shared<IsoFSIndex>( key );
+	s_recentIndexes.push_front( s_index );
+	if( s_recentIndexes.size() > MaxRecentIndexes )
+		s_recentIndexes.pop_back();
+
+	return s_index;
+}
+
+// Called whenever the disc may have changed.  The next root directory read checks the volume
+// descriptors again and picks up the matching index, if the disc was seen recently.
+void IsoFSCDVD::ResetIndex()
+{
+	ScopedLock lock( s_index_lock );
+	s_index = nullptr;
+}
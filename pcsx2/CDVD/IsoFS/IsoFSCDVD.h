@@ -28,4 +28,9 @@ public:
 	virtual bool readSector(unsigned char* buffer, int lba);
 
 	virtual int  getNumSectors();
+
+	virtual std::shared_ptr<IsoFSIndex> getIndex();
+	virtual std::shared_ptr<IsoFSIndex> bindIndex(const IsoFSDiscKey& key);
+
+	static void ResetIndex();
 };
@@ -0,0 +1,96 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PrecompiledHeader.h"
+
+#include "IsoFS.h"
+
+using namespace Threading;
+
+//////////////////////////////////////////////////////////////////////////
+// IsoFSDiscKey
+//////////////////////////////////////////////////////////////////////////
+
+// FNV-1a, plenty for telling a handful of recently used discs apart.
+void IsoFSDiscKey::AddSector(const u8* sector, int length)
+{
+	for(int i=0; i<length; ++i)
+	{
+		hash ^= sector[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IsoFSIndex
+//////////////////////////////////////////////////////////////////////////
+
+IsoFSIndex::IsoFSIndex(const IsoFSDiscKey& key)
+	: m_key(key)
+{
+	m_hasRoot	= false;
+	m_fstype	= FStype_ISO9660;
+}
+
+bool IsoFSIndex::GetRoot(IsoFileDescriptor& root, IsoFS_Type& fstype) const
+{
+	ScopedLock lock(m_lock);
+	if(!m_hasRoot) return false;
+
+	root	= m_root;
+	fstype	= m_fstype;
+	return true;
+}
+
+void IsoFSIndex::SetRoot(const IsoFileDescriptor& root, IsoFS_Type fstype)
+{
+	ScopedLock lock(m_lock);
+	m_root		= root;
+	m_fstype	= fstype;
+	m_hasRoot	= true;
+}
+
+bool IsoFSIndex::FindDirectory(u32 lba, DirectoryList& files) const
+{
+	ScopedLock lock(m_lock);
+	auto it = m_dirs.find(lba);
+	if(it == m_dirs.end()) return false;
+
+	files = it->second;
+	return true;
+}
+
+void IsoFSIndex::AddDirectory(u32 lba, const DirectoryList& files)
+{
+	ScopedLock lock(m_lock);
+	m_dirs[lba] = files;
+}
+
+bool IsoFSIndex::FindPath(const std::string& key, IsoFileDescriptor& info) const
+{
+	ScopedLock lock(m_lock);
+	auto it = m_paths.find(key);
+	if(it == m_paths.end()) return false;
+
+	info = it->second;
+	return true;
+}
+
+void IsoFSIndex::AddPath(const std::string& key, const IsoFileDescriptor& info)
+{
+	ScopedLock lock(m_lock);
+	m_paths[key] = info;
+}
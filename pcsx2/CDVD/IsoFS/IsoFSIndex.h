@@ -0,0 +1,88 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utilities/Threading.h"
+#include <string>
+#include <unordered_map>
+
+// --------------------------------------------------------------------------------------
+//  IsoFSDiscKey
+// --------------------------------------------------------------------------------------
+// Identifies a disc image well enough to reuse its directory index: the sector count plus
+// a hash of the volume descriptors (which carry the volume id, creation date and root
+// directory location).
+struct IsoFSDiscKey
+{
+	s32		sectors;
+	u64		hash;
+
+	IsoFSDiscKey()
+	{
+		sectors	= 0;
+		hash	= 14695981039346656037ULL;
+	}
+
+	void AddSector(const u8* sector, int length);
+
+	bool operator==(const IsoFSDiscKey& right) const
+	{
+		return (sectors == right.sectors) && (hash == right.hash);
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  IsoFSIndex
+// --------------------------------------------------------------------------------------
+// Directory tree of a single disc, filled in lazily as IsoDirectory parses directories and
+// resolves paths.  Every directory is read from the disc at most once, and resolved paths
+// are remembered so that repeated lookups (SYSTEM.CNF, the boot ELF, disc type detection)
+// don't have to walk the tree again.  The index is shared between threads, hence the lock.
+//
+class IsoFSIndex
+{
+protected:
+	typedef std::vector<IsoFileDescriptor>	DirectoryList;
+
+	IsoFSDiscKey		m_key;
+
+	bool				m_hasRoot;
+	IsoFileDescriptor	m_root;
+	IsoFS_Type			m_fstype;
+
+	// directory contents, keyed by the LBA of the directory's first sector
+	std::unordered_map<u32, DirectoryList>			m_dirs;
+
+	// resolved paths, keyed by the LBA of the starting directory and the normalized path
+	std::unordered_map<std::string, IsoFileDescriptor>	m_paths;
+
+	Threading::Mutex		m_lock;
+
+public:
+	IsoFSIndex(const IsoFSDiscKey& key);
+	virtual ~IsoFSIndex() = default;
+
+	const IsoFSDiscKey& GetKey() const { return m_key; }
+
+	bool GetRoot(IsoFileDescriptor& root, IsoFS_Type& fstype) const;
+	void SetRoot(const IsoFileDescriptor& root, IsoFS_Type fstype);
+
+	bool FindDirectory(u32 lba, DirectoryList& files) const;
+	void AddDirectory(u32 lba, const DirectoryList& files);
+
+	bool FindPath(const std::string& key, IsoFileDescriptor& info) const;
+	void AddPath(const std::string& key, const IsoFileDescriptor& info);
+};
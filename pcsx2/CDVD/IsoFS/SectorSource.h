@@ -15,10 +15,21 @@
 
 #pragma once
 
+#include <memory>
+
+class IsoFSIndex;
+struct IsoFSDiscKey;
+
 class SectorSource
 {
 public:
 	virtual int  getNumSectors()=0;
 	virtual bool readSector(unsigned char* buffer, int lba)=0;
+
+	// Directory index of the disc behind this source (see IsoFSIndex).  Sources that can't tell
+	// when their disc changes don't keep one, and every IsoDirectory reads the disc directly.
+	virtual std::shared_ptr<IsoFSIndex> getIndex() { return nullptr; }
+	virtual std::shared_ptr<IsoFSIndex> bindIndex(const IsoFSDiscKey& key) { return nullptr; }
+
 	virtual ~SectorSource() = default;
 };
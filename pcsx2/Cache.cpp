@@ -23,6 +23,7 @@ using namespace R5900;
 using namespace vtlb_private;
 
 _cacheS pCache[64];
+u32 pCacheFastTag[64][2];
 
 // The lower parts of a cache tags structure is as follows:
 // 31 - 12: The physical address cache tag.
@@ -35,11 +36,30 @@ _cacheS pCache[64];
 
 // 0xFFF - 12 bits, so x & ~0xFFF = the physical address cache tag.
 
-const u32 DIRTY_FLAG = 0x40;
+const u32 DIRTY_FLAG = CACHE_TAG_DIRTY;
 const u32 VALID_FLAG = 0x20;
 const u32 LRF_FLAG = 0x10;
 const u32 LOCK_FLAG = 0x8;
 
+void resetCache()
+{
+	memzero(pCache);
+	memzero(pCacheFastTag);
+}
+
+// Called whenever the vtlb virtual map changes, since the fast table is keyed on
+// virtual lines and a remap could point one at a different physical tag.
+void cacheInvalidateFastTags()
+{
+	memzero(pCacheFastTag);
+}
+
+static __fi void cacheInvalidateFastIndex(int index)
+{
+	pCacheFastTag[index][0] = 0;
+	pCacheFastTag[index][1] = 0;
+}
+
 int getFreeCache(u32 mem, int mode, int * way)
 {
 	int number = 0;
@@ -55,12 +75,14 @@ int getFreeCache(u32 mem, int mode, int * way)
 	{
 		*way = 0;
 		if (pCache[i].tag[0] & LOCK_FLAG) CACHE_LOG("Index %x Way %x Locked!!", i, 0);
+		pCacheFastTag[i][0] = (mem & ~0x3F) | CACHE_FAST_VALID;
 		return i;
 	}
 	else if((pCache[i].tag[1] & ~0xFFF) == (paddr & ~0xFFF) && (pCache[i].tag[1] & VALID_FLAG))
 	{
 		*way = 1;
 		if (pCache[i].tag[1] & LOCK_FLAG) CACHE_LOG("Index %x Way %x Locked!!", i, 1);
+		pCacheFastTag[i][1] = (mem & ~0x3F) | CACHE_FAST_VALID;
 		return i;
 	}
 
@@ -102,11 +124,18 @@ int getFreeCache(u32 mem, int mode, int * way)
 	else
 		pCache[i].tag[number] |= LRF_FLAG;
 
+	pCacheFastTag[i][number] = (mem & ~0x3F) | CACHE_FAST_VALID;
 	return i;
 }
 
 void writeCache8(u32 mem, u8 value)
 {
+	if (u8bit_128* qw = cacheFastHit(mem, true))
+	{
+		qw->b8._u8[mem & 0xf] = value;
+		return;
+	}
+
 	int number = 0;
 	const int i = getFreeCache(mem, 1, &number);
 
@@ -125,6 +154,12 @@ void writeCache8(u32 mem, u8 value)
 
 void writeCache16(u32 mem, u16 value)
 {
+	if (u8bit_128* qw = cacheFastHit(mem, true))
+	{
+		qw->b8._u16[(mem & 0xf) >> 1] = value;
+		return;
+	}
+
 	int number = 0;
 	const int i = getFreeCache(mem, 1, &number);
 
@@ -143,6 +178,12 @@ void writeCache16(u32 mem, u16 value)
 
 void writeCache32(u32 mem, u32 value)
 {
+	if (u8bit_128* qw = cacheFastHit(mem, true))
+	{
+		qw->b8._u32[(mem & 0xf) >> 2] = value;
+		return;
+	}
+
 	int number = 0;
 	const int i = getFreeCache(mem, 1, &number);
 
@@ -161,6 +202,12 @@ void writeCache32(u32 mem, u32 value)
 
 void writeCache64(u32 mem, const u64 value)
 {
+	if (u8bit_128* qw = cacheFastHit(mem, true))
+	{
+		qw->b8._u64[(mem & 0xf) >> 3] = value;
+		return;
+	}
+
 	int number = 0;
 	const int i = getFreeCache(mem, 1, &number);
 
@@ -179,6 +226,13 @@ void writeCache64(u32 mem, const u64 value)
 
 void writeCache128(u32 mem, const mem128_t* value)
 {
+	if (u8bit_128* qw = cacheFastHit(mem, true))
+	{
+		qw->b8._u64[0] = value->lo;
+		qw->b8._u64[1] = value->hi;
+		return;
+	}
+
 	int number = 0;
 	const int i = getFreeCache(mem, 1, &number);
 
@@ -199,6 +253,9 @@ void writeCache128(u32 mem, const mem128_t* value)
 
 u8 readCache8(u32 mem)
 {
+	if (const u8bit_128* qw = cacheFastHit(mem, false))
+		return qw->b8._u8[mem & 0xf];
+
 	int number = 0;
 	const int i = getFreeCache(mem, 0, &number);
 
@@ -215,6 +272,9 @@ u8 readCache8(u32 mem)
 
 u16 readCache16(u32 mem)
 {
+	if (const u8bit_128* qw = cacheFastHit(mem, false))
+		return qw->b8._u16[(mem & 0xf) >> 1];
+
 	int number = 0;
 	const int i = getFreeCache(mem, 0, &number);
 
@@ -231,6 +291,9 @@ u16 readCache16(u32 mem)
 
 u32 readCache32(u32 mem)
 {
+	if (const u8bit_128* qw = cacheFastHit(mem, false))
+		return qw->b8._u32[(mem & 0xf) >> 2];
+
 	int number = 0;
 	const int i = getFreeCache(mem, 0, &number);
 
@@ -247,6 +310,9 @@ u32 readCache32(u32 mem)
 
 u64 readCache64(u32 mem)
 {
+	if (const u8bit_128* qw = cacheFastHit(mem, false))
+		return qw->b8._u64[(mem & 0xf) >> 3];
+
 	int number = 0;
 	int i = getFreeCache(mem, 0, &number);
 
@@ -264,6 +330,7 @@ u64 readCache64(u32 mem)
 __forceinline void clear_cache(int index, int way)
 {
 	pCache[index].tag[way] &= LRF_FLAG;
+	cacheInvalidateFastIndex(index);
 
 	pCache[index].data[way][0].b8._u64[0] = 0;
 	pCache[index].data[way][0].b8._u64[1] = 0;
@@ -479,6 +546,7 @@ void CACHE()
 			const int index = (addr >> 6) & 0x3F;
 			const int way = addr & 0x1;
 			pCache[index].tag[way] = cpuRegs.CP0.n.TagLo; 
+			cacheInvalidateFastIndex(index);
 
 			CACHE_LOG("CACHE DXSTG addr %x, index %d, way %d, DATA %x OP %x", addr, index, way, cpuRegs.CP0.r[28] & 0x6F, cpuRegs.code);
 			break;
@@ -534,3 +602,89 @@ void CACHE()
 }		// end namespace OpcodeImpl
 
 }}
+
+// =====================================================================================================
+//  Cache benchmark (Profiler.Bench_EECache)
+// =====================================================================================================
+// Times word loads from EE ram with the cache off (the plain vtlb read), with the lines
+// resident and found through pCacheFastTag, with the lines resident but the fast table
+// cleared (the full getFreeCache tag check), and with every load missing.  Accesses are
+// one per line so that each load goes through the lookup being measured.  Runs right
+// after the memory reset, so it is free to leave the cache empty and the lines clean.
+
+static const u32 CacheBenchBase   = 0x00100000;
+static const uint CacheBenchPasses = 20000;
+
+typedef u32 CacheBenchFn(u32 size);
+
+static u32 cacheBenchDirect(u32 size)
+{
+	u32 sum = 0;
+	for (u32 mem = CacheBenchBase; mem < CacheBenchBase + size; mem += 64)
+		sum += *reinterpret_cast<u32*>((sptr)mem + vtlbdata.vmap[mem >> VTLB_PAGE_BITS]);
+	return sum;
+}
+
+static u32 cacheBenchRead(u32 size)
+{
+	u32 sum = 0;
+	for (u32 mem = CacheBenchBase; mem < CacheBenchBase + size; mem += 64)
+		sum += readCache32(mem);
+	return sum;
+}
+
+static u32 cacheBenchReadSlow(u32 size)
+{
+	cacheInvalidateFastTags();
+	return cacheBenchRead(size);
+}
+
+static u32 cacheBenchWrite(u32 size)
+{
+	for (u32 mem = CacheBenchBase; mem < CacheBenchBase + size; mem += 64)
+		writeCache32(mem, mem);
+	return 0;
+}
+
+// Returns the loads per second (best of 3 runs)
+static double cacheBenchRun(CacheBenchFn* fn, u32 size, u32& sink)
+{
+	u64 best = ~0ULL;
+	for (int run = 0; run < 3; run++)
+	{
+		const u64 start = GetCPUTicks();
+		for (uint i = 0; i < CacheBenchPasses; i++)
+			sink += fn(size);
+		best = std::min(best, GetCPUTicks() - start);
+	}
+	return (double)CacheBenchPasses * (size / 64) * GetTickFrequency() / (double)std::max<u64>(best, 1);
+}
+
+void cacheBenchmark()
+{
+	// 8kb fills both ways of every set, 16kb makes every load evict a line
+	static const u32 resident = 64 * 2 * 64;
+	static const u32 thrashed = resident * 2;
+
+	u32 sink = 0;
+	resetCache();
+
+	const double direct = cacheBenchRun(cacheBenchDirect, resident, sink);
+	cacheBenchRead(resident);
+	const double fast = cacheBenchRun(cacheBenchRead, resident, sink);
+	const double slow = cacheBenchRun(cacheBenchReadSlow, resident, sink);
+	const double miss = cacheBenchRun(cacheBenchRead, thrashed, sink);
+	cacheBenchRead(resident);
+	const double write = cacheBenchRun(cacheBenchWrite, resident, sink);
+
+	// Drops the dirty lines without writing them back to ram
+	resetCache();
+
+	Console.WriteLn(Color_StrongBlack, "EE Cache: Load benchmark (%u passes, one load per line)", CacheBenchPasses);
+	Console.WriteLn("  %-24s %7.1f M/s", "cache off", direct / 1e6);
+	Console.WriteLn("  %-24s %7.1f M/s", "hit, fast tag", fast / 1e6);
+	Console.WriteLn("  %-24s %7.1f M/s", "hit, full tag check", slow / 1e6);
+	Console.WriteLn("  %-24s %7.1f M/s", "miss (line fill)", miss / 1e6);
+	Console.WriteLn("  %-24s %7.1f M/s", "store hit, fast tag", write / 1e6);
+	DevCon.WriteLn("  (checksum %08x)", sink);
+}
@@ -39,6 +39,38 @@ struct _cacheS {
 
 extern _cacheS pCache[64];
 
+// Host-side hit table, packed parallel to pCache.  Each entry holds the 64 byte
+// aligned EE *virtual* line that last hit or filled that set/way, with bit 0 set
+// while the entry is live.  A match means the line is resident and its tag still
+// describes the current vtlb mapping, so the access can go straight to the line
+// data without redoing the vmap translation and the tag compares.  Any change to
+// a tag or to the virtual map has to drop the affected entries (see
+// cacheInvalidateFastTags).
+extern u32 pCacheFastTag[64][2];
+
+static const u32 CACHE_FAST_VALID = 1;
+static const u32 CACHE_TAG_DIRTY = 0x40;
+
+// Returns the quadword of the cached line containing mem, or NULL when the line
+// needs the full lookup in getFreeCache (miss, writeback, or a stale entry).
+static __fi u8bit_128* cacheFastHit(u32 mem, bool write)
+{
+	const int i = (mem >> 6) & 0x3F;
+	const u32 line = (mem & ~0x3F) | CACHE_FAST_VALID;
+	int way;
+
+	if (pCacheFastTag[i][0] == line) way = 0;
+	else if (pCacheFastTag[i][1] == line) way = 1;
+	else return NULL;
+
+	if (write) pCache[i].tag[way] |= CACHE_TAG_DIRTY;
+	return &pCache[i].data[way][(mem >> 4) & 0x3];
+}
+
+extern void resetCache();
+extern void cacheInvalidateFastTags();
+extern void cacheBenchmark();
+
 void writeCache8(u32 mem, u8 value);
 void writeCache16(u32 mem, u16 value);
 void writeCache32(u32 mem, u32 value);
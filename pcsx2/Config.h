@@ -71,6 +71,14 @@ enum class VsyncMode
 	Adaptive,
 };
 
+// CDVD seek and read timings, see cdvdBlockReadTime / cdvdStartSeek
+enum class CdvdTimingMode
+{
+	Legacy,		// constant read speed, two fixed seek times
+	Disc,		// read speed and seek times follow the sector's position on the disc
+	Fast,		// Disc, with every timing divided by CdvdFastScale
+};
+
 // Template function for casting enumerations to their underlying type
 template <typename Enumeration>
 typename std::underlying_type<Enumeration>::type enum_cast(Enumeration E)
@@ -197,13 +205,22 @@ struct Pcsx2Config
 			bool
 				Enabled:1,			// universal toggle for the profiler.
 				RecBlocks_EE:1,		// Enables per-block profiling for the EE recompiler [unimplemented]
-				RecBlocks_IOP:1,	// Enables per-block profiling for the IOP recompiler [unimplemented]
+				RecBlocks_IOP:1,	// Enables per-block profiling for the IOP recompiler
 				RecBlocks_VU0:1,	// Enables per-block profiling for the VU0 recompiler [unimplemented]
-				RecBlocks_VU1:1;	// Enables per-block profiling for the VU1 recompiler [unimplemented]
+				RecBlocks_VU1:1,	// Enables per-block profiling for the VU1 recompiler [unimplemented]
+				TraceEvents:1,		// Records timeline markers of the core threads and plugins (see Timeline.h)
+				Bench_VifUnpack:1,	// Benchmarks the SSE and AVX2 VIF unpack routines on reset
+				Bench_EECache:1,	// Benchmarks the EE data cache lookups on reset
+				Bench_FolderMcd:1;	// Benchmarks the flush of folder memory cards when they are opened
 		BITFIELD_END
 
-		// Default is Disabled, with all recs enabled underneath.
-		ProfilerOptions() : bitset( 0xfffffffe ) {}
+		// Default is Disabled, with all recs enabled underneath (benchmarks are off).
+		ProfilerOptions() : bitset( 0xfffffffe )
+		{
+			Bench_VifUnpack = false;
+			Bench_EECache = false;
+			Bench_FolderMcd = false;
+		}
 		void LoadSave( IniInterface& conf );
 
 		bool operator ==( const ProfilerOptions& right ) const
@@ -217,6 +234,32 @@ struct Pcsx2Config
 		}
 	};
 
+	// ------------------------------------------------------------------------
+	struct IopHleOptions
+	{
+		BITFIELD32()
+			bool
+				FastPaths		:1,		// runs hot IRX library functions natively (see irxFastPaths)
+				CheckFastPaths	:1;		// also runs the IRX code and compares the results (slow)
+		BITFIELD_END
+
+		// "library.function" fast paths left to the IRX code, separated by commas or spaces
+		wxString	DisabledFastPaths;
+
+		IopHleOptions() : bitset( 0 ) {}
+		void LoadSave( IniInterface& conf );
+
+		bool operator ==( const IopHleOptions& right ) const
+		{
+			return OpEqu( bitset ) && OpEqu( DisabledFastPaths );
+		}
+
+		bool operator !=( const IopHleOptions& right ) const
+		{
+			return !this->operator ==( right );
+		}
+	};
+
 	// ------------------------------------------------------------------------
 	struct RecompilerOptions
 	{
@@ -248,6 +291,8 @@ struct Pcsx2Config
 				PreBlockCheckIOP:1;
 			bool
 				EnableEECache   :1;
+			bool
+				PersistVifUnpack:1;	// Saves the hot VIF unpack keys and precompiles them on the next run
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -297,6 +342,9 @@ struct Pcsx2Config
 		// style.  Useful for debugging potential bugs in the MTGS pipeline.
 		bool	SynchronousMTGS;
 
+		// merges adjacent GS packets of the same path into one MTGS ring command
+		bool	CoalescePackets;
+
 		int		VsyncQueueSize;
 
 		bool		FrameLimitEnable;
@@ -319,6 +367,7 @@ struct Pcsx2Config
 		{
 			return
 				OpEqu( SynchronousMTGS )		&&
+				OpEqu( CoalescePackets )		&&
 				OpEqu( VsyncQueueSize )			&&
 				
 				OpEqu( FrameSkipEnable )		&&
@@ -462,6 +511,8 @@ struct Pcsx2Config
 		// when enabled uses BOOT2 injection, skipping sony bios splashes
 			UseBOOT2Injection	:1,
 			BackupSavestate		:1,
+		// keeps a copy of EE/IOP memory between savestates, refreshing only the pages written in between
+			IncrementalSavestates :1,
 		// enables simulated ejection of memory cards when loading savestates
 			McdEnableEjection	:1,
 			McdFolderAutoManage	:1,
@@ -470,7 +521,9 @@ struct Pcsx2Config
 			MultitapPort1_Enabled:1,
 
 			ConsoleToStdio		:1,
-			HostFs				:1;
+			HostFs				:1,
+		// publishes live metrics through shared memory (see Utilities/Telemetry.h)
+			EnableTelemetry		:1;
 	BITFIELD_END
 
 	CpuOptions			Cpu;
@@ -478,10 +531,14 @@ struct Pcsx2Config
 	SpeedhackOptions	Speedhacks;
 	GamefixOptions		Gamefixes;
 	ProfilerOptions		Profiler;
+	IopHleOptions		IopHle;
 	DebugOptions		Debugger;
 
 	TraceLogFilters		Trace;
 
+	CdvdTimingMode		CdvdTiming;
+	uint				CdvdFastScale;
+
 	wxFileName			BiosFilename;
 
 	Pcsx2Config();
@@ -503,7 +560,10 @@ struct Pcsx2Config
 			OpEqu( Speedhacks )	&&
 			OpEqu( Gamefixes )	&&
 			OpEqu( Profiler )	&&
+			OpEqu( IopHle )		&&
 			OpEqu( Trace )		&&
+			OpEqu( CdvdTiming )	&&
+			OpEqu( CdvdFastScale ) &&
 			OpEqu( BiosFilename );
 	}
 
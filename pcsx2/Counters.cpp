@@ -31,6 +31,7 @@
 #include "ps2/HwInternal.h"
 
 #include "Sio.h"
+#include "System/Timeline.h"
 
 #ifndef DISABLE_RECORDING
 #	include "Recording/RecordingControls.h"
@@ -440,7 +441,11 @@ static __fi void frameLimit()
 
 static __fi void VSyncStart(u32 sCycle)
 {
-	GetCoreThread().VsyncInThread();
+	{
+		// Not around CheckExecutionState, which can longjmp out of the rec.
+		TraceEvents::Scope trace(Timeline::EE, "Vsync");
+		GetCoreThread().VsyncInThread();
+	}
 	Cpu->CheckExecutionState();
 
 	if(EmuConfig.Trace.Enabled && EmuConfig.Trace.EE.m_EnableAll)
@@ -504,7 +509,10 @@ static __fi void VSyncEnd(u32 sCycle)
 	if (!(g_FrameCount % 60))
 		sioNextFrame();
 
-	frameLimit(); // limit FPS
+	{
+		TraceEvents::Scope trace(Timeline::EE, "Frame limiter");
+		frameLimit(); // limit FPS
+	}
 
 	//Do this here, breaks Dynasty Warriors otherwise.
 	CSRreg.SwapField();
@@ -22,11 +22,35 @@
 #include "../System.h"
 
 std::vector<BreakPoint> CBreakPoints::breakPoints_;
+std::unordered_set<u32> CBreakPoints::breakPointAddrs_;
 u32 CBreakPoints::breakSkipFirstAt_ = 0;
 u64 CBreakPoints::breakSkipFirstTicks_ = 0;
 std::vector<MemCheck> CBreakPoints::memChecks_;
 std::vector<MemCheck *> CBreakPoints::cleanupMemChecks_;
 bool CBreakPoints::breakpointTriggered_ = false;
+u32 CBreakPoints::memCheckPages_[0x100000 / 32];
+
+// The breakpoint and memcheck lists, breakPointAddrs_ and memCheckPages_ are read on the
+// core thread by the recompiler and by recompiled code (see dynarecMemcheckRange), so the
+// CPU is paused for as long as they are being changed.
+class ScopedBreakPointsPause
+{
+public:
+	ScopedBreakPointsPause() : m_resume(!r5900Debug.isCpuPaused())
+	{
+		if (m_resume)
+			r5900Debug.pauseCpu();
+	}
+
+	~ScopedBreakPointsPause()
+	{
+		if (m_resume)
+			r5900Debug.resumeCpu();
+	}
+
+private:
+	bool m_resume;
+};
 
 // called from the dynarec
 u32 __fastcall standardizeBreakpointAddress(u32 addr)
@@ -123,6 +147,8 @@ void MemCheck::JitCleanup()
 size_t CBreakPoints::FindBreakpoint(u32 addr, bool matchTemp, bool temp)
 {
 	addr = standardizeBreakpointAddress(addr);
+	if (breakPointAddrs_.find(addr) == breakPointAddrs_.end())
+		return INVALID_BREAKPOINT;
 
 	for (size_t i = 0; i < breakPoints_.size(); ++i)
 	{
@@ -150,6 +176,72 @@ size_t CBreakPoints::FindMemCheck(u32 start, u32 end)
 	return INVALID_MEMCHECK;
 }
 
+void CBreakPoints::UpdateBreakPointAddrs()
+{
+	breakPointAddrs_.clear();
+	for (size_t i = 0; i < breakPoints_.size(); ++i)
+		breakPointAddrs_.insert(standardizeBreakpointAddress(breakPoints_[i].addr));
+}
+
+void CBreakPoints::UpdateMemCheckPages()
+{
+	memset(memCheckPages_, 0, sizeof(memCheckPages_));
+	if (memChecks_.empty())
+		return;
+
+	// Mark the standardized pages first.  An access of up to 16 bytes starting just below a
+	// memcheck still overlaps it, hence the slack before start.
+	std::vector<u32> pages(0x100000 / 32, 0);
+	for (size_t i = 0; i < memChecks_.size(); ++i)
+	{
+		const MemCheck& check = memChecks_[i];
+		if (check.result == 0 || (check.cond & MEMCHECK_READWRITE) == 0)
+			continue;
+
+		u32 start = standardizeBreakpointAddress(check.start);
+		u32 end = standardizeBreakpointAddress(check.end);
+		if (end <= start)
+			continue;
+
+		u32 first = (start > 15 ? start - 15 : 0) >> 12;
+		u32 last = (end - 1) >> 12;
+		for (u32 page = first; page <= last; ++page)
+			pages[page >> 5] |= 1u << (page & 31);
+	}
+
+	// Standardizing never moves an address within its page, so every raw page maps to exactly
+	// one standardized page.
+	for (u32 page = 0; page < 0x100000; ++page)
+	{
+		u32 std_page = standardizeBreakpointAddress(page << 12) >> 12;
+		if (pages[std_page >> 5] & (1u << (std_page & 31)))
+			memCheckPages_[page >> 5] |= 1u << (page & 31);
+	}
+}
+
+MemCheckResult CBreakPoints::CheckMemAccess(u32 start, u32 size, bool store)
+{
+	u32 end = start + size;
+	int result = MEMCHECK_IGNORE;
+
+	for (size_t i = 0; i < memChecks_.size(); ++i)
+	{
+		const MemCheck& check = memChecks_[i];
+
+		if (check.result == 0)
+			continue;
+		if ((check.cond & MEMCHECK_WRITE) == 0 && store)
+			continue;
+		if ((check.cond & MEMCHECK_READ) == 0 && !store)
+			continue;
+
+		if (start < standardizeBreakpointAddress(check.end) && standardizeBreakpointAddress(check.start) < end)
+			result |= check.result;
+	}
+
+	return (MemCheckResult)result;
+}
+
 bool CBreakPoints::IsAddressBreakPoint(u32 addr)
 {
 	size_t bp = FindBreakpoint(addr);
@@ -176,6 +268,7 @@ bool CBreakPoints::IsTempBreakPoint(u32 addr)
 
 void CBreakPoints::AddBreakPoint(u32 addr, bool temp)
 {
+	ScopedBreakPointsPause pause;
 	size_t bp = FindBreakpoint(addr, true, temp);
 	if (bp == INVALID_BREAKPOINT)
 	{
@@ -185,6 +278,7 @@ void CBreakPoints::AddBreakPoint(u32 addr, bool temp)
 		pt.addr = addr;
 
 		breakPoints_.push_back(pt);
+		UpdateBreakPointAddrs();
 		Update(addr);
 	}
 	else if (!breakPoints_[bp].enabled)
@@ -197,6 +291,7 @@ void CBreakPoints::AddBreakPoint(u32 addr, bool temp)
 
 void CBreakPoints::RemoveBreakPoint(u32 addr)
 {
+	ScopedBreakPointsPause pause;
 	size_t bp = FindBreakpoint(addr);
 	if (bp != INVALID_BREAKPOINT)
 	{
@@ -207,12 +302,14 @@ void CBreakPoints::RemoveBreakPoint(u32 addr)
 		if (bp != INVALID_BREAKPOINT)
 			breakPoints_.erase(breakPoints_.begin() + bp);
 
+		UpdateBreakPointAddrs();
 		Update(addr);
 	}
 }
 
 void CBreakPoints::ChangeBreakPoint(u32 addr, bool status)
 {
+	ScopedBreakPointsPause pause;
 	size_t bp = FindBreakpoint(addr);
 	if (bp != INVALID_BREAKPOINT)
 	{
@@ -223,9 +320,11 @@ void CBreakPoints::ChangeBreakPoint(u32 addr, bool status)
 
 void CBreakPoints::ClearAllBreakPoints()
 {
+	ScopedBreakPointsPause pause;
 	if (!breakPoints_.empty())
 	{
 		breakPoints_.clear();
+		UpdateBreakPointAddrs();
 		Update();
 	}
 }
@@ -235,6 +334,8 @@ void CBreakPoints::ClearTemporaryBreakPoints()
 	if (breakPoints_.empty())
 		return;
 
+	ScopedBreakPointsPause pause;
+
 	for (int i = (int)breakPoints_.size()-1; i >= 0; --i)
 	{
 		if (breakPoints_[i].temporary)
@@ -243,10 +344,13 @@ void CBreakPoints::ClearTemporaryBreakPoints()
 			breakPoints_.erase(breakPoints_.begin() + i);
 		}
 	}
+
+	UpdateBreakPointAddrs();
 }
 
 void CBreakPoints::ChangeBreakPointAddCond(u32 addr, const BreakPointCond &cond)
 {
+	ScopedBreakPointsPause pause;
 	size_t bp = FindBreakpoint(addr, true, false);
 	if (bp != INVALID_BREAKPOINT)
 	{
@@ -258,6 +362,7 @@ void CBreakPoints::ChangeBreakPointAddCond(u32 addr, const BreakPointCond &cond)
 
 void CBreakPoints::ChangeBreakPointRemoveCond(u32 addr)
 {
+	ScopedBreakPointsPause pause;
 	size_t bp = FindBreakpoint(addr, true, false);
 	if (bp != INVALID_BREAKPOINT)
 	{
@@ -281,6 +386,7 @@ BreakPointCond *CBreakPoints::GetBreakPointCondition(u32 addr)
 
 void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	ScopedBreakPointsPause pause;
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -294,18 +400,20 @@ void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCh
 		check.result = result;
 
 		memChecks_.push_back(check);
-		Update();
 	}
 	else
 	{
 		memChecks_[mc].cond = (MemCheckCondition)(memChecks_[mc].cond | cond);
 		memChecks_[mc].result = (MemCheckResult)(memChecks_[mc].result | result);
-		Update();
 	}
+
+	UpdateMemCheckPages();
+	Update();
 }
 
 void CBreakPoints::RemoveMemCheck(u32 start, u32 end)
 {
+	ScopedBreakPointsPause pause;
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -313,29 +421,34 @@ void CBreakPoints::RemoveMemCheck(u32 start, u32 end)
 	if (mc != INVALID_MEMCHECK)
 	{
 		memChecks_.erase(memChecks_.begin() + mc);
+		UpdateMemCheckPages();
 		Update();
 	}
 }
 
 void CBreakPoints::ChangeMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	ScopedBreakPointsPause pause;
 	size_t mc = FindMemCheck(start, end);
 	if (mc != INVALID_MEMCHECK)
 	{
 		memChecks_[mc].cond = cond;
 		memChecks_[mc].result = result;
+		UpdateMemCheckPages();
 		Update();
 	}
 }
 
 void CBreakPoints::ClearAllMemChecks()
 {
+	ScopedBreakPointsPause pause;
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
 	if (!memChecks_.empty())
 	{
 		memChecks_.clear();
+		UpdateMemCheckPages();
 		Update();
 	}
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <vector>
+#include <unordered_set>
 
 #include "DebugInterface.h"
 #include "Pcsx2Types.h"
@@ -143,6 +144,16 @@ public:
 	static const std::vector<BreakPoint> GetBreakpoints();
 	static size_t GetNumMemchecks() { return memChecks_.size(); }
 
+	// One bit per 4KB page of the (non standardized) address space, set if an access starting
+	// in that page may overlap a memcheck.  Lets the recompiler skip the range checks with a
+	// single bit test for the vast majority of accesses.
+	static const u32* GetMemCheckPages() { return memCheckPages_; }
+	static bool IsMemCheckPage(u32 addr) { return (memCheckPages_[addr >> 17] >> ((addr >> 12) & 31)) & 1; }
+
+	// Precise check of a standardized access against all memchecks, returns the combined result
+	// of the ones it hits.
+	static MemCheckResult CheckMemAccess(u32 start, u32 size, bool store);
+
 	static void Update(u32 addr = 0);
 
 	static void SetBreakpointTriggered(bool b) { breakpointTriggered_ = b; };
@@ -153,13 +164,20 @@ private:
 	// Finds exactly, not using a range check.
 	static size_t FindMemCheck(u32 start, u32 end);
 
+	static void UpdateBreakPointAddrs();
+	static void UpdateMemCheckPages();
+
 	static std::vector<BreakPoint> breakPoints_;
+	// Standardized addresses of all breakpoints, so that lookups of addresses without one
+	// (nearly all of them, as the recompiler asks for every instruction) don't scan the list.
+	static std::unordered_set<u32> breakPointAddrs_;
 	static u32 breakSkipFirstAt_;
 	static u64 breakSkipFirstTicks_;
 	static bool breakpointTriggered_;
 
 	static std::vector<MemCheck> memChecks_;
 	static std::vector<MemCheck *> cleanupMemChecks_;
+	static u32 memCheckPages_[0x100000 / 32];
 };
 
 
@@ -298,6 +298,23 @@ enum MTGS_RingCommand
 };
 
 
+// Pending GS packet that hasn't been written to the ring yet. Adjacent packets from
+// the same gif path are merged into it, so a burst of tiny PATH3 IMAGE packets ends
+// up as a single GS_RINGTYPE_GSPACKET command. (EE thread only)
+struct MTGS_GSPacketBatch
+{
+	u32      offset; // Path buffer offset of the first merged packet
+	u32      size;   // Total size in bytes of all merged packets
+	u32      count;  // Number of GS packets merged
+	GIF_PATH path;
+
+	void Reset() { memzero(*this); }
+};
+
+// Merged GS packets are sent once they reach this size (in bytes), or as soon as the
+// EE sends any other ring command or waits on the MTGS (vsync bounds the latency).
+static const uint GSPacketBatchMaxSize = _128kb;
+
 struct MTGS_FreezeData
 {
 	freezeData*	fdata;
@@ -348,6 +365,11 @@ public:
 	uint			m_packet_size;		// size of the packet (data only, ie. not including the 16 byte command!)
 	uint			m_packet_writepos;	// index of the data location in the ringbuffer.
 
+	MTGS_GSPacketBatch	m_GSPacketBatch;
+	u64					m_GSPacketsQueued;	// GS packets handed to the MTGS by the gif unit
+	u64					m_GSPacketsSent;	// GS packet ring commands actually written
+	uint				m_GSPacketStatVsyncs;	// vsyncs since the counts were last logged
+
 #ifdef RINGBUF_DEBUG_STACK
 	Threading::Mutex m_lock_Stack;
 #endif
@@ -368,6 +390,7 @@ public:
 	void Freeze( int mode, MTGS_FreezeData& data );
 
 	void SendSimpleGSPacket( MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path );
+	void FlushGSPacketBatch();
 	void SendSimplePacket( MTGS_RingCommand type, int data0, int data1, int data2 );
 	void SendPointerPacket( MTGS_RingCommand type, u32 data0, void* data1 );
 
@@ -393,6 +416,7 @@ protected:
 
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
+	void _SendSimpleGSPacket( MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path );
 	void ExecuteTaskInThread();
 };
 
@@ -16,6 +16,10 @@
 #include "PrecompiledHeader.h"
 #include "GameDatabase.h"
 
+#include <algorithm>
+#include <climits>
+#include <wx/ffile.h>
+
 BaseGameDatabaseImpl::BaseGameDatabaseImpl()
 	: gHash( 9900 )
 	, m_baseKey( L"Serial" )
@@ -26,6 +30,9 @@ BaseGameDatabaseImpl::BaseGameDatabaseImpl()
 // Returns true if game found, false if not found...
 bool BaseGameDatabaseImpl::findGame(Game_Data& dest, const wxString& id) {
 
+	if (m_compiled.IsOk())
+		return m_compiled.findGame(dest, id);
+
 	GameDataHash::const_iterator iter( gHash.find(id) );
 	if( iter == gHash.end() ) {
 		dest.clear();
@@ -74,3 +81,215 @@ void Game_Data::writeString(const wxString& key, const wxString& value) {
 		kList.push_back(key_pair(key, value));
 	}
 }
+
+// --------------------------------------------------------------------------------------
+//  CompiledGameDatabase  (implementations)
+// --------------------------------------------------------------------------------------
+
+CompiledGameDatabase::CompiledGameDatabase()
+	: m_header(NULL)
+	, m_games(NULL)
+	, m_pairs(NULL)
+	, m_strings(NULL)
+{
+}
+
+// FNV-1a, the image only needs to notice that the text database changed
+u64 CompiledGameDatabase::HashSource( const void* data, size_t size )
+{
+	const u8* bytes = (const u8*)data;
+	u64 hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+
+	return hash;
+}
+
+// Integers are stored as such only if formatting them gives back the same text
+static bool ParseCanonicalInt( const std::string& text, s32& dest )
+{
+	if (text.empty() || text.size() > 11) return false;
+
+	char* end;
+	long value = strtol(text.c_str(), &end, 10);
+	if (*end || value < INT_MIN || value > INT_MAX) return false;
+
+	char buf[16];
+	snprintf(buf, sizeof(buf), "%ld", value);
+	if (text != buf) return false;
+
+	dest = (s32)value;
+	return true;
+}
+
+bool CompiledGameDatabase::Save( const wxString& file, u64 sourceHash, const GameDataHash& games )
+{
+	std::vector<const Game_Data*> sorted;
+	sorted.reserve(games.size());
+	for (const auto& it : games)
+		sorted.push_back(&it.second);
+
+	std::vector<std::string> serials(sorted.size());
+	for (size_t i = 0; i < sorted.size(); i++)
+		serials[i] = sorted[i]->id.ToUTF8();
+
+	std::vector<u32> order(sorted.size());
+	for (u32 i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&](u32 a, u32 b) { return serials[a] < serials[b]; });
+
+	std::string strings;
+	std::unordered_map<std::string, u32> interned;
+	auto intern = [&](const std::string& str) -> u32 {
+		auto found = interned.find(str);
+		if (found != interned.end()) return found->second;
+
+		u32 offset = (u32)strings.size();
+		strings.append(str.c_str(), str.size() + 1);
+		interned.emplace(str, offset);
+		return offset;
+	};
+
+	std::vector<GameEntry> gameEntries;
+	std::vector<PairEntry> pairEntries;
+	gameEntries.reserve(order.size());
+
+	for (u32 i : order)
+	{
+		GameEntry game;
+		game.serial = intern(serials[i]);
+		game.firstPair = (u32)pairEntries.size();
+		game.pairCount = (u32)sorted[i]->kList.size();
+		gameEntries.push_back(game);
+
+		for (const key_pair& kp : sorted[i]->kList)
+		{
+			PairEntry pair;
+			pair.key = intern(std::string(kp.key.ToUTF8()));
+
+			const std::string value(kp.value.ToUTF8());
+			s32 number;
+			if (ParseCanonicalInt(value, number))
+			{
+				pair.type = Pair_Int;
+				pair.value = (u32)number;
+			}
+			else
+			{
+				pair.type = Pair_String;
+				pair.value = intern(value);
+			}
+			pairEntries.push_back(pair);
+		}
+	}
+
+	Header header;
+	header.magic		= Magic;
+	header.version		= Version;
+	header.sourceHash	= sourceHash;
+	header.gameCount	= (u32)gameEntries.size();
+	header.pairCount	= (u32)pairEntries.size();
+	header.stringBytes	= (u32)strings.size();
+	header.reserved		= 0;
+
+	wxFFile fp(file, L"wb");
+	if (!fp.IsOpened()) return false;
+
+	bool ok = fp.Write(&header, sizeof(header)) == sizeof(header);
+	ok = ok && fp.Write(gameEntries.data(), gameEntries.size() * sizeof(GameEntry)) == gameEntries.size() * sizeof(GameEntry);
+	ok = ok && fp.Write(pairEntries.data(), pairEntries.size() * sizeof(PairEntry)) == pairEntries.size() * sizeof(PairEntry);
+	ok = ok && fp.Write(strings.data(), strings.size()) == strings.size();
+	return ok;
+}
+
+bool CompiledGameDatabase::Load( const wxString& file, u64 sourceHash )
+{
+	m_image.reset();
+
+	if (!wxFileExists(file)) return false;
+
+	wxFFile fp(file, L"rb");
+	if (!fp.IsOpened()) return false;
+
+	Header header;
+	if (fp.Read(&header, sizeof(header)) != sizeof(header)) return false;
+	if (header.magic != Magic || header.version != Version || header.sourceHash != sourceHash) return false;
+
+	size_t size = (size_t)fp.Length();
+	if (size < sizeof(Header)) return false;
+
+	std::unique_ptr<u8[]> image(new u8[size]);
+	fp.Seek(0);
+	if (fp.Read(image.get(), size) != size) return false;
+
+	m_image = std::move(image);
+	m_header	= (const Header*)m_image.get();
+	m_games		= (const GameEntry*)(m_header + 1);
+	m_pairs		= (const PairEntry*)(m_games + m_header->gameCount);
+	m_strings	= (const char*)(m_pairs + m_header->pairCount);
+
+	if (!Validate(size))
+	{
+		Console.Warning(L"(GameDB) Ignoring corrupt compiled database [%s]", WX_STR(file));
+		m_image.reset();
+		return false;
+	}
+
+	return true;
+}
+
+// Checks that every offset stays inside the image, so lookups don't need to
+bool CompiledGameDatabase::Validate( size_t size ) const
+{
+	const u64 expected = sizeof(Header) + (u64)m_header->gameCount * sizeof(GameEntry)
+		+ (u64)m_header->pairCount * sizeof(PairEntry) + m_header->stringBytes;
+	if (expected != size) return false;
+
+	const u32 stringBytes = m_header->stringBytes;
+	if (stringBytes && m_strings[stringBytes - 1]) return false;
+
+	for (u32 i = 0; i < m_header->gameCount; i++)
+	{
+		const GameEntry& game = m_games[i];
+		if (game.serial >= stringBytes) return false;
+		if (game.firstPair > m_header->pairCount || game.pairCount > m_header->pairCount - game.firstPair) return false;
+		if (i && strcmp(m_strings + m_games[i - 1].serial, m_strings + game.serial) > 0) return false;
+	}
+
+	for (u32 i = 0; i < m_header->pairCount; i++)
+	{
+		const PairEntry& pair = m_pairs[i];
+		if (pair.key >= stringBytes) return false;
+		if (pair.type == Pair_String && pair.value >= stringBytes) return false;
+		if (pair.type != Pair_String && pair.type != Pair_Int) return false;
+	}
+
+	return true;
+}
+
+bool CompiledGameDatabase::findGame( Game_Data& dest, const wxString& id ) const
+{
+	dest.clear();
+	if (!IsOk()) return false;
+
+	const std::string serial(id.ToUTF8());
+	const GameEntry* end = m_games + m_header->gameCount;
+	const GameEntry* game = std::lower_bound(m_games, end, serial, [&](const GameEntry& entry, const std::string& value) {
+		return strcmp(m_strings + entry.serial, value.c_str()) < 0;
+	});
+
+	if (game == end || serial != (m_strings + game->serial)) return false;
+
+	dest.id = wxString::FromUTF8(m_strings + game->serial);
+	dest.kList.reserve(game->pairCount);
+
+	for (u32 i = 0; i < game->pairCount; i++)
+	{
+		const PairEntry& pair = m_pairs[game->firstPair + i];
+		const wxString value = (pair.type == Pair_Int) ? wxsFormat(L"%d", (s32)pair.value) : wxString::FromUTF8(m_strings + pair.value);
+		dest.kList.push_back(key_pair(wxString::FromUTF8(m_strings + pair.key), value));
+	}
+
+	return true;
+}
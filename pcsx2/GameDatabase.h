@@ -24,6 +24,7 @@
 // parameter. Unless we undef it here, the build breaks with a cryptic error message.
 #undef _Target_
 #include <unordered_map>
+#include <memory>
 #include <wx/wfstream.h>
 
 struct	key_pair;
@@ -138,6 +139,75 @@ public:
 
 using GameDataHash = std::unordered_map<wxString, Game_Data, StringHash>;
 
+// --------------------------------------------------------------------------------------
+//  CompiledGameDatabase
+// --------------------------------------------------------------------------------------
+// Binary form of the game database, which is searched in place instead of being parsed into
+// a GameDataHash.  Serials are sorted for binary search, keys and string values are interned
+// into a single string table, and integer values are stored as integers.  The image records
+// the hash of the text database it was built from, so a changed GameIndex.dbf is detected
+// and compiled again.
+//
+class CompiledGameDatabase
+{
+public:
+	static const u32 Magic		= 0x43424447;	// "GDBC"
+	static const u32 Version	= 1;
+
+protected:
+	struct Header
+	{
+		u32 magic;
+		u32 version;
+		u64 sourceHash;
+		u32 gameCount;
+		u32 pairCount;
+		u32 stringBytes;
+		u32 reserved;
+	};
+
+	struct GameEntry
+	{
+		u32 serial;			// offset in the string table
+		u32 firstPair;
+		u32 pairCount;
+	};
+
+	enum PairType
+	{
+		Pair_String,		// value is an offset in the string table
+		Pair_Int,			// value is the integer itself
+	};
+
+	struct PairEntry
+	{
+		u32 key;			// offset in the string table
+		u32 type;
+		u32 value;
+	};
+
+	std::unique_ptr<u8[]>	m_image;
+	const Header*			m_header;
+	const GameEntry*		m_games;
+	const PairEntry*		m_pairs;
+	const char*				m_strings;
+
+public:
+	CompiledGameDatabase();
+
+	bool IsOk() const { return m_image != nullptr; }
+	u32 GetGameCount() const { return IsOk() ? m_header->gameCount : 0; }
+
+	bool Load( const wxString& file, u64 sourceHash );
+	static bool Save( const wxString& file, u64 sourceHash, const GameDataHash& games );
+	static u64 HashSource( const void* data, size_t size );
+
+	bool findGame( Game_Data& dest, const wxString& id ) const;
+
+protected:
+	bool Validate( size_t size ) const;
+};
+
 // --------------------------------------------------------------------------------------
 //  BaseGameDatabaseImpl 
 // --------------------------------------------------------------------------------------
@@ -145,6 +215,7 @@ class BaseGameDatabaseImpl : public IGameDatabase
 {
 protected:
 	GameDataHash	gHash;			// hash table of game serials matched to their gList indexes!
+	CompiledGameDatabase m_compiled;	// used instead of gHash when it's loaded
 	wxString		m_baseKey;
 
 public:
@@ -645,50 +645,72 @@ static void ipuSETTH(u32 val)
 // --------------------------------------------------------------------------------------
 __fi void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
 {
-	int i;
-	u8* p = (u8*)&rgb32;
-
 	yuv2rgb();
 
-	if (s_thresh[0] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[0]) && (p[1] < s_thresh[0]) && (p[2] < s_thresh[0]))
-				*(u32*)p = 0;
-			else if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	else if (s_thresh[1] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	if (sgn)
+	if (!s_thresh[0] && !s_thresh[1] && !sgn)
+		return;
+
+	// Thresholding and the sign flip, four pixels at a time.  A pixel whose R, G and B are all
+	// below TH0 becomes transparent black; otherwise if they're all below TH1 its alpha is set
+	// to 0x40.  A zero threshold never matches, so one loop covers every TH0/TH1 combination.
+	// SSE2 only has signed byte compares, so both sides are biased by 0x80 first.
+	const __m128i bias = _mm_set1_epi8(s8(0x80));
+	const __m128i th0 = _mm_set1_epi8(s8(s_thresh[0] ^ 0x80));
+	const __m128i th1 = _mm_set1_epi8(s8(s_thresh[1] ^ 0x80));
+	const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+	const __m128i alpha_40 = _mm_set1_epi32(0x40000000);
+	const __m128i all_ones = _mm_set1_epi32(-1);
+	const __m128i sgn_mask = sgn ? _mm_set1_epi32(0x808080) : _mm_setzero_si128();
+
+	__m128i* p = reinterpret_cast<__m128i*>(&rgb32);
+
+	for (int i = 0; i < 16*16/4; ++i)
 	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			*(u32*)p ^= 0x808080;
-		}
+		__m128i px = _mm_load_si128(&p[i]);
+		const __m128i biased = _mm_xor_si128(px, bias);
+
+		const __m128i below0 = _mm_cmpeq_epi32(_mm_or_si128(_mm_cmplt_epi8(biased, th0), alpha_mask), all_ones);
+		const __m128i below1 = _mm_cmpeq_epi32(_mm_or_si128(_mm_cmplt_epi8(biased, th1), alpha_mask), all_ones);
+
+		px = _mm_or_si128(_mm_andnot_si128(_mm_and_si128(below1, alpha_mask), px), _mm_and_si128(below1, alpha_40));
+		px = _mm_andnot_si128(below0, px);
+
+		_mm_store_si128(&p[i], _mm_xor_si128(px, sgn_mask));
 	}
 }
 
+// Converts to 5:5:5:1, eight pixels at a time.  Alpha is set for the pixels ipu_csc marked
+// with 0x40.  Dithering (DTE) is not implemented; the colours are truncated.
 __fi void ipu_dither(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte)
 {
-	int i, j;
-	for (i = 0; i < 16; ++i)
+	const __m128i r_mask = _mm_set1_epi32(0x001F);
+	const __m128i g_mask = _mm_set1_epi32(0x03E0);
+	const __m128i b_mask = _mm_set1_epi32(0x7C00);
+	const __m128i a_bit = _mm_set1_epi32(0x8000);
+	const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+	const __m128i alpha_40 = _mm_set1_epi32(0x40000000);
+
+	const __m128i* src = reinterpret_cast<const __m128i*>(&rgb32);
+	__m128i* dest = reinterpret_cast<__m128i*>(&rgb16);
+
+	for (int i = 0; i < 16*16/8; ++i)
 	{
-		for (j = 0; j < 16; ++j)
+		__m128i out[2];
+
+		for (int n = 0; n < 2; ++n)
 		{
-			rgb16.c[i][j].r = rgb32.c[i][j].r >> 3;
-			rgb16.c[i][j].g = rgb32.c[i][j].g >> 3;
-			rgb16.c[i][j].b = rgb32.c[i][j].b >> 3;
-			rgb16.c[i][j].a = rgb32.c[i][j].a == 0x40;
+			const __m128i px = _mm_load_si128(&src[i * 2 + n]);
+
+			__m128i c = _mm_and_si128(_mm_srli_epi32(px, 3), r_mask);
+			c = _mm_or_si128(c, _mm_and_si128(_mm_srli_epi32(px, 6), g_mask));
+			c = _mm_or_si128(c, _mm_and_si128(_mm_srli_epi32(px, 9), b_mask));
+			c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(px, alpha_mask), alpha_40), a_bit));
+
+			// Sign extend so the signed pack below can't saturate.
+			out[n] = _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
 		}
+
+		_mm_store_si128(&dest[i], _mm_packs_epi32(out[0], out[1]));
 	}
 }
 
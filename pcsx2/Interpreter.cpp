@@ -74,24 +74,12 @@ void intMemcheck(u32 op, u32 bits, bool store)
 	if (bits == 128)
 		start &= ~0x0F;
 
-	start = standardizeBreakpointAddress(start);
-	u32 end = start + bits/8;
-	
-	auto checks = CBreakPoints::GetMemChecks();
-	for (size_t i = 0; i < checks.size(); i++)
-	{
-		auto& check = checks[i];
-
-		if (check.result == 0)
-			continue;
-		if ((check.cond & MEMCHECK_WRITE) == 0 && store)
-			continue;
-		if ((check.cond & MEMCHECK_READ) == 0 && !store)
-			continue;
+	if (!CBreakPoints::IsMemCheckPage(start))
+		return;
 
-		if (start < check.end && check.start < end)
-			intBreakpoint(true);
-	}
+	start = standardizeBreakpointAddress(start);
+	if (CBreakPoints::CheckMemAccess(start, bits/8, store) != MEMCHECK_IGNORE)
+		intBreakpoint(true);
 }
 
 void intCheckMemcheck()
@@ -692,6 +692,411 @@ irxDEBUG irxImportDebug(const std::string &libname, u16 index)
 #undef EXPORT_D
 #undef EXPORT_H
 
+// --------------------------------------------------------------------------------------
+//  IRX fast paths
+// --------------------------------------------------------------------------------------
+// Native versions of small leaf functions which IOP drivers call in tight loops.  Unlike the
+// HLE functions above they give the same results as the IRX code.  The IOP is charged an
+// estimate of the cycles the IRX code would have taken (see iopChargeCycles), so timing only
+// changes by the error of that estimate.  They are enabled by IopHle.FastPaths, and can be
+// turned off one by one with IopHle.DisabledFastPaths.
+//
+// With IopHle.CheckFastPaths, the IRX code is run as well (see irxCheckFastPath) and the
+// results are compared.  The IRX results are the ones kept.
+//
+// Kernel calls which use thread, semaphore, event flag, interrupt or SIF DMA state (the
+// thread calls of thbase, thsemap, thevent, intrman, sifman.sceSifSetDma) are left to the
+// IRX code, a native version would have to reimplement the IOP kernel's data structures.
+// Only kernel functions computed from their arguments alone are covered.
+//
+// That includes the pollers which busy-polling drivers spin on (thsemap.PollSema,
+// thsemap.ReferSemaStatus, thevent.PollEventFlag), even though a failed poll only reads the
+// kernel object.  How an ID maps to its object, and where the count and bits live in it, is
+// private to the BIOS's kernel modules and nothing in the emulator describes it, so reading
+// them directly would be a guess which could return another value than the kernel would.
+// The IOP block profiler shows which drivers spin on them.
+
+// Largest size handled natively, anything bigger is left to the IRX code
+static const u32 FastPathMaxSize = Ps2MemSize::IopRam;
+
+// Direct pointer to IOP ram for [addr, addr+size), or NULL if the range isn't plain ram
+static u8* iopRamRange(u32 addr, u32 size)
+{
+	addr &= 0x1fffffff;
+	if ((addr >= Ps2MemSize::IopRam) || (size > Ps2MemSize::IopRam - addr)) return NULL;
+	if (psxRegs.CP0.n.Status & 0x10000) return NULL;	// cache isolated
+
+	return iopPhysMem(addr);
+}
+
+// Accounts for IOP code skipped by a fast path, the same way the interpreter does per instruction
+static void iopChargeCycles(u32 cycles)
+{
+	psxRegs.cycle += cycles;
+	iopCycleEE -= cycles * 8;
+}
+
+static void iopRamModified(u32 addr, u32 size)
+{
+	if (size)
+		psxCpu->Clear(addr & ~3, ((addr & 3) + size + 3) / 4);
+}
+
+static void iopReadBlock(u8* dst, u32 src, u32 size)
+{
+	if (const u8* p = iopRamRange(src, size))
+		memcpy(dst, p, size);
+	else
+		for (u32 i = 0; i < size; i++) dst[i] = iopMemRead8(src + i);
+}
+
+static void iopWriteBlock(u32 dst, const u8* src, u32 size)
+{
+	if (u8* p = iopRamRange(dst, size))
+	{
+		memcpy(p, src, size);
+		iopRamModified(dst, size);
+	}
+	else
+		for (u32 i = 0; i < size; i++) iopMemWrite8(dst + i, src[i]);
+}
+
+// Copies front to back, so overlapping copies repeat the pattern like a byte loop would
+static void iopCopyForward(u32 dst, u32 src, u32 size)
+{
+	u8* d = iopRamRange(dst, size);
+	const u8* s = iopRamRange(src, size);
+
+	if (d && s && ((dst & 0x1fffffff) <= (src & 0x1fffffff) || (dst & 0x1fffffff) >= (src & 0x1fffffff) + size))
+	{
+		memmove(d, s, size);
+		iopRamModified(dst, size);
+	}
+	else
+		for (u32 i = 0; i < size; i++) iopMemWrite8(dst + i, iopMemRead8(src + i));
+}
+
+static void iopMove(u32 dst, u32 src, u32 size)
+{
+	u8* d = iopRamRange(dst, size);
+	const u8* s = iopRamRange(src, size);
+
+	if (d && s)
+	{
+		memmove(d, s, size);
+		iopRamModified(dst, size);
+	}
+	else if ((dst & 0x1fffffff) <= (src & 0x1fffffff))
+		for (u32 i = 0; i < size; i++) iopMemWrite8(dst + i, iopMemRead8(src + i));
+	else
+		for (u32 i = size; i > 0; i--) iopMemWrite8(dst + i - 1, iopMemRead8(src + i - 1));
+}
+
+static void iopFill(u32 dst, u8 value, u32 size)
+{
+	if (u8* p = iopRamRange(dst, size))
+	{
+		memset(p, value, size);
+		iopRamModified(dst, size);
+	}
+	else
+		for (u32 i = 0; i < size; i++) iopMemWrite8(dst + i, value);
+}
+
+// Length of the string at addr, or FastPathMaxSize if it isn't terminated in time
+static u32 iopStrlen(u32 addr)
+{
+	if (const u8* p = iopRamRange(addr, 1))
+	{
+		u32 avail = Ps2MemSize::IopRam - (addr & 0x1fffffff);
+		const u8* end = (const u8*)memchr(p, 0, std::min(avail, FastPathMaxSize));
+		if (end) return end - p;
+	}
+
+	for (u32 i = 0; i < FastPathMaxSize; i++)
+		if (!iopMemRead8(addr + i)) return i;
+
+	return FastPathMaxSize;
+}
+
+// The cycle estimates assume word loops for copies and fills, and byte loops for strings.
+namespace sysclib {
+	static bool memcpy_FAST()
+	{
+		if (a2 > FastPathMaxSize) return false;
+		iopCopyForward(a0, a1, a2);
+		v0 = a0;
+		iopChargeCycles(12 + a2);
+		return true;
+	}
+
+	static void memcpy_OUT(u32& addr, u32& size) { addr = a0; size = a2; }
+
+	static bool memmove_FAST()
+	{
+		if (a2 > FastPathMaxSize) return false;
+		iopMove(a0, a1, a2);
+		v0 = a0;
+		iopChargeCycles(12 + a2);
+		return true;
+	}
+
+	static void memmove_OUT(u32& addr, u32& size) { addr = a0; size = a2; }
+
+	static bool memset_FAST()
+	{
+		if (a2 > FastPathMaxSize) return false;
+		iopFill(a0, (u8)a1, a2);
+		v0 = a0;
+		iopChargeCycles(12 + a2 / 2);
+		return true;
+	}
+
+	static void memset_OUT(u32& addr, u32& size) { addr = a0; size = a2; }
+
+	static bool bcopy_FAST()
+	{
+		if (a2 > FastPathMaxSize) return false;
+		iopMove(a1, a0, a2);
+		iopChargeCycles(12 + a2);
+		return true;
+	}
+
+	static void bcopy_OUT(u32& addr, u32& size) { addr = a1; size = a2; }
+
+	static bool bzero_FAST()
+	{
+		if (a1 > FastPathMaxSize) return false;
+		iopFill(a0, 0, a1);
+		iopChargeCycles(12 + a1 / 2);
+		return true;
+	}
+
+	static void bzero_OUT(u32& addr, u32& size) { addr = a0; size = a1; }
+
+	static bool strlen_FAST()
+	{
+		u32 len = iopStrlen(a0);
+		if (len >= FastPathMaxSize) return false;
+		v0 = len;
+		iopChargeCycles(8 + len * 3);
+		return true;
+	}
+
+	static void strlen_OUT(u32& addr, u32& size) { addr = 0; size = 0; }
+
+	static bool strcpy_FAST()
+	{
+		u32 len = iopStrlen(a1);
+		if (len >= FastPathMaxSize) return false;
+		iopCopyForward(a0, a1, len + 1);
+		v0 = a0;
+		iopChargeCycles(8 + (len + 1) * 5);
+		return true;
+	}
+
+	static void strcpy_OUT(u32& addr, u32& size) { addr = a0; size = std::min(iopStrlen(a1) + 1, FastPathMaxSize); }
+
+	static bool strncpy_FAST()
+	{
+		if (a2 > FastPathMaxSize) return false;
+		u32 len = std::min(iopStrlen(a1), a2);
+		iopCopyForward(a0, a1, len);
+		iopFill(a0 + len, 0, a2 - len);
+		v0 = a0;
+		iopChargeCycles(8 + a2 * 5);
+		return true;
+	}
+
+	static void strncpy_OUT(u32& addr, u32& size) { addr = a0; size = std::min(a2, FastPathMaxSize); }
+}
+
+namespace sysmem {
+	// sysmem manages all of IOP ram
+	static bool QueryMemSize_FAST()
+	{
+		v0 = Ps2MemSize::IopRam;
+		iopChargeCycles(4);
+		return true;
+	}
+
+	static void QueryMemSize_OUT(u32& addr, u32& size) { addr = 0; size = 0; }
+}
+
+namespace thbase {
+	// The system clock counts IOP cycles (36.864MHz); a1 points to an iop_sys_clock_t (lo, hi)
+	static bool USec2SysClock_FAST()
+	{
+		const u64 clock = (u64)a0 * 36864 / 1000;
+		const u32 out[2] = { (u32)clock, (u32)(clock >> 32) };
+
+		iopWriteBlock(a1, (const u8*)out, sizeof(out));
+		iopChargeCycles(20);
+		return true;
+	}
+
+	static void USec2SysClock_OUT(u32& addr, u32& size) { addr = a1; size = 8; }
+}
+
+struct irxFastPath
+{
+	const char* libname;
+	u16 index;
+	const char* name;		// "library.function", as used by IopHle.DisabledFastPaths
+	bool result;			// v0 holds a return value
+
+	bool (*run)();						// does the work, or returns false to leave it to the IRX code
+	void (*output)(u32& addr, u32& size);	// memory written by the function, from its arguments
+};
+
+#define FASTPATH(lib, i, n, r) { #lib, i, #lib "." #n, r, lib::n ## _FAST, lib::n ## _OUT }
+
+static const irxFastPath irxFastPaths[] =
+{
+	FASTPATH(sysclib, 12, memcpy,  true),
+	FASTPATH(sysclib, 13, memmove, true),
+	FASTPATH(sysclib, 14, memset,  true),
+	FASTPATH(sysclib, 16, bcopy,   false),
+	FASTPATH(sysclib, 17, bzero,   false),
+	FASTPATH(sysclib, 23, strcpy,  true),
+	FASTPATH(sysclib, 27, strlen,  true),
+	FASTPATH(sysclib, 30, strncpy, true),
+	FASTPATH(sysmem,   6, QueryMemSize,  true),
+	FASTPATH(thbase,  39, USec2SysClock, false),
+};
+
+#undef FASTPATH
+
+// IopHle.DisabledFastPaths, parsed by irxFastPathsApplyConfig
+static bool irxFastPathDisabled[ArraySize(irxFastPaths)];
+
+static bool irxFastPathListed(const std::string& list, const char* name)
+{
+	const size_t len = strlen(name);
+
+	for (size_t pos = list.find(name); pos != std::string::npos; pos = list.find(name, pos + 1))
+	{
+		bool start = (pos == 0) || strchr(", \t", list[pos - 1]);
+		bool end = (pos + len == list.size()) || strchr(", \t", list[pos + len]);
+		if (start && end) return true;
+	}
+
+	return false;
+}
+
+void irxFastPathsApplyConfig()
+{
+	const std::string list(EmuConfig.IopHle.DisabledFastPaths.ToUTF8());
+
+	for (uint i = 0; i < ArraySize(irxFastPaths); i++)
+		irxFastPathDisabled[i] = irxFastPathListed(list, irxFastPaths[i].name);
+}
+
+int irxImportFastPath(const std::string &libname, u16 index)
+{
+	if (!EmuConfig.IopHle.FastPaths) return -1;
+
+	for (uint i = 0; i < ArraySize(irxFastPaths); i++)
+	{
+		const irxFastPath& fp = irxFastPaths[i];
+		if (fp.index == index && libname == fp.libname)
+			return irxFastPathDisabled[i] ? -1 : (int)i;
+	}
+
+	return -1;
+}
+
+// Entry point of the library function behind the import stub being executed, or 0 if the
+// stub isn't linked.  The stub is "j function; addiu zero, zero, index", and pc is either at
+// the addiu (interpreter) or past it (recompiler).
+static u32 irxFastPathTarget()
+{
+	u32 slot = pc;
+	if (iopMemRead32(slot) >> 16 != 0x2400)
+		slot -= 4;
+
+	const u32 jump = iopMemRead32(slot - 4);
+	if (jump >> 26 != 2) return 0;
+
+	return (slot & 0xf0000000) | ((jump & 0x03ffffff) << 2);
+}
+
+static void irxCheckFastPath(const irxFastPath& fp)
+{
+	u32 addr, size;
+	fp.output(addr, size);
+
+	const u32 target = irxFastPathTarget();
+	if (!target || size > FastPathMaxSize)
+	{
+		if (fp.run()) pc = ra;
+		return;
+	}
+
+	const u32 args[3] = { a0, a1, a2 };
+
+	// Reference run of the library code on the interpreter
+	const psxRegisters before = psxRegs;
+	std::vector<u8> original(size), expected(size), actual(size);
+	iopReadBlock(original.data(), addr, size);
+
+	pc = target;
+	if (!psxRunLeaf(ra, 0x1000000))
+	{
+		Console.Error("IOP fast path %s: the IRX code didn't return, check skipped", fp.name);
+		psxRegs = before;
+		iopWriteBlock(addr, original.data(), size);
+		if (fp.run()) pc = ra;
+		return;
+	}
+
+	const psxRegisters reference = psxRegs;
+	const s32 referenceCycleEE = iopCycleEE;
+	const u32 result = v0;
+	iopReadBlock(expected.data(), addr, size);
+
+	// Fast path on the original state
+	psxRegs = before;
+	iopWriteBlock(addr, original.data(), size);
+
+	if (fp.run())
+	{
+		iopReadBlock(actual.data(), addr, size);
+
+		if (fp.result && (v0 != result))
+			Console.Error("IOP fast path %s(%x, %x, %x): returned %x instead of %x", fp.name, args[0], args[1], args[2], v0, result);
+
+		for (u32 i = 0; i < size; i++)
+		{
+			if (actual[i] != expected[i])
+			{
+				Console.Error("IOP fast path %s(%x, %x, %x): wrote %02x instead of %02x at %x", fp.name, args[0], args[1], args[2], actual[i], expected[i], addr + i);
+				break;
+			}
+		}
+	}
+
+	psxRegs = reference;
+	iopCycleEE = referenceCycleEE;
+	iopWriteBlock(addr, expected.data(), size);
+}
+
+int __fastcall irxFastPathExec(u32 fastpath)
+{
+	const irxFastPath& fp = irxFastPaths[fastpath];
+
+	if (EmuConfig.IopHle.CheckFastPaths)
+	{
+		irxCheckFastPath(fp);
+		return 1;
+	}
+
+	if (!fp.run()) return 0;
+
+	pc = ra;
+	return 1;
+}
+
 void irxImportLog(const std::string &libname, u16 index, const char *funcname)
 {
 	PSXBIOS_LOG("%8.8s.%03d: %s (%x, %x, %x, %x)",
@@ -723,8 +1128,12 @@ int irxImportExec(u32 import_table, u16 index)
 	
 	if (hle)
 		return hle();
-	else
-		return 0;
+
+	const int fastpath = irxImportFastPath(libname, index);
+	if (fastpath >= 0)
+		return irxFastPathExec(fastpath);
+
+	return 0;
 }
 
 }	// end namespace R3000A
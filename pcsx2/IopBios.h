@@ -70,6 +70,9 @@ namespace R3000A
 	void irxImportLog(const std::string &libnameptr, u16 index, const char *funcname);
 	void __fastcall irxImportLog_rec(u32 import_table, u16 index, const char *funcname);
 	int irxImportExec(u32 import_table, u16 index);
+	int irxImportFastPath(const std::string &libname, u16 index);
+	int __fastcall irxFastPathExec(u32 fastpath);
+	void irxFastPathsApplyConfig();
 
 	namespace ioman
 	{
@@ -23,6 +23,7 @@
 #include "Gif_Unit.h"
 #include "MTVU.h"
 #include "Elfheader.h"
+#include "System/Timeline.h"
 
 
 // Uncomment this to enable profiling of the GS RingBufferCopy function.
@@ -77,6 +78,11 @@ void SysMtgsThread::OnStart()
 
 	m_CopyDataTally		= 0;
 
+	m_GSPacketBatch.Reset();
+	m_GSPacketsQueued	= 0;
+	m_GSPacketsSent		= 0;
+	m_GSPacketStatVsyncs = 0;
+
 	_parent::OnStart();
 }
 
@@ -105,6 +111,7 @@ void SysMtgsThread::ResetGS()
 	m_ReadPos             = m_WritePos.load();
 	m_QueuedFrameCount    = 0;
 	m_VsyncSignalListener = 0;
+	m_GSPacketBatch.Reset(); // Dropped along with the ring contents
 
 	MTGS_LOG( "MTGS: Sending Reset..." );
 	SendSimplePacket( GS_RINGTYPE_RESET, 0, 0, 0 );
@@ -127,6 +134,19 @@ void SysMtgsThread::PostVsyncStart()
 	// 256-byte copy is only a few dozen cycles -- executed 60 times a second -- so probably
 	// not worth the effort or overhead of trying to selectively avoid it.
 
+	// With the profiler on, log how many GS packets each ring command carried over the
+	// last 300 vsyncs (see EmuConfig.GS.CoalescePackets).
+	if (EmuConfig.Profiler.Enabled && ++m_GSPacketStatVsyncs >= 300) {
+		if (m_GSPacketsSent)
+			DevCon.WriteLn("MTGS: GS packet coalescing %s [packets=%u][commands=%u][ratio=%.2f]",
+				EmuConfig.GS.CoalescePackets ? "on" : "off", (u32)m_GSPacketsQueued, (u32)m_GSPacketsSent,
+				(double)m_GSPacketsQueued / m_GSPacketsSent);
+
+		m_GSPacketStatVsyncs = 0;
+		m_GSPacketsQueued	 = 0;
+		m_GSPacketsSent		 = 0;
+	}
+
 	uint packsize = sizeof(RingCmdPacket_Vsync) / 16;
 	PrepDataPacket(GS_RINGTYPE_VSYNC, packsize);
 	MemCopy_WrappedDest( (u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBufferSize, 0xf );
@@ -398,6 +418,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 				break;
 #endif
 				case GS_RINGTYPE_GSPACKET: {
+					TraceEvents::Scope trace(Timeline::MTGS, "GS packet");
 					Gif_Path& path   = gifUnit.gifPath[tag.data[2]];
 					u32       offset = tag.data[0];
 					u32       size   = tag.data[1];
@@ -407,11 +428,15 @@ void SysMtgsThread::ExecuteTaskInThread()
 				}
 
 				case GS_RINGTYPE_MTVU_GSPACKET: {
+					TraceEvents::Scope trace(Timeline::MTGS, "GS packet (MTVU)");
 					MTVU_LOG("MTGS - Waiting on semaXGkick!");
 					vu1Thread.KickStart(true);
 					busy.PartialRelease();
-					// Wait for MTVU to complete vu1 program
-					vu1Thread.semaXGkick.WaitWithoutYield();
+					{
+						// Wait for MTVU to complete vu1 program
+						TraceEvents::Scope wait(Timeline::MTGS, "Wait for MTVU");
+						vu1Thread.semaXGkick.WaitWithoutYield();
+					}
 					busy.PartialAcquire();
 					Gif_Path& path   = gifUnit.gifPath[GIF_PATH_1];
 					GS_Packet gsPack = path.GetGSPacketMTVU(); // Get vu1 program's xgkick packet(s)
@@ -445,7 +470,10 @@ void SysMtgsThread::ExecuteTaskInThread()
 							((GSRegSIGBLID&)RingBuffer.Regs[0x1080])	= (GSRegSIGBLID&)remainder[2];
 
 							// CSR & 0x2000; is the pageflip id.
-							GSvsync(((u32&)RingBuffer.Regs[0x1000]) & 0x2000);
+							{
+								TraceEvents::Scope trace(Timeline::MTGS, "GSvsync");
+								GSvsync(((u32&)RingBuffer.Regs[0x1000]) & 0x2000);
+							}
 							gsFrameSkip();
 
 							// if we're not using GSOpen2, then the GS window is on this thread (MTGS thread),
@@ -470,6 +498,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 
 						case GS_RINGTYPE_FREEZE:
 						{
+							TraceEvents::Scope trace(Timeline::MTGS, "GS freeze");
 							MTGS_FreezeData* data = (MTGS_FreezeData*)tag.pointer;
 							int mode = tag.data[0];
 							data->retval = GetCorePlugins().DoFreeze( PluginId_GS, mode, data->fdata );
@@ -603,6 +632,9 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 	if( m_ExecMode == ExecMode_NoThreadYet || !IsRunning() ) return;
 	if( !pxAssertDev( IsOpen(), "MTGS Warning!  WaitGS issued on a closed thread." ) ) return;
 
+	// The batch is owned by the EE thread; MTVU only waits on path 1 packets which are never batched.
+	if (!isMTVU) FlushGSPacketBatch();
+
 	Gif_Path&   path = gifUnit.gifPath[GIF_PATH_1];
 	u32 startP1Packs = weakWait ? path.GetPendingGSPackets() : 0;
 
@@ -766,6 +798,8 @@ void SysMtgsThread::GenericStall( uint size )
 
 void SysMtgsThread::PrepDataPacket( MTGS_RingCommand cmd, u32 size )
 {
+	FlushGSPacketBatch();
+
 	m_packet_size = size;
 	++size;			// takes into account our RingCommand QWC.
 	GenericStall(size);
@@ -809,6 +843,8 @@ void SysMtgsThread::SendSimplePacket( MTGS_RingCommand type, int data0, int data
 {
 	//ScopedLock locker( m_PacketLocker );
 
+	FlushGSPacketBatch();
+
 	GenericStall(1);
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_WritePos.load(std::memory_order_relaxed)];
 
@@ -821,8 +857,48 @@ void SysMtgsThread::SendSimplePacket( MTGS_RingCommand type, int data0, int data
 }
 
 void SysMtgsThread::SendSimpleGSPacket(MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path)
+{
+	// Only real packets are merged (not blank/realign packets or MTVU packets), and only
+	// when they directly follow the pending one in the same path buffer. The MTGS then
+	// hands the whole range to GSgifTransfer in one go, which parses the same tags in the
+	// same order as it would have done for the individual packets.
+	if (EmuConfig.GS.CoalescePackets && type == GS_RINGTYPE_GSPACKET && offset != ~0u && !EmuConfig.GS.SynchronousMTGS) {
+		MTGS_GSPacketBatch& batch = m_GSPacketBatch;
+		m_GSPacketsQueued++;
+		if (batch.size && batch.path == path && batch.offset + batch.size == offset
+			&& batch.size + size <= GSPacketBatchMaxSize) {
+			batch.size += size;
+			batch.count++;
+		}
+		else {
+			FlushGSPacketBatch();
+			batch.offset = offset;
+			batch.size   = size;
+			batch.count  = 1;
+			batch.path   = path;
+		}
+		if (batch.size >= GSPacketBatchMaxSize) FlushGSPacketBatch();
+		return;
+	}
+
+	m_GSPacketsQueued += (type == GS_RINGTYPE_GSPACKET);
+	_SendSimpleGSPacket(type, offset, size, path);
+}
+
+// Writes the pending merged GS packet (if any) to the ring buffer.
+void SysMtgsThread::FlushGSPacketBatch()
+{
+	if (!m_GSPacketBatch.size) return;
+
+	MTGS_GSPacketBatch batch = m_GSPacketBatch;
+	m_GSPacketBatch.Reset();
+	_SendSimpleGSPacket(GS_RINGTYPE_GSPACKET, batch.offset, batch.size, batch.path);
+}
+
+void SysMtgsThread::_SendSimpleGSPacket(MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path)
 {
 	SendSimplePacket(type, (int)offset, (int)size, (int)path);
+	m_GSPacketsSent += (type == GS_RINGTYPE_GSPACKET);
 
 	if(!EmuConfig.GS.SynchronousMTGS) {
 		if(!m_RingBufferIsBusy.load(std::memory_order_relaxed)) {
@@ -836,6 +912,8 @@ void SysMtgsThread::SendPointerPacket( MTGS_RingCommand type, u32 data0, void* d
 {
 	//ScopedLock locker( m_PacketLocker );
 
+	FlushGSPacketBatch();
+
 	GenericStall(1);
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_WritePos.load(std::memory_order_relaxed)];
 
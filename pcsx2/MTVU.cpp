@@ -18,6 +18,7 @@
 #include "MTVU.h"
 #include "newVif.h"
 #include "Gif_Unit.h"
+#include "System/Timeline.h"
 
 __aligned16 VU_Thread vu1Thread(CpuVU1, VU1);
 
@@ -103,6 +104,7 @@ void VU_Thread::ExecuteRingBuffer()
 	for(;;) {
 		semaEvent.WaitWithoutYield();
 		ScopedLockBool lock(mtxBusy, isBusy);
+		TraceEvents::Scope trace(Timeline::MTVU, "MTVU ring");
 		while (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos()) {
 			u32 tag = Read();
 			switch (tag) {
@@ -113,7 +115,10 @@ void VU_Thread::ExecuteRingBuffer()
 					vifRegs.itop = Read();
 
 					if (addr != -1) vuRegs.VI[REG_TPC].UL = addr;
-					vuCPU->Execute(vu1RunCycles);
+					{
+						TraceEvents::Scope execute(Timeline::MTVU, "VU1 program");
+						vuCPU->Execute(vu1RunCycles);
+					}
 					gifUnit.gifPath[GIF_PATH_1].FinishGSPacketMTVU();
 					semaXGkick.Post(); // Tell MTGS a path1 packet is complete
 					vuCycles[vuCycleIdx].store(vuRegs.cycle, std::memory_order_release);
@@ -304,6 +309,11 @@ bool VU_Thread::IsDone()
 	return GetReadPos() == GetWritePos();
 }
 
+u32 VU_Thread::GetBacklog()
+{
+	return ((GetWritePos() - GetReadPos()) & (buffer_size - 1)) * sizeof(u32);
+}
+
 void VU_Thread::WaitVU()
 {
 	MTVU_LOG("MTVU - WaitVU!");
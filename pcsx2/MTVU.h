@@ -59,6 +59,9 @@ public:
 	// Used for assertions...
 	bool IsDone();
 
+	// Bytes of packets the VU thread hasn't processed yet (for telemetry)
+	u32 GetBacklog();
+
 	// Waits till MTVU is done processing
 	void WaitVU();
 
@@ -47,9 +47,7 @@ BIOS
 
 #include "Utilities/PageFaultSource.h"
 
-#ifdef ENABLECACHE
 #include "Cache.h"
-#endif
 
 int MemMode = 0;		// 0 is Kernel Mode, 1 is Supervisor Mode, 2 is User Mode
 
@@ -668,6 +666,8 @@ public:
 
 static mmap_PageFaultHandler* mmap_faultHandler = NULL;
 
+static void mmap_MarkAllDirty();
+
 EEVM_MemoryAllocMess* eeMem = NULL;
 __pagealigned u8 eeHw[Ps2MemSize::Hardware];
 
@@ -739,7 +739,7 @@ void eeMemoryReserve::Reset()
 	pxAssume( eeMem );
 
 #ifdef ENABLECACHE
-	memset(pCache,0,sizeof(_cacheS)*64);
+	resetCache();
 #endif
 
 	vtlb_Init();
@@ -847,6 +847,11 @@ void eeMemoryReserve::Reset()
 	vtlb_VMap(0x00000000,0x00000000,0x20000000);
 	vtlb_VMapUnmap(0x20000000,0x60000000);
 
+	mmap_MarkAllDirty();
+
+	if (EmuConfig.Profiler.Enabled && EmuConfig.Profiler.Bench_EECache)
+		cacheBenchmark();
+
 	LoadBIOS();
 }
 
@@ -905,6 +910,109 @@ struct vtlb_PageProtectionInfo
 
 static __aligned16 vtlb_PageProtectionInfo m_PageProtectInfo[Ps2MemSize::MainRam >> 12];
 
+// ===========================================================================================
+//  Dirty Page Tracking
+// ===========================================================================================
+// Piggybacks on the same write protection: a checkpoint makes EE and IOP main memory read-only,
+// and the first write to each page afterwards faults, marks the page dirty and unprotects it
+// (pages that also hold recompiled code are handed to mmap_ClearCpuBlock as usual).  So only
+// the first write to a page per checkpoint pays for a fault, and pages which were never written
+// don't have to be copied by savestate/rewind/rollback code.
+//
+// Memory owned by plugins (SPU2, GS) can't be protected from here, and VU memory is small
+// enough that copying it whole is cheaper than tracking it.
+
+struct DirtyTrackRegionInfo
+{
+	u8*		base;
+	uint	size;
+	u32*	bits;
+};
+
+static bool m_DirtyTracking = false;
+static u32 m_DirtyEERam[(Ps2MemSize::MainRam >> 12) / 32];
+static u32 m_DirtyIOPRam[(Ps2MemSize::IopRam >> 12) / 32];
+static DirtyTrackStats m_DirtyStats;
+// bumped by every checkpoint, never reset (see mmap_GetDirtyGeneration)
+static u64 m_DirtyGeneration = 0;
+
+static DirtyTrackRegionInfo mmap_GetDirtyRegion( DirtyTrackRegion region )
+{
+	DirtyTrackRegionInfo info;
+
+	switch( region )
+	{
+		case DirtyTrack_EERam:
+			info.base = eeMem ? eeMem->Main : NULL;
+			info.size = Ps2MemSize::MainRam;
+			info.bits = m_DirtyEERam;
+		break;
+
+		case DirtyTrack_IOPRam:
+		default:
+			info.base = iopMem ? iopMem->Main : NULL;
+			info.size = Ps2MemSize::IopRam;
+			info.bits = m_DirtyIOPRam;
+		break;
+	}
+
+	return info;
+}
+
+static __fi bool mmap_TestDirtyBit( const u32* bits, uint page )
+{
+	return (bits[page >> 5] >> (page & 31)) & 1;
+}
+
+// Makes every clean page of the region read-only, or read/write once tracking stops.  Pages of
+// EE ram under write protection for recompiled code are left alone in the latter case.
+static void mmap_ProtectCleanPages( DirtyTrackRegion region, bool writable )
+{
+	DirtyTrackRegionInfo info = mmap_GetDirtyRegion( region );
+	if( !info.base ) return;
+
+	const PageProtectionMode mode = writable ? PageAccess_ReadWrite() : PageAccess_ReadOnly();
+	const uint pages = info.size >> 12;
+	uint run = 0;
+
+	for( uint page = 0; page <= pages; ++page )
+	{
+		bool apply = (page < pages) && !mmap_TestDirtyBit( info.bits, page );
+		if( apply && writable && region == DirtyTrack_EERam )
+			apply = m_PageProtectInfo[page].Mode != ProtMode_Write;
+
+		if( apply )
+		{
+			++run;
+			continue;
+		}
+
+		if( run ) HostSys::MemProtect( &info.base[(page - run) << 12], run << 12, mode );
+		run = 0;
+	}
+}
+
+// Returns true if the fault was caused by dirty tracking alone and has been dealt with.
+static bool mmap_DirtyFault( DirtyTrackRegion region, uptr addr )
+{
+	DirtyTrackRegionInfo info = mmap_GetDirtyRegion( region );
+	uptr offset = addr - (uptr)info.base;
+	if( !info.base || offset >= info.size ) return false;
+
+	u64 start = GetCPUTicks();
+	uint page = offset >> 12;
+
+	info.bits[page >> 5] |= 1u << (page & 31);
+
+	bool handled = (region != DirtyTrack_EERam) || (m_PageProtectInfo[page].Mode != ProtMode_Write);
+	if( handled ) HostSys::MemProtect( &info.base[page << 12], __pagesize, PageAccess_ReadWrite() );
+
+	++m_DirtyStats.Faults;
+	m_DirtyStats.FaultTicks += GetCPUTicks() - start;
+
+	return handled;
+}
+
 
 // returns:
 //  ProtMode_NotRequired - unchecked block (resides in ROM, thus is integrity is constant)
@@ -979,9 +1087,16 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 
 	// get bad virtual address
 	uptr offset = info.addr - (uptr)eeMem->Main;
-	if( offset >= Ps2MemSize::MainRam ) return;
+	if( offset >= Ps2MemSize::MainRam )
+	{
+		if( m_DirtyTracking && mmap_DirtyFault( DirtyTrack_IOPRam, info.addr ) )
+			handled = true;
+		return;
+	}
+
+	if( !m_DirtyTracking || !mmap_DirtyFault( DirtyTrack_EERam, info.addr ) )
+		mmap_ClearCpuBlock( offset );
 
-	mmap_ClearCpuBlock( offset );
 	handled = true;
 }
 
@@ -994,4 +1109,88 @@ void mmap_ResetBlockTracking()
 	//DbgCon.WriteLn( "vtlb/mmap: Block Tracking reset..." );
 	memzero( m_PageProtectInfo );
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
+	if (m_DirtyTracking) mmap_ProtectCleanPages( DirtyTrack_EERam, false );
+}
+
+void mmap_SetDirtyTracking( bool enable )
+{
+	if( enable == m_DirtyTracking ) return;
+
+	if( enable )
+	{
+		memzero( m_DirtyStats );
+
+		m_DirtyTracking = true;
+		mmap_DirtyCheckpoint();
+	}
+	else
+	{
+		m_DirtyTracking = false;
+		memzero( m_DirtyEERam );
+		memzero( m_DirtyIOPRam );
+		mmap_ProtectCleanPages( DirtyTrack_EERam, true );
+		mmap_ProtectCleanPages( DirtyTrack_IOPRam, true );
+	}
+}
+
+bool mmap_IsDirtyTracking()
+{
+	return m_DirtyTracking;
+}
+
+// Starts a new generation: all pages are clean, and protected again until they're written.
+void mmap_DirtyCheckpoint()
+{
+	if( !m_DirtyTracking ) return;
+
+	memzero( m_DirtyEERam );
+	memzero( m_DirtyIOPRam );
+	mmap_ProtectCleanPages( DirtyTrack_EERam, false );
+	mmap_ProtectCleanPages( DirtyTrack_IOPRam, false );
+
+	++m_DirtyGeneration;
+}
+
+// A copy made right before the checkpoint of the current generation can be brought up to date
+// with mmap_CopyDirtyPages.  Any other checkpoint in between (including the one made when
+// tracking is enabled) means the dirty bits don't cover everything that changed since.
+u64 mmap_GetDirtyGeneration()
+{
+	return m_DirtyGeneration;
+}
+
+// Resetting the VM remaps its memory, which drops both the contents and the protection, so
+// everything counts as modified until the next checkpoint.
+static void mmap_MarkAllDirty()
+{
+	if( !m_DirtyTracking ) return;
+
+	memset( m_DirtyEERam, 0xff, sizeof(m_DirtyEERam) );
+	memset( m_DirtyIOPRam, 0xff, sizeof(m_DirtyIOPRam) );
+}
+
+// Copies the pages modified since the last checkpoint to dest, which holds a full copy of the
+// region taken at that checkpoint.  Returns the number of pages copied.
+uint mmap_CopyDirtyPages( DirtyTrackRegion region, u8* dest )
+{
+	DirtyTrackRegionInfo info = mmap_GetDirtyRegion( region );
+	if( !info.base ) return 0;
+
+	const uint pages = info.size >> 12;
+	uint copied = 0;
+
+	for( uint page = 0; page < pages; ++page )
+	{
+		if( m_DirtyTracking && !mmap_TestDirtyBit( info.bits, page ) ) continue;
+
+		memcpy( &dest[page << 12], &info.base[page << 12], __pagesize );
+		++copied;
+	}
+
+	return copied;
+}
+
+const DirtyTrackStats& mmap_GetDirtyTrackStats()
+{
+	return m_DirtyStats;
 }
@@ -128,6 +128,29 @@ extern vtlb_ProtectionMode mmap_GetRamPageInfo( u32 paddr );
 extern void mmap_MarkCountedRamPage( u32 paddr );
 extern void mmap_ResetBlockTracking();
 
+// Dirty page tracking: records which pages of PS2 main memory were written since the last
+// checkpoint, so that savestates only need to copy those (see EmuConfig.IncrementalSavestates).
+enum DirtyTrackRegion
+{
+	DirtyTrack_EERam = 0,
+	DirtyTrack_IOPRam,
+
+	DirtyTrack_RegionCount
+};
+
+struct DirtyTrackStats
+{
+	u64 Faults;				// write faults taken for dirty tracking since tracking was enabled
+	u64 FaultTicks;			// time spent handling them, in GetCPUTicks units
+};
+
+extern void mmap_SetDirtyTracking( bool enable );
+extern bool mmap_IsDirtyTracking();
+extern void mmap_DirtyCheckpoint();
+extern u64 mmap_GetDirtyGeneration();
+extern uint mmap_CopyDirtyPages( DirtyTrackRegion region, u8* dest );
+extern const DirtyTrackStats& mmap_GetDirtyTrackStats();
+
 #define memRead8 vtlb_memRead<mem8_t>
 #define memRead16 vtlb_memRead<mem16_t>
 #define memRead32 vtlb_memRead<mem32_t>
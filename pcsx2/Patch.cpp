@@ -21,6 +21,7 @@
 #include "Patch.h"
 #include "GameDatabase.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <wx/textfile.h>
@@ -33,9 +34,17 @@
 // Applies a single patch line to emulation memory regardless of its "place" value.
 extern void _ApplyPatch(IniPatch *p);
 
+// Also declared here only: compile the loaded patches into per-place op lists, and apply
+// the compiled list of a place (see Patch_Memory.cpp).
+extern void _CompilePatches(const std::vector<IniPatch>& patches);
+extern void _ApplyCompiledPatches(patch_place_type place);
+
 
 std::vector<IniPatch> Patch;
 
+// Cleared whenever Patch changes, the patches are recompiled on the next apply
+static bool patchesCompiled = false;
+
 wxString strgametitle;
 
 struct PatchTextTable
@@ -175,6 +184,7 @@ void inifile_process(wxTextFile &f1 )
 void ForgetLoadedPatches()
 {
 	Patch.clear();
+	patchesCompiled = false;
 }
 
 static int _LoadPatchFiles(const wxDirName& folderName, wxString& fileSpec, const wxString& friendlyName, int& numberFoundPatchFiles)
@@ -340,6 +350,7 @@ namespace PatchFunc
 
 			iPatch.enabled = 1; // omg success!!
 			Patch.push_back(iPatch);
+			patchesCompiled = false;
 
 		}
 		catch( wxString& exmsg )
@@ -351,12 +362,41 @@ namespace PatchFunc
 	void patch(const wxString& cmd, const wxString& param) { patchHelper(cmd, param); }
 }
 
+// Measures the cost of the continuous patches when the profiler is enabled, reported
+// every 10 seconds worth of vsyncs.
+static void ApplyLoadedPatchesStats(u64 ticks)
+{
+	static u64 totalTicks = 0, maxTicks = 0;
+	static uint vsyncs = 0;
+
+	totalTicks += ticks;
+	maxTicks = std::max(maxTicks, ticks);
+	if (++vsyncs < 600) return;
+
+	const double usPerTick = 1000000.0 / GetTickFrequency();
+	DevCon.WriteLn("(Patch) %u patches: %.2f us per vsync on average, %.2f us max",
+		(uint)Patch.size(), totalTicks * usPerTick / vsyncs, maxTicks * usPerTick);
+
+	totalTicks = maxTicks = 0;
+	vsyncs = 0;
+}
+
 // This is for applying patches directly to memory
 void ApplyLoadedPatches(patch_place_type place)
 {
-	for (auto& i : Patch)
+	if (!patchesCompiled)
+	{
+		_CompilePatches(Patch);
+		patchesCompiled = true;
+	}
+
+	if (place != PPT_CONTINUOUSLY || !EmuConfig.Profiler.Enabled || Patch.empty())
 	{
-		if (i.placetopatch == place)
-			_ApplyPatch(&i);
+		_ApplyCompiledPatches(place);
+		return;
 	}
+
+	u64 start = GetCPUTicks();
+	_ApplyCompiledPatches(place);
+	ApplyLoadedPatchesStats(GetCPUTicks() - start);
 }
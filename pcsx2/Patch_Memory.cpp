@@ -19,6 +19,11 @@
 
 #include "IopCommon.h"
 #include "Patch.h"
+#include "vtlb.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
 
 u32 SkipCount = 0, IterationCount = 0;
 u32 IterationIncrement = 0, ValueIncrement = 0;
@@ -449,3 +454,297 @@ void _ApplyPatch(IniPatch *p)
 		break;
 	}
 }
+
+// Applies a batch of consecutive extended lines.  A conditional code which fails skips the
+// lines it guards in one step, rather than dispatching each of them only to count it down.
+static void _ApplyExtendedBatch(IniPatch *p, u32 count)
+{
+	for (u32 i = 0; i < count; i++)
+	{
+		if (SkipCount > 0)
+		{
+			u32 skip = std::min(SkipCount, count - i);
+			SkipCount -= skip;
+			i += skip - 1;
+			continue;
+		}
+
+		handle_extended_t(&p[i]);
+	}
+}
+
+// --------------------------------------------------------------------------------------
+//  Compiled patches
+// --------------------------------------------------------------------------------------
+// The place=1 patches are applied on every vsync, so the loaded patch lines are compiled
+// once into a flat list of ops for each place:
+//  - consecutive aligned EE writes are merged into runs of contiguous bytes within a page,
+//    which are compared and copied as a block when the page is plain memory;
+//  - consecutive extended lines form a batch (see _ApplyExtendedBatch);
+//  - everything else (IOP patches, unaligned EE writes) is applied line by line.
+// The lines behind each op are kept in load order, so runs on pages which aren't plain
+// memory are applied exactly as before.
+
+enum PatchOpType
+{
+	PatchOp_Lines,
+	PatchOp_Run,
+	PatchOp_Extended
+};
+
+struct PatchOp
+{
+	PatchOpType type;
+	u32 addr;		// runs: EE address of the first byte
+	u32 offset;		// runs: position of the bytes in PatchProgram::bytes
+	u32 size;		// runs: number of bytes
+	u32 first;		// first line in PatchProgram::lines
+	u32 count;		// number of lines
+};
+
+struct PatchProgram
+{
+	std::vector<PatchOp> ops;
+	std::vector<IniPatch> lines;
+	std::vector<u8> bytes;
+};
+
+static PatchProgram patchPrograms[_PPT_END_MARKER];
+
+static uint _PatchWriteSize(patch_data_type type)
+{
+	switch (type)
+	{
+	case BYTE_T:	return 1;
+	case SHORT_T:	return 2;
+	case WORD_T:	return 4;
+	case DOUBLE_T:	return 8;
+	default:		return 0;
+	}
+}
+
+static bool _IsMergeable(const IniPatch& p)
+{
+	uint size = _PatchWriteSize(p.type);
+	return p.cpu == CPU_EE && size && (p.addr % size) == 0;
+}
+
+static void _AddLines(PatchProgram& prog, PatchOpType type, const IniPatch& p)
+{
+	if (prog.ops.empty() || prog.ops.back().type != type)
+	{
+		PatchOp op = { type, 0, 0, 0, (u32)prog.lines.size(), 0 };
+		prog.ops.push_back(op);
+	}
+
+	prog.ops.back().count++;
+	prog.lines.push_back(p);
+}
+
+// Folds the segment bits away, so the addresses one byte of RAM can be reached through
+// (kuseg and its uncached mirrors, kseg0, kseg1) compare equal.  This is used instead of the
+// current TLB mapping, which can change after the patches are compiled; unrelated addresses
+// which fold together only cost an extra run.
+static u32 _PatchAliasKey(u32 addr)
+{
+	return addr & 0x0FFFFFFF;
+}
+
+// Merges a group of writes in which no byte is reached through two different addresses.
+// The writes are laid out in load order so later lines win where they overlap, as they
+// would when applied one after the other.
+static void _EmitRuns(PatchProgram& prog, const IniPatch* writes, size_t count)
+{
+	using namespace vtlb_private;
+
+	std::map<u32, u8> image;
+	for (size_t w = 0; w < count; w++)
+	{
+		const IniPatch& p = writes[w];
+		uint size = _PatchWriteSize(p.type);
+		for (uint i = 0; i < size; i++)
+			image[p.addr + i] = (u8)(p.data >> (i * 8));
+	}
+
+	const size_t firstRun = prog.ops.size();
+	for (const auto& byte : image)
+	{
+		PatchOp* run = (prog.ops.size() > firstRun) ? &prog.ops.back() : NULL;
+
+		if (!run || byte.first != run->addr + run->size || (byte.first & VTLB_PAGE_MASK) == 0)
+		{
+			PatchOp op = { PatchOp_Run, byte.first, (u32)prog.bytes.size(), 0, 0, 0 };
+			prog.ops.push_back(op);
+			run = &prog.ops.back();
+		}
+
+		prog.bytes.push_back(byte.second);
+		run->size++;
+	}
+
+	// Aligned writes never straddle a page, so each line belongs to exactly one run
+	for (size_t i = firstRun; i < prog.ops.size(); i++)
+	{
+		PatchOp& run = prog.ops[i];
+		run.first = prog.lines.size();
+
+		for (size_t w = 0; w < count; w++)
+		{
+			const IniPatch& p = writes[w];
+			if (p.addr >= run.addr && p.addr < run.addr + run.size)
+				prog.lines.push_back(p);
+		}
+
+		run.count = prog.lines.size() - run.first;
+	}
+}
+
+// Merges a sequence of writes with no other lines in between into runs.  Runs are applied
+// in address order, so a line which writes a byte an earlier line reached through another
+// address (converted cheats often mix 0x00xxxxxx and 0x20xxxxxx) starts a new group, which
+// keeps the load order between the two.
+static void _FlushWrites(PatchProgram& prog, std::vector<IniPatch>& writes)
+{
+	if (writes.empty()) return;
+
+	std::map<u32, u32> written;		// alias key -> address it was written through
+	size_t first = 0;
+
+	for (size_t w = 0; w < writes.size(); w++)
+	{
+		const IniPatch& p = writes[w];
+		uint size = _PatchWriteSize(p.type);
+
+		bool aliased = false;
+		for (uint i = 0; i < size && !aliased; i++)
+		{
+			auto it = written.find(_PatchAliasKey(p.addr + i));
+			aliased = (it != written.end() && it->second != p.addr + i);
+		}
+
+		if (aliased)
+		{
+			_EmitRuns(prog, &writes[first], w - first);
+			written.clear();
+			first = w;
+		}
+
+		for (uint i = 0; i < size; i++)
+			written[_PatchAliasKey(p.addr + i)] = p.addr + i;
+	}
+
+	_EmitRuns(prog, &writes[first], writes.size() - first);
+	writes.clear();
+}
+
+#ifdef PCSX2_DEVBUILD
+// Checks that the runs of a place leave memory as applying its writes line by line would.
+// Memory is simulated by alias key, so a write through a mirror lands on the same byte.
+static void _VerifyRuns(const PatchProgram& prog, const std::vector<IniPatch>& patches, int place)
+{
+	std::map<u32, u8> lines, runs;
+
+	for (const IniPatch& p : patches)
+	{
+		if (!p.enabled || p.placetopatch != place || !_IsMergeable(p)) continue;
+
+		uint size = _PatchWriteSize(p.type);
+		for (uint i = 0; i < size; i++)
+			lines[_PatchAliasKey(p.addr + i)] = (u8)(p.data >> (i * 8));
+	}
+
+	for (const PatchOp& op : prog.ops)
+	{
+		if (op.type != PatchOp_Run) continue;
+
+		for (u32 i = 0; i < op.size; i++)
+			runs[_PatchAliasKey(op.addr + i)] = prog.bytes[op.offset + i];
+	}
+
+	pxAssertMsg(lines == runs, "(Patch) Compiled runs don't match the patch lines");
+}
+#endif
+
+static void _CompilePlace(PatchProgram& prog, const std::vector<IniPatch>& patches, int place)
+{
+	prog = PatchProgram();
+
+	std::vector<IniPatch> writes;
+	for (const IniPatch& p : patches)
+	{
+		if (!p.enabled || p.placetopatch != place) continue;
+
+		if (_IsMergeable(p))
+		{
+			writes.push_back(p);
+			continue;
+		}
+
+		_FlushWrites(prog, writes);
+
+		if (p.cpu == CPU_EE && p.type == EXTENDED_T)
+			_AddLines(prog, PatchOp_Extended, p);
+		else
+			_AddLines(prog, PatchOp_Lines, p);
+	}
+
+	_FlushWrites(prog, writes);
+}
+
+// Only used from Patch.cpp, see _ApplyPatch.
+void _CompilePatches(const std::vector<IniPatch>& patches)
+{
+	for (int place = 0; place < _PPT_END_MARKER; place++)
+	{
+		PatchProgram& prog = patchPrograms[place];
+		_CompilePlace(prog, patches, place);
+#ifdef PCSX2_DEVBUILD
+		_VerifyRuns(prog, patches, place);
+#endif
+
+		if (prog.lines.empty()) continue;
+
+		uint runs = 0;
+		for (const PatchOp& op : prog.ops)
+			if (op.type == PatchOp_Run) runs++;
+
+		DevCon.WriteLn("(Patch) Place %d: %u lines compiled into %u ops (%u runs, %u bytes)",
+			place, (uint)prog.lines.size(), (uint)prog.ops.size(), runs, (uint)prog.bytes.size());
+	}
+}
+
+// Only used from Patch.cpp, see _ApplyPatch.
+void _ApplyCompiledPatches(patch_place_type place)
+{
+	PatchProgram& prog = patchPrograms[place];
+
+	for (const PatchOp& op : prog.ops)
+	{
+		IniPatch* lines = &prog.lines[op.first];
+
+		switch (op.type)
+		{
+		case PatchOp_Run:
+			if (u8* mem = (u8*)vtlb_GetVirtPtr(op.addr))
+			{
+				const u8* data = &prog.bytes[op.offset];
+				if (memcmp(mem, data, op.size) != 0)
+					memcpy(mem, data, op.size);
+				break;
+			}
+			// Not plain memory, apply the lines through the handlers instead
+			for (u32 i = 0; i < op.count; i++)
+				_ApplyPatch(&lines[i]);
+			break;
+
+		case PatchOp_Lines:
+			for (u32 i = 0; i < op.count; i++)
+				_ApplyPatch(&lines[i]);
+			break;
+
+		case PatchOp_Extended:
+			_ApplyExtendedBatch(lines, op.count);
+			break;
+		}
+	}
+}
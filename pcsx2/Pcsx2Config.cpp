@@ -76,6 +76,19 @@ void Pcsx2Config::ProfilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( RecBlocks_IOP );
 	IniBitBool( RecBlocks_VU0 );
 	IniBitBool( RecBlocks_VU1 );
+	IniBitBool( TraceEvents );
+	IniBitBool( Bench_VifUnpack );
+	IniBitBool( Bench_EECache );
+	IniBitBool( Bench_FolderMcd );
+}
+
+void Pcsx2Config::IopHleOptions::LoadSave( IniInterface& ini )
+{
+	ScopedIniGroup path( ini, L"IopHle" );
+
+	IniBitBool( FastPaths );
+	IniBitBool( CheckFastPaths );
+	IniEntry( DisabledFastPaths );
 }
 
 Pcsx2Config::RecompilerOptions::RecompilerOptions()
@@ -165,6 +178,8 @@ void Pcsx2Config::RecompilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( StackFrameChecks );
 	IniBitBool( PreBlockCheckEE );
 	IniBitBool( PreBlockCheckIOP );
+
+	IniBitBool( PersistVifUnpack );
 }
 
 Pcsx2Config::CpuOptions::CpuOptions()
@@ -204,6 +219,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	VsyncEnable				= VsyncMode::Off;
 
 	SynchronousMTGS			= false;
+	CoalescePackets			= true;
 	VsyncQueueSize			= 2;
 
 	FramesToDraw			= 2;
@@ -219,6 +235,7 @@ void Pcsx2Config::GSOptions::LoadSave( IniInterface& ini )
 	ScopedIniGroup path( ini, L"GS" );
 
 	IniEntry( SynchronousMTGS );
+	IniEntry( CoalescePackets );
 	IniEntry( VsyncQueueSize );
 
 	IniEntry( FrameLimitEnable );
@@ -425,8 +442,19 @@ Pcsx2Config::Pcsx2Config()
 	McdFolderAutoManage = true;
 	EnablePatches = true;
 	BackupSavestate = true;
+
+	CdvdTiming = CdvdTimingMode::Legacy;
+	CdvdFastScale = 4;
 }
 
+static const wxChar* const tbl_CdvdTimingNames[] =
+{
+	L"Legacy",
+	L"Disc",
+	L"Fast",
+	NULL
+};
+
 void Pcsx2Config::LoadSave( IniInterface& ini )
 {
 	ScopedIniGroup path( ini, L"EmuCore" );
@@ -442,13 +470,18 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 #endif
 	IniBitBool( ConsoleToStdio );
 	IniBitBool( HostFs );
+	IniBitBool( EnableTelemetry );
 
 	IniBitBool( BackupSavestate );
+	IniBitBool( IncrementalSavestates );
 	IniBitBool( McdEnableEjection );
 	IniBitBool( McdFolderAutoManage );
 	IniBitBool( MultitapPort0_Enabled );
 	IniBitBool( MultitapPort1_Enabled );
 
+	ini.EnumEntry( L"CdvdTiming", CdvdTiming, tbl_CdvdTimingNames, CdvdTiming );
+	IniEntry( CdvdFastScale );
+
 	// Process various sub-components:
 
 	Speedhacks		.LoadSave( ini );
@@ -456,6 +489,7 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 	GS				.LoadSave( ini );
 	Gamefixes		.LoadSave( ini );
 	Profiler		.LoadSave( ini );
+	IopHle			.LoadSave( ini );
 
 	Debugger		.LoadSave( ini );
 	Trace			.LoadSave( ini );
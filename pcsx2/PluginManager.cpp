@@ -153,6 +153,7 @@ static void CALLBACK fallback_setLogDir(const char* dir) {}
 static void CALLBACK fallback_configure() {}
 static void CALLBACK fallback_about() {}
 static s32  CALLBACK fallback_test() { return 0; }
+static void* CALLBACK fallback_traceRegistry() { return NULL; }
 
 #ifndef BUILTIN_GS_PLUGIN
 _GSvsync           GSvsync;
@@ -372,6 +373,8 @@ static const LegacyApi_CommonMethod s_MethMessCommon[] =
 	{	"configure",		fallback_configure	},
 	{	"about",			fallback_about	},
 
+	{	"traceRegistry",	(vMeth*)fallback_traceRegistry },
+
 	{ NULL }
 
 };
@@ -1750,6 +1753,12 @@ void SysCorePlugins::SetLogFolder( const wxString& folder )
 	m_LogFolder = fixedfolder;
 }
 
+wxString SysCorePlugins::GetLogFolder()
+{
+	ScopedLock lock( m_mtx_PluginStatus );
+	return m_LogFolder;
+}
+
 void SysCorePlugins::Configure( PluginsEnum_t pid )
 {
 	ScopedLock lock( m_mtx_PluginStatus );
@@ -1889,3 +1898,13 @@ const wxString SysCorePlugins::GetVersion( PluginsEnum_t pid ) const
 	pxAssert( (uint)pid < PluginId_Count );
 	return m_info[pid] ? m_info[pid]->Version : L"0.0";
 }
+
+// Returns NULL for plugins which don't record timeline markers, and for the built-in ones,
+// which share the emulator's registry.  The registry goes away with the plugin, so callers
+// should hold the plugin mutex while using it.
+TraceEvents::Registry* SysCorePlugins::GetTraceRegistry( PluginsEnum_t pid ) const
+{
+	ScopedLock lock( m_mtx_PluginStatus );
+	pxAssert( (uint)pid < PluginId_Count );
+	return m_info[pid] ? (TraceEvents::Registry*)m_info[pid]->CommonBindings.TraceRegistry() : NULL;
+}
@@ -207,6 +207,9 @@ struct LegacyPluginAPI_Common
 	void (CALLBACK* Configure)();
 	void (CALLBACK* About)();
 
+	// Optional: the plugin's TraceEvents::Registry, for plugins which record timeline markers.
+	void* (CALLBACK* TraceRegistry)();
+
 	LegacyPluginAPI_Common()
 	{
 		memzero( *this );
@@ -216,6 +219,8 @@ struct LegacyPluginAPI_Common
 class SaveStateBase;
 class SysMtgsThread;
 
+namespace TraceEvents { class Registry; }
+
 // --------------------------------------------------------------------------------------
 //  PluginBindings
 // --------------------------------------------------------------------------------------
@@ -383,6 +388,7 @@ public:
 	virtual void Configure( PluginsEnum_t pid );
 	virtual void SetSettingsFolder( const wxString& folder );
 	virtual void SetLogFolder( const wxString& folder );
+	wxString GetLogFolder();
 	virtual void SendSettingsFolder();
 	virtual void SendLogFolder();
 
@@ -390,6 +396,8 @@ public:
 	const wxString GetName( PluginsEnum_t pid ) const;
 	const wxString GetVersion( PluginsEnum_t pid ) const;
 
+	TraceEvents::Registry* GetTraceRegistry( PluginsEnum_t pid ) const;
+
 protected:
 	virtual bool NeedsClose() const;
 	virtual bool NeedsOpen() const;
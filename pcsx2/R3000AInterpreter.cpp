@@ -25,6 +25,7 @@ bool iopIsDelaySlot = false;
 
 static bool branch2 = 0;
 static u32 branchPC;
+static bool leafMode = false;
 
 static void doBranch(s32 tar);	// forward declared prototype
 
@@ -163,7 +164,25 @@ static void doBranch(s32 tar) {
 	iopIsDelaySlot = false;
 	psxRegs.pc = branchPC;
 
-	iopEventTest();
+	if (!leafMode)
+		iopEventTest();
+}
+
+// Runs the IOP code at psxRegs.pc until it jumps to retpc, without testing for events.
+// Meant for leaf functions which don't depend on interrupts, such as the library calls
+// replaced by the IRX fast paths.  Returns false if retpc isn't reached in time.
+bool psxRunLeaf(u32 retpc, uint maxInstructions)
+{
+	const bool oldBranch2 = branch2;
+	leafMode = true;
+
+	for (uint i = 0; i < maxInstructions && psxRegs.pc != retpc; i++)
+		execI();
+
+	leafMode = false;
+	branch2 = oldBranch2;
+
+	return psxRegs.pc == retpc;
 }
 
 static void intReserve() {
@@ -23,6 +23,8 @@
 
 #include "InputRecordingFile.h"
 
+#include <algorithm>
+
 #ifndef DISABLE_RECORDING
 long InputRecordingFile::GetBlockSeekPoint(const long & frame)
 {
@@ -58,6 +60,15 @@ bool InputRecordingFile::Open(const wxString path, bool fNewOpen, bool fromSaveS
 	}
 	filename = path;
 
+	if (!LoadFrames())
+	{
+		recordingConLog(wxString::Format("[REC]: Movie file reading failed. Error - %s\n", strerror(errno)));
+		fclose(recordingFile);
+		recordingFile = NULL;
+		filename = "";
+		return false;
+	}
+
 	if (fNewOpen)
 	{
 		if (fromSaveState)
@@ -86,11 +97,14 @@ bool InputRecordingFile::Close()
 	{
 		return false;
 	}
+	Flush();
 	WriteHeader();
 	WriteSaveState();
 	fclose(recordingFile);
 	recordingFile = NULL;
 	filename = "";
+	chunks.clear();
+	frameCount = 0;
 	return true;
 }
 
@@ -110,44 +124,281 @@ bool InputRecordingFile::WriteSaveState() {
 	return true;
 }
 
-// Write controller input buffer to file (per frame)
-bool InputRecordingFile::WriteKeyBuf(const uint & frame, const uint port, const uint bufIndex, const u8 & buf)
+size_t InputRecordingFile::FindChunk(unsigned long frame) const
 {
-	if (recordingFile == NULL)
+	// Last chunk starting at or before the frame, which skips chunks emptied by deletes
+	auto it = std::upper_bound(chunks.begin(), chunks.end(), frame,
+		[](unsigned long f, const FrameChunk& chunk) { return f < chunk.firstFrame; });
+	return (it - chunks.begin()) - 1;
+}
+
+u8* InputRecordingFile::GetBlock(unsigned long frame)
+{
+	if (frame >= frameCount)
+	{
+		return NULL;
+	}
+	FrameChunk& chunk = chunks[FindChunk(frame)];
+	return &chunk.blocks[(frame - chunk.firstFrame) * RecordingBlockSize];
+}
+
+long InputRecordingFile::GetChunkSeekPoint(const FrameChunk& chunk, unsigned long frame)
+{
+	if (fileVersion == RecordingVersionFlat)
+	{
+		return GetBlockSeekPoint(chunk.firstFrame + frame);
+	}
+	return GetBlockSeekPoint(0) + (long)chunk.slot * RecordingSlotSize
+		+ (long)sizeof(RecordingSlotHeader) + frame * RecordingBlockSize;
+}
+
+// Appends empty frames up to and including the given one
+void InputRecordingFile::ExtendTo(unsigned long frame)
+{
+	while (frameCount <= frame)
+	{
+		if (chunks.empty() || chunks.back().GetFrameCount() >= RecordingChunkFrames)
+		{
+			if (!chunks.empty())
+			{
+				chunks.back().slotDirty = true;
+			}
+			chunks.emplace_back();
+			chunks.back().firstFrame = frameCount;
+			chunks.back().slot = slotCount++;
+		}
+		FrameChunk& chunk = chunks.back();
+		unsigned long count = std::min(RecordingChunkFrames - chunk.GetFrameCount(), frame + 1 - frameCount);
+		chunk.blocks.resize(chunk.blocks.size() + count * RecordingBlockSize, 0);
+		chunk.slotDirty = true;
+		frameCount += count;
+	}
+}
+
+// Moves the frames past RecordingChunkFrames of a full chunk into a new chunk with a slot of its own
+void InputRecordingFile::SplitChunk(size_t index)
+{
+	FrameChunk tail;
+	FrameChunk& chunk = chunks[index];
+	tail.firstFrame = chunk.firstFrame + RecordingChunkFrames;
+	tail.blocks.assign(chunk.blocks.begin() + RecordingChunkFrames * RecordingBlockSize, chunk.blocks.end());
+	tail.slot = slotCount++;
+	tail.dirtyTo = tail.GetFrameCount();
+	tail.slotDirty = true;
+	chunk.blocks.resize(RecordingChunkFrames * RecordingBlockSize);
+	chunk.dirtyTo = std::min(chunk.dirtyTo, chunk.GetFrameCount());
+	chunk.dirtyFrom = std::min(chunk.dirtyFrom, chunk.dirtyTo);
+	chunk.slotDirty = true;
+	chunks.insert(chunks.begin() + index + 1, std::move(tail));
+}
+
+void InputRecordingFile::MarkDirty(size_t index, unsigned long from, unsigned long to)
+{
+	FrameChunk& chunk = chunks[index];
+	if (chunk.dirtyFrom < chunk.dirtyTo)
+	{
+		from = std::min(chunk.dirtyFrom, from);
+		to = std::max(chunk.dirtyTo, to);
+	}
+	chunk.dirtyFrom = from;
+	chunk.dirtyTo = to;
+}
+
+// Marks the frames of a chunk from the given one on as moved.  Version 1 files have no slots,
+// so the frames of every later chunk move in the file as well.
+void InputRecordingFile::MarkShifted(size_t index, unsigned long from)
+{
+	MarkDirty(index, from, chunks[index].GetFrameCount());
+	chunks[index].slotDirty = true;
+	if (fileVersion == RecordingVersionFlat)
+	{
+		for (size_t i = index + 1; i < chunks.size(); i++)
+		{
+			MarkDirty(i, 0, chunks[i].GetFrameCount());
+		}
+	}
+}
+
+// Reads all frames of an existing recording into memory
+bool InputRecordingFile::LoadFrames()
+{
+	chunks.clear();
+	frameCount = 0;
+	slotCount = 0;
+	headerDirty = false;
+	lastFlushFrame = 0;
+
+	if (fseek(recordingFile, 0, SEEK_END) != 0)
 	{
 		return false;
 	}
+	long fileSize = ftell(recordingFile);
+	long size = fileSize - GetBlockSeekPoint(0);
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
+	// New files take the version of the header they are created with
+	fileVersion = header.version;
+	if (fileSize > 0)
+	{
+		rewind(recordingFile);
+		if (fread(&fileVersion, 1, 1, recordingFile) != 1)
+		{
+			return false;
+		}
+	}
 
-	if (fseek(recordingFile, seek, SEEK_SET) != 0
-		|| fwrite(&buf, 1, 1, recordingFile) != 1)
+	if (size > 0)
+	{
+		if (fileVersion != RecordingVersionFlat)
+		{
+			if (!LoadSlots(size))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			ExtendTo((size + RecordingBlockSize - 1) / RecordingBlockSize - 1);
+
+			fseek(recordingFile, GetBlockSeekPoint(0), SEEK_SET);
+			for (FrameChunk& chunk : chunks)
+			{
+				// The last block may be incomplete, in which case it stays zero padded
+				if (fread(chunk.blocks.data(), 1, chunk.blocks.size(), recordingFile) != chunk.blocks.size())
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	for (FrameChunk& chunk : chunks)
+	{
+		chunk.dirtyFrom = chunk.dirtyTo = 0;
+		chunk.slotDirty = false;
+	}
+	return true;
+}
+
+// Follows the slot chain of a version 2 file, starting with slot 0
+bool InputRecordingFile::LoadSlots(long size)
+{
+	u32 fileSlots = (size + RecordingSlotSize - 1) / RecordingSlotSize;
+	slotCount = fileSlots;
+
+	u32 slot = 0;
+	// Bounded by the slot count so that a damaged chain can't loop forever
+	for (u32 i = 0; i < fileSlots && slot < fileSlots; i++)
+	{
+		RecordingSlotHeader slotHeader;
+		if (fseek(recordingFile, GetBlockSeekPoint(0) + (long)slot * RecordingSlotSize, SEEK_SET) != 0
+			|| fread(&slotHeader, sizeof(slotHeader), 1, recordingFile) != 1
+			|| slotHeader.frameCount > RecordingSlotFrames)
+		{
+			return false;
+		}
+
+		chunks.emplace_back();
+		FrameChunk& chunk = chunks.back();
+		chunk.firstFrame = frameCount;
+		chunk.slot = slot;
+		chunk.blocks.resize(slotHeader.frameCount * RecordingBlockSize, 0);
+		// The last block may be incomplete, in which case it stays zero padded
+		fread(chunk.blocks.data(), 1, chunk.blocks.size(), recordingFile);
+		frameCount += slotHeader.frameCount;
+
+		if (slotHeader.nextSlot == RecordingSlotEnd)
+		{
+			break;
+		}
+		slot = slotHeader.nextSlot;
+	}
+	return true;
+}
+
+// Writes changed frames, slot headers and header fields back to the file
+bool InputRecordingFile::Flush()
+{
+	if (recordingFile == NULL)
 	{
 		return false;
 	}
 
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		FrameChunk& chunk = chunks[i];
+		unsigned long to = std::min(chunk.dirtyTo, chunk.GetFrameCount());
+		if (chunk.dirtyFrom < to)
+		{
+			size_t size = (to - chunk.dirtyFrom) * RecordingBlockSize;
+			if (fseek(recordingFile, GetChunkSeekPoint(chunk, chunk.dirtyFrom), SEEK_SET) != 0
+				|| fwrite(&chunk.blocks[chunk.dirtyFrom * RecordingBlockSize], 1, size, recordingFile) != size)
+			{
+				recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: %s\n", strerror(errno)));
+				return false;
+			}
+		}
+		chunk.dirtyFrom = chunk.dirtyTo = 0;
+
+		if (chunk.slotDirty && fileVersion != RecordingVersionFlat)
+		{
+			RecordingSlotHeader slotHeader;
+			slotHeader.frameCount = chunk.GetFrameCount();
+			slotHeader.nextSlot = i + 1 < chunks.size() ? chunks[i + 1].slot : RecordingSlotEnd;
+			if (fseek(recordingFile, GetChunkSeekPoint(chunk, 0) - (long)sizeof(RecordingSlotHeader), SEEK_SET) != 0
+				|| fwrite(&slotHeader, sizeof(slotHeader), 1, recordingFile) != 1)
+			{
+				recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: %s\n", strerror(errno)));
+				return false;
+			}
+		}
+		chunk.slotDirty = false;
+	}
+
+	if (headerDirty)
+	{
+		WriteMaxFrame();
+		fseek(recordingFile, RecordingSeekpointUndoCount, SEEK_SET);
+		fwrite(&UndoCount, 4, 1, recordingFile);
+		headerDirty = false;
+	}
+
 	fflush(recordingFile);
 	return true;
 }
 
-// Read controller input buffer from file (per frame)
-bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint port, const uint  bufIndex)
+// Write controller input buffer to file (per frame)
+bool InputRecordingFile::WriteKeyBuf(const uint & frame, const uint port, const uint bufIndex, const u8 & buf)
 {
 	if (recordingFile == NULL)
 	{
 		return false;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
-	if (fseek(recordingFile, seek, SEEK_SET) != 0)
+	ExtendTo(frame);
+	GetBlock(frame)[RecordingBlockHeaderSize + 18 * port + bufIndex] = buf;
+	size_t index = FindChunk(frame);
+	MarkDirty(index, frame - chunks[index].firstFrame, frame - chunks[index].firstFrame + 1);
+
+	// Written back once every few frames instead of once per byte, a rewind
+	// (frame going backwards) flushes right away
+	if (frame >= lastFlushFrame + RecordingFlushInterval || frame < lastFlushFrame)
 	{
-		return false;
+		lastFlushFrame = frame;
+		return Flush();
 	}
-	if (fread(&result, 1, 1, recordingFile) != 1)
+	return true;
+}
+
+// Read controller input buffer from file (per frame)
+bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint port, const uint  bufIndex)
+{
+	const u8* block = GetBlock(frame);
+	if (recordingFile == NULL || block == NULL)
 	{
 		return false;
 	}
 
+	result = block[RecordingBlockHeaderSize + 18 * port + bufIndex];
 	return true;
 }
 
@@ -155,54 +406,43 @@ bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint p
 void InputRecordingFile::GetPadData(PadData & result, unsigned long frame)
 {
 	result.fExistKey = false;
-	if (recordingFile == NULL)
-	{
-		return;
-	}
-
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	if (fseek(recordingFile, seek, SEEK_SET) != 0
-		|| fread(result.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
+	const u8* block = GetBlock(frame);
+	if (recordingFile == NULL || block == NULL)
 	{
 		return;
 	}
 
+	memcpy(result.buf, block + RecordingBlockHeaderSize, RecordingBlockDataSize);
 	result.fExistKey = true;
 }
 
 bool InputRecordingFile::DeletePadData(unsigned long frame)
 {
-	if (recordingFile == NULL)
+	if (recordingFile == NULL || frame >= frameCount)
 	{
 		return false;
 	}
 
-	for (unsigned long i = frame; i < MaxFrame - 1; i++)
+	// Chunks emptied here are kept so that their slot stays in the chain
+	size_t index = FindChunk(frame);
+	FrameChunk& chunk = chunks[index];
+	unsigned long rel = frame - chunk.firstFrame;
+	chunk.blocks.erase(chunk.blocks.begin() + rel * RecordingBlockSize, chunk.blocks.begin() + (rel + 1) * RecordingBlockSize);
+	for (size_t i = index + 1; i < chunks.size(); i++)
 	{
-		long seek1 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
+		chunks[i].firstFrame--;
+	}
+	MarkShifted(index, rel);
 
-		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
+	// The last block stays in the file, MaxFrame marks the end of the recording
+	frameCount--;
+	if (MaxFrame > 0)
+	{
+		MaxFrame--;
 	}
-	MaxFrame--;
-	WriteMaxFrame();
-	fflush(recordingFile);
+	headerDirty = true;
 
-	return true;
+	return Flush();
 }
 
 bool InputRecordingFile::InsertPadData(unsigned long frame, const PadData& key)
@@ -212,40 +452,40 @@ bool InputRecordingFile::InsertPadData(unsigned long frame, const PadData& key)
 		return false;
 	}
 
-	for (unsigned long i = MaxFrame - 1; i >= frame; i--)
+	if (frame >= frameCount)
+	{
+		ExtendTo(frame);
+		memcpy(GetBlock(frame) + RecordingBlockHeaderSize, key.buf, RecordingBlockDataSize);
+		size_t index = FindChunk(frame);
+		MarkDirty(index, frame - chunks[index].firstFrame, frame - chunks[index].firstFrame + 1);
+	}
+	else
 	{
-		long seek1 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
+		size_t index = FindChunk(frame);
+		FrameChunk& chunk = chunks[index];
+		unsigned long rel = frame - chunk.firstFrame;
+		const u8* data = (const u8*)key.buf;
+		u8 block[RecordingBlockSize] = {};
+		memcpy(block + RecordingBlockHeaderSize, data, RecordingBlockDataSize);
+		chunk.blocks.insert(chunk.blocks.begin() + rel * RecordingBlockSize, block, block + RecordingBlockSize);
+		frameCount++;
 
-		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		for (size_t i = index + 1; i < chunks.size(); i++)
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
+			chunks[i].firstFrame++;
 		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		MarkShifted(index, rel);
+
+		if (chunk.GetFrameCount() >= RecordingSlotFrames)
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
+			SplitChunk(index);
 		}
 	}
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	int rSize = fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile);
-	if (rSize != RecordingBlockDataSize)
-	{
-		recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
-		return false;
-	}
+
 	MaxFrame++;
-	WriteMaxFrame();
-	fflush(recordingFile);
+	headerDirty = true;
 
-	return true;
+	return Flush();
 }
 
 bool InputRecordingFile::UpdatePadData(unsigned long frame, const PadData& key)
@@ -259,15 +499,11 @@ bool InputRecordingFile::UpdatePadData(unsigned long frame, const PadData& key)
 		return false;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	if (fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
-	{
-		return false;
-	}
-
-	fflush(recordingFile);
-	return true;
+	ExtendTo(frame);
+	memcpy(GetBlock(frame) + RecordingBlockHeaderSize, key.buf, RecordingBlockDataSize);
+	size_t index = FindChunk(frame);
+	MarkDirty(index, frame - chunks[index].firstFrame, frame - chunks[index].firstFrame + 1);
+	return Flush();
 }
 
 // Verify header of recording file
@@ -302,7 +538,7 @@ bool InputRecordingFile::ReadHeaderAndCheck()
 	}
 
 	// Check for current verison
-	if (header.version != 1)
+	if (header.version != RecordingVersionFlat && header.version != RecordingVersionSlots)
 	{
 		recordingConLog(wxString::Format("[REC]: Input recording file is not a supported version - %d\n", header.version));
 		return false;
@@ -344,8 +580,7 @@ void InputRecordingFile::UpdateFrameMax(unsigned long frame)
 		return;
 	}
 	MaxFrame = frame;
-	fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
-	fwrite(&MaxFrame, 4, 1, recordingFile);
+	headerDirty = true;
 }
 
 void InputRecordingFile::AddUndoCount()
@@ -355,8 +590,7 @@ void InputRecordingFile::AddUndoCount()
 	{
 		return;
 	}
-	fseek(recordingFile, RecordingSeekpointUndoCount, SEEK_SET);
-	fwrite(&UndoCount, 4, 1, recordingFile);
+	headerDirty = true;
 }
 
 void InputRecordingHeader::SetAuthor(wxString _author)
@@ -375,6 +609,7 @@ void InputRecordingHeader::SetGameName(wxString _gameName)
 
 void InputRecordingHeader::Init()
 {
+	version = RecordingVersionSlots;
 	memset(author, 0, ArraySize(author));
 	memset(gameName, 0, ArraySize(gameName));
 }
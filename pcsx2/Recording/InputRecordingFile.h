@@ -20,9 +20,13 @@
 
 
 #ifndef DISABLE_RECORDING
+// Version 1 files store the frames back to back, version 2 files store them in chained slots
+static const u8 RecordingVersionFlat = 1;
+static const u8 RecordingVersionSlots = 2;
+
 struct InputRecordingHeader
 {
-	u8 version = 1;
+	u8 version = RecordingVersionSlots;
 	char emu[50] = "PCSX2-1.5.X";
 	char author[255] = "";
 	char gameName[255] = "";
@@ -51,6 +55,7 @@ public:
 	// Movie File Manipulation
 	bool Open(const wxString fn, bool fNewOpen, bool fromSaveState);
 	bool Close();
+	bool Flush();
 	bool WriteKeyBuf(const uint & frame, const uint port, const uint bufIndex, const u8 & buf);
 	bool ReadKeyBuf(u8 & result, const uint & frame, const uint port, const uint bufIndex);
 
@@ -83,11 +88,66 @@ private:
 	static const int RecordingSeekpointUndoCount = sizeof(InputRecordingHeader) + 4;
 	static const int RecordingSeekpointSaveState = RecordingSeekpointUndoCount + 4;
 
+	// Frames are written back to the file at most this often while recording
+	static const unsigned long RecordingFlushInterval = 60;
+	// Frames per chunk when recording, inserted frames can grow a chunk up to a full slot
+	static const unsigned long RecordingChunkFrames = 4096;
+
+	// Version 1 files store the frames back to back, so inserting or deleting a frame moves
+	// every frame after it.  Version 2 files store each chunk in a slot of its own, with room
+	// for RecordingSlotFrames frames after a RecordingSlotHeader.  The slots are chained in
+	// frame order starting with slot 0, so inserting or deleting a frame only rewrites the
+	// slot of its chunk (and the header of the slot before when a chunk is split).
+	static const unsigned long RecordingSlotFrames = RecordingChunkFrames + RecordingChunkFrames / 4;
+	static const u32 RecordingSlotEnd = 0xFFFFFFFF;
+	struct RecordingSlotHeader
+	{
+		u32 frameCount;
+		u32 nextSlot;
+	};
+	static const long RecordingSlotSize = sizeof(RecordingSlotHeader) + RecordingSlotFrames * RecordingBlockSize;
+
 	// Movie File
 	FILE * recordingFile = NULL;
 	wxString filename = "";
 	long GetBlockSeekPoint(const long & frame);
 
+	// Frame data, loaded in full when the file is opened and kept in chunks so that inserting or
+	// deleting a frame only moves the frames of a single chunk.  Changes are written back to the
+	// file in bulk by Flush().
+	struct FrameChunk
+	{
+		unsigned long firstFrame = 0;
+		std::vector<u8> blocks;
+		u32 slot = 0;
+
+		// Frames [dirtyFrom, dirtyTo) of the chunk differ from the file
+		unsigned long dirtyFrom = 0;
+		unsigned long dirtyTo = 0;
+		// The slot header (frame count or next slot) differs from the file
+		bool slotDirty = false;
+
+		unsigned long GetFrameCount() const { return blocks.size() / RecordingBlockSize; }
+	};
+	std::vector<FrameChunk> chunks;
+	unsigned long frameCount = 0;
+	u8 fileVersion = RecordingVersionSlots;
+	u32 slotCount = 0;
+
+	// Header fields to update
+	bool headerDirty = false;
+	unsigned long lastFlushFrame = 0;
+
+	bool LoadFrames();
+	bool LoadSlots(long size);
+	long GetChunkSeekPoint(const FrameChunk& chunk, unsigned long frame);
+	size_t FindChunk(unsigned long frame) const;
+	u8* GetBlock(unsigned long frame);
+	void ExtendTo(unsigned long frame);
+	void SplitChunk(size_t index);
+	void MarkDirty(size_t index, unsigned long from, unsigned long to);
+	void MarkShifted(size_t index, unsigned long from);
+
 	// Header
 	InputRecordingHeader header;
 	InputRecordingSavestate savestate;
@@ -40,7 +40,7 @@ static void PreLoadPrep()
 
 static void PostLoadPrep()
 {
-	memzero(pCache);
+	resetCache();
 //	WriteCP0Status(cpuRegs.CP0.n.Status.val);
 	for(int i=0; i<48; i++) MapTLB(i);
 	if (EmuConfig.Gamefixes.GoemonTlbHack) GoemonPreloadTlb();
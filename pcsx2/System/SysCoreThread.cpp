@@ -23,7 +23,9 @@
 #include "Elfheader.h"
 #include "Patch.h"
 #include "SysThreads.h"
+#include "Timeline.h"
 #include "MTVU.h"
+#include "x86/R3000A_Profiler.h"
 
 #include "../DebugTools/MIPSAnalyst.h"
 #include "../DebugTools/SymbolMap.h"
@@ -31,6 +33,7 @@
 
 #include "Utilities/PageFaultSource.h"
 #include "Utilities/Threading.h"
+#include "Utilities/Telemetry.h"
 
 #ifdef __WXMSW__
 #	include <wx/msw/wrapwin.h>
@@ -146,11 +149,16 @@ void SysCoreThread::ApplySettings( const Pcsx2Config& src )
 
 	if( !pxAssertDev( IsPaused(), "CoreThread is not paused; settings cannot be applied." ) ) return;
 
-	m_resetRecompilers		= ( src.Cpu != EmuConfig.Cpu ) || ( src.Gamefixes != EmuConfig.Gamefixes ) || ( src.Speedhacks != EmuConfig.Speedhacks );
+	m_resetRecompilers		= ( src.Cpu != EmuConfig.Cpu ) || ( src.Gamefixes != EmuConfig.Gamefixes ) || ( src.Speedhacks != EmuConfig.Speedhacks ) || ( src.IopHle != EmuConfig.IopHle );
 	m_resetProfilers		= ( src.Profiler != EmuConfig.Profiler );
 	m_resetVsyncTimers		= ( src.GS != EmuConfig.GS );
 
 	const_cast<Pcsx2Config&>(EmuConfig) = src;
+
+	R3000A::irxFastPathsApplyConfig();
+
+	// (un)protects main memory, which is fine while the core is paused
+	mmap_SetDirtyTracking( EmuConfig.IncrementalSavestates );
 }
 
 void SysCoreThread::UploadStateCopy( const VmStateBuffer& copy )
@@ -227,6 +235,45 @@ void SysCoreThread::VsyncInThread()
 {
 	gdxsv_emu_update();
 	ApplyLoadedPatches(PPT_CONTINUOUSLY);
+
+	if( EmuConfig.EnableTelemetry )
+		UpdateTelemetry();
+}
+
+// Publishes the emulator's own metrics once per vsync.  Readers derive the frame rate and
+// the thread loads from the counters, so nothing here has to be averaged.
+void SysCoreThread::UpdateTelemetry()
+{
+	static Telemetry::Counter vsyncs( "ee.vsyncs" );
+	static Telemetry::Histogram vsyncInterval( "ee.vsync_interval_us" );
+	static Telemetry::Counter eeCpu( "cpu.ee_us" );
+	static Telemetry::Counter gsCpu( "cpu.gs_us" );
+	static Telemetry::Counter vuCpu( "cpu.vu_us" );
+	static Telemetry::Gauge mtgsBacklog( "mtgs.backlog_bytes" );
+	static Telemetry::Gauge mtgsQueuedFrames( "mtgs.queued_frames" );
+	static Telemetry::Gauge mtvuBacklog( "mtvu.backlog_bytes" );
+
+	static u64 lastVsync = 0;
+	const u64 now = GetCPUTicks();
+	if( lastVsync )
+		vsyncInterval.Record( ((now - lastVsync) * 1000000) / GetTickFrequency() );
+	lastVsync = now;
+	vsyncs.Add();
+
+	if( const u64 threadTicks = GetThreadTicksPerSecond() )
+	{
+		eeCpu.Set( (GetCpuTime() * 1000000) / threadTicks );
+		gsCpu.Set( (GetMTGS().GetCpuTime() * 1000000) / threadTicks );
+		if( THREAD_VU1 )
+			vuCpu.Set( (vu1Thread.GetCpuTime() * 1000000) / threadTicks );
+	}
+
+	SysMtgsThread& mtgs( GetMTGS() );
+	mtgsBacklog.Set( ((mtgs.m_WritePos.load() - mtgs.m_ReadPos.load()) & RingBufferMask) * sizeof(u128) );
+	mtgsQueuedFrames.Set( mtgs.m_QueuedFrameCount.load() );
+
+	if( THREAD_VU1 )
+		mtvuBacklog.Set( vu1Thread.GetBacklog() );
 }
 
 void SysCoreThread::GameStartingInThread()
@@ -238,6 +285,7 @@ void SysCoreThread::GameStartingInThread()
 	sApp.PostAppMethod(&Pcsx2App::resetDebugger);
 
 	ApplyLoadedPatches(PPT_ONCE_ON_LOAD);
+	IOP::Profiler.Reset();
 #ifdef USE_SAVESLOT_UI_UPDATES
 	UI_UpdateSysControls();
 #endif
@@ -281,7 +329,13 @@ void SysCoreThread::OnSuspendInThread()
 
 void SysCoreThread::OnResumeInThread( bool isSuspended )
 {
+	// Created before the plugins are opened, so they can attach to it.  The block stays
+	// once created, disabling telemetry only stops the vsync updates.
+	if( EmuConfig.EnableTelemetry && !Telemetry::IsOpen() && !Telemetry::Create() )
+		Console.Warning( "Telemetry: could not create the shared memory block." );
+
 	GetCorePlugins().Open();
+	Timeline::ApplyConfig();
 }
 
 
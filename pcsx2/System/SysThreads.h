@@ -204,6 +204,7 @@ public:
 
 protected:
 	void _reset_stuff_as_needed();
+	void UpdateTelemetry();
 
 	virtual void Start();
 	virtual void OnStart();
@@ -0,0 +1,139 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "gui/App.h"
+#include "Plugins.h"
+#include "Timeline.h"
+#include "Utilities/AsciiFile.h"
+
+#include <wx/datetime.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+TraceEvents::Track Timeline::EE( "EE" );
+TraceEvents::Track Timeline::MTGS( "MTGS" );
+TraceEvents::Track Timeline::MTVU( "MTVU" );
+TraceEvents::Track Timeline::Executor( "SysExecutor" );
+TraceEvents::Track Timeline::Compress( "Savestate compression" );
+
+// The registries of the emulator and of the loaded plugins, once each (a plugin providing
+// several components has a single registry).  Callers hold the plugin mutex.
+static void GetRegistries( std::vector<TraceEvents::Registry*>& dest )
+{
+	dest.push_back( &TraceEvents::GetRegistry() );
+
+	const PluginInfo* pi = tbl_PluginInfo; do {
+		TraceEvents::Registry* registry = GetCorePlugins().GetTraceRegistry( pi->id );
+		if( registry && std::find( dest.begin(), dest.end(), registry ) == dest.end() )
+			dest.push_back( registry );
+	} while( ++pi, pi->shortname != NULL );
+}
+
+// Called whenever the core thread resumes, which is after any plugin change.  The rings
+// stay allocated once used, disabling only stops the recording.
+void Timeline::ApplyConfig()
+{
+	const bool enabled = EmuConfig.Profiler.Enabled && EmuConfig.Profiler.TraceEvents;
+
+	ScopedLock lock( GetCorePlugins().GetMutex() );
+
+	std::vector<TraceEvents::Registry*> registries;
+	GetRegistries( registries );
+
+	for( TraceEvents::Registry* registry : registries )
+		registry->Enable( enabled ? GetCPUTicks : NULL );
+}
+
+bool Timeline::Export()
+{
+	struct TrackCopy
+	{
+		std::string name;
+		std::vector<TraceEvents::Event> events;
+	};
+
+	// The event names point into the plugins, so they're kept loaded until the file is written.
+	ScopedLock lock( GetCorePlugins().GetMutex() );
+
+	std::vector<TraceEvents::Registry*> registries;
+	GetRegistries( registries );
+
+	std::vector<TrackCopy> tracks;
+	size_t total = 0;
+	u64 base = ~0ULL;
+
+	for( TraceEvents::Registry* registry : registries )
+	{
+		std::lock_guard<std::mutex> registry_lock( registry->lock );
+
+		for( const TraceEvents::Track* track = registry->tracks; track; track = track->next )
+		{
+			TrackCopy copy;
+			copy.name = track->GetName();
+			track->Read( copy.events );
+			if( copy.events.empty() ) continue;
+
+			total += copy.events.size();
+			tracks.push_back( std::move( copy ) );
+		}
+	}
+
+	if( !total )
+	{
+		Console.Warning( "Timeline: no events recorded (see Profiler.Enabled and Profiler.TraceEvents)." );
+		return false;
+	}
+
+	// Events are recorded when they end, so nested scopes come before their parents and
+	// the earliest start can be anywhere in a ring.
+	for( const TrackCopy& track : tracks )
+		for( const TraceEvents::Event& event : track.events )
+			base = std::min( base, event.begin );
+
+	g_Conf->Folders.Logs.Mkdir();
+	const wxString filename( Path::Combine( g_Conf->Folders.Logs, wxDateTime::Now().Format( L"timeline_%Y%m%d_%H%M%S.json" ) ) );
+	AsciiFile f( filename, L"w" );
+
+	// Chrome trace event format: one row (tid) per track, "complete" events in microseconds.
+	const double scale = 1000000.0 / (double)GetTickFrequency();
+
+	f.Write( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	for( uint tid = 0; tid < tracks.size(); tid++ )
+	{
+		const TrackCopy& track = tracks[tid];
+
+		f.Printf( "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n",
+			tid ? "," : "", tid, track.name.c_str() );
+		f.Printf( "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", tid, tid );
+
+		for( const TraceEvents::Event& event : track.events )
+		{
+			f.Printf( ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, tid, (double)(event.begin - base) * scale, (double)(event.end - event.begin) * scale );
+		}
+		f.Write( "\n" );
+	}
+
+	f.Write( "]}\n" );
+
+	Console.WriteLn( Color_StrongGreen, L"Timeline: %u events from %u tracks written to %s",
+		(uint)total, (uint)tracks.size(), WX_STR(filename) );
+	return true;
+}
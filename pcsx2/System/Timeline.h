@@ -0,0 +1,41 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utilities/TraceEvents.h"
+
+// --------------------------------------------------------------------------------------
+//  Timeline
+// --------------------------------------------------------------------------------------
+// The emulator's trace tracks, and the export of every track (the plugins' included) as a
+// Chrome trace which chrome://tracing and Perfetto can open.  Markers are recorded while
+// Profiler.Enabled and Profiler.TraceEvents are set, and the rings only hold the last few
+// seconds, so the trace is written on demand (Sys_ExportTimeline, Shift+F10).
+//
+namespace Timeline
+{
+	extern TraceEvents::Track EE;			// the core thread: vsyncs, recompiles
+	extern TraceEvents::Track MTGS;
+	extern TraceEvents::Track MTVU;
+	extern TraceEvents::Track Executor;		// savestate phases
+	extern TraceEvents::Track Compress;		// savestate compression, one thread at a time
+
+	// Enables or disables the registries of the emulator and of the loaded plugins.
+	extern void ApplyConfig();
+
+	// Writes the trace to the logs folder, returns false if there was nothing to write.
+	extern bool Export();
+}
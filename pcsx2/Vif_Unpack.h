@@ -38,5 +38,9 @@ extern __aligned16 const UNPACKFUNCTYPE VIFfuncTable[2][4][(4 * 4 * 2 * 2)];
 _vifT extern int  nVifUnpack (const u8* data);
 extern void resetNewVif(int idx);
 
+// Hot unpack block persistence (newVif dynarec), for the core thread at game start/shutdown
+extern void dVifLoadHotBlocks(const wxString& folder);
+extern void dVifSaveHotBlocks(const wxString& folder);
+
 template< int idx >
 extern void vifUnpackSetup(const u32* data);
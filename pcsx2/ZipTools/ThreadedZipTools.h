@@ -30,6 +30,7 @@ protected:
 	wxString	m_filename;
 	uptr		m_dataidx;
 	size_t		m_datasize;
+	const u8*	m_extdata;		// data outside of the list's buffer, or NULL
 	
 public:
 	ArchiveEntry( const wxString& filename=wxEmptyString )
@@ -37,6 +38,7 @@ public:
 	{
 		m_dataidx	= 0;
 		m_datasize	= 0;
+		m_extdata	= NULL;
 	}
 
 	virtual ~ArchiveEntry() = default;
@@ -53,6 +55,14 @@ public:
 		return *this;
 	}
 
+	// The entry is read from ptr instead of the list's buffer, which the owner of ptr has to
+	// keep unchanged until the archive is written.
+	ArchiveEntry& SetExternalData( const u8* ptr )
+	{
+		m_extdata = ptr;
+		return *this;
+	}
+
 	wxString GetFilename() const
 	{
 		return m_filename;
@@ -67,6 +77,11 @@ public:
 	{
 		return m_datasize;
 	}
+
+	const u8* GetExternalData() const
+	{
+		return m_extdata;
+	}
 };
 
 typedef SafeArray< u8 > ArchiveDataBuffer;
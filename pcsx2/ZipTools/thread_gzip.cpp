@@ -18,6 +18,7 @@
 #include "App.h"
 #include "SaveState.h"
 #include "ThreadedZipTools.h"
+#include "System/Timeline.h"
 #include "Utilities/SafeArray.inl"
 #include "wx/wfstream.h"
 
@@ -52,6 +53,8 @@ void BaseCompressThread::ExecuteTaskInThread()
 
 	if( !m_src_list ) return;
 	SetPendingSave();
+
+	TraceEvents::Scope trace( Timeline::Compress, "Savestate compress" );
 	
 	Yield( 3 );
 
@@ -69,7 +72,10 @@ void BaseCompressThread::ExecuteTaskInThread()
 
 		do {
 			uint thisBlockSize = std::min( BlockSize, entry.GetDataSize() - curidx );
-			m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
+			if (const u8* extdata = entry.GetExternalData())
+				m_gzfp->Write(extdata + curidx, thisBlockSize);
+			else
+				m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
 			curidx += thisBlockSize;
 			Yield( 2 );
 		} while( curidx < entry.GetDataSize() );
@@ -120,6 +120,7 @@ enum MenuIdentifiers
 	MenuId_Sys_LoadStates,		// Opens load states submenu
 	MenuId_Sys_SaveStates,		// Opens save states submenu
 	MenuId_EnableBackupStates,	// Checkbox to enable/disables savestates backup
+	MenuId_EnableIncrementalStates,	// Checkbox to enable/disables incremental savestates
 	MenuId_EnablePatches,
 	MenuId_EnableCheats,
 	MenuId_EnableWideScreenPatches,
@@ -32,6 +32,7 @@
 #include "Patch.h"
 #include "R5900Exceptions.h"
 #include "Sio.h"
+#include "Vif_Unpack.h"
 #include "gdxsv/gdxsv_emu_hooks.h"
 
 __aligned16 SysMtgsThread mtgsThread;
@@ -566,6 +567,10 @@ void AppCoreThread::OnCleanupInThread()
 	m_ExecMode = ExecMode_Closing;
 	PostCoreStatus( CoreThread_Stopped );
 	_parent::OnCleanupInThread();
+
+	// The MTVU thread has been waited for by the parent, so the unpack caches are idle
+	if( EmuConfig.Cpu.Recompiler.PersistVifUnpack )
+		dVifSaveHotBlocks( GetSettingsFolder().ToString() );
 }
 
 void AppCoreThread::VsyncInThread()
@@ -585,6 +590,10 @@ void AppCoreThread::GameStartingInThread()
 	ClearMcdEjectTimeoutNow(); // probably safe to do this when a game boots, eliminates annoying prompts
 	m_ExecMode = ExecMode_Opened;
 
+	// Precompiled on the next unpack cache reset
+	if( EmuConfig.Cpu.Recompiler.PersistVifUnpack )
+		dVifLoadHotBlocks( GetSettingsFolder().ToString() );
+
 	_parent::GameStartingInThread();
 }
 
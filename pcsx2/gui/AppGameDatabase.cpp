@@ -17,6 +17,7 @@
 #include "App.h"
 #include "AppGameDatabase.h"
 #include <wx/stdpaths.h>
+#include <wx/mstream.h>
 
 class DBLoaderHelper
 {
@@ -158,23 +159,50 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 		return *this;
 	}
 
-	wxFFileInputStream reader( file );
+	u64 qpc_Start = GetCPUTicks();
+
+	// The text is read in one go, so it can be hashed and, only if the compiled database is
+	// missing or stale, parsed without touching the file again.
+	wxFFile source( file, L"rb" );
+	std::vector<u8> text;
 
-	if (!reader.IsOk())
+	if (source.IsOpened())
+	{
+		text.resize((size_t)source.Length());
+		if (source.Read(text.data(), text.size()) != text.size())
+			text.clear();
+	}
+
+	if (text.empty())
 	{
 		//throw Exception::FileNotFound( file );
 		Console.Error(L"(GameDB) Could not access file (permission denied?) [%s]", WX_STR(file));
+		return *this;
 	}
 
+	const u64 sourceHash = CompiledGameDatabase::HashSource(text.data(), text.size());
+	const wxString compiled( Path::Combine( GetSettingsFolder(), wxFileName(L"GameIndex.dbc") ) );
+
+	if (m_compiled.Load( compiled, sourceHash ))
+	{
+		u64 qpc_end = GetCPUTicks();
+		Console.WriteLn( "(GameDB) %d games on record (compiled database loaded in %ums)",
+			m_compiled.GetGameCount(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
+		return *this;
+	}
+
+	wxMemoryInputStream reader( text.data(), text.size() );
 	DBLoaderHelper loader( reader, *this );
 
-	u64 qpc_Start = GetCPUTicks();
 	loader.ReadGames();
 	u64 qpc_end = GetCPUTicks();
 
 	Console.WriteLn( "(GameDB) %d games on record (loaded in %ums)",
 		gHash.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
 
+	if (!CompiledGameDatabase::Save( compiled, sourceHash, gHash ))
+		Console.Warning(L"(GameDB) Could not save the compiled database [%s]", WX_STR(compiled));
+
 	return *this;
 }
 
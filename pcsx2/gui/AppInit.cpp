@@ -21,6 +21,7 @@
 #include "MTVU.h" // for thread cancellation on shutdown
 
 #include "Utilities/IniInterface.h"
+#include "Utilities/Telemetry.h"
 #include "DebugTools/Debug.h"
 #include "Dialogs/ModalPopups.h"
 
@@ -675,6 +676,8 @@ void Pcsx2App::CleanupOnExit()
 		Console.Indent().Error( ex.FormatDiagnosticMessage() );
 	}
 
+	Telemetry::Unlink();
+
 #ifdef __WXMSW__
 	pxDwm_Unload();
 #endif
@@ -32,6 +32,7 @@
 #include "Dump.h"
 #include "DebugTools/Debug.h"
 #include "R3000A.h"
+#include "System/Timeline.h"
 
 #include "Debugger/GundamDXDebug.h"
 
@@ -387,6 +388,12 @@ namespace Implementations
 #endif
 	}
 
+	// Writes the recorded timeline markers to the logs folder (see Timeline.h)
+	void Sys_ExportTimeline()
+	{
+		Timeline::Export();
+	}
+
 	void Sys_FreezeGS()
 	{
 		// fixme : fix up gsstate mess and make it mtgs compatible -- air
@@ -749,6 +756,13 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"Sys_ExportTimeline",
+		Implementations::Sys_ExportTimeline,
+		NULL,
+		NULL,
+		false,
+	},
+
 	{	"Sys_FreezeGS",
 		Implementations::Sys_FreezeGS,
 		NULL,
@@ -198,6 +198,7 @@ void MainEmuFrame::ConnectMenus()
 	Bind(wxEVT_MENU, &MainEmuFrame::Menu_SaveStates_Click, this, MenuId_State_Save01 + 1, MenuId_State_Save01 + 10);
 	Bind(wxEVT_MENU, &MainEmuFrame::Menu_SaveStateToFile_Click, this, MenuId_State_SaveToFile);
 	Bind(wxEVT_MENU, &MainEmuFrame::Menu_EnableBackupStates_Click, this, MenuId_EnableBackupStates);
+	Bind(wxEVT_MENU, &MainEmuFrame::Menu_EnableIncrementalStates_Click, this, MenuId_EnableIncrementalStates);
 
 	Bind(wxEVT_MENU, &MainEmuFrame::Menu_EnablePatches_Click, this, MenuId_EnablePatches);
 	Bind(wxEVT_MENU, &MainEmuFrame::Menu_EnableCheats_Click, this, MenuId_EnableCheats);
@@ -458,6 +459,9 @@ MainEmuFrame::MainEmuFrame(wxWindow* parent, const wxString& title)
 	m_menuSys.Append(MenuId_EnableBackupStates,	_("&Backup before save"),
 		wxEmptyString, wxITEM_CHECK);
 
+	m_menuSys.Append(MenuId_EnableIncrementalStates,	_("&Incremental saves"),
+		_("Keeps a copy of the emulated memory between saves, so each save only copies what changed since the previous one"), wxITEM_CHECK);
+
 	m_menuSys.AppendSeparator();
 
 	m_menuSys.Append(MenuId_EnablePatches,	_("Automatic &Gamefixes"),
@@ -745,6 +749,7 @@ void MainEmuFrame::ApplyConfigToGui(AppConfig& configToApply, int flags)
 	if ( !(flags & AppConfig::APPLY_FLAG_FROM_PRESET) )
 	{//these should not be affected by presets
 		menubar.Check( MenuId_EnableBackupStates, configToApply.EmuOptions.BackupSavestate );
+		menubar.Check( MenuId_EnableIncrementalStates, configToApply.EmuOptions.IncrementalSavestates );
 		menubar.Check( MenuId_EnableCheats,  configToApply.EmuOptions.EnableCheats );
 		menubar.Check( MenuId_EnableWideScreenPatches,  configToApply.EmuOptions.EnableWideScreenPatches );
 #ifndef DISABLE_RECORDING
@@ -473,6 +473,13 @@ void MainEmuFrame::Menu_EnableBackupStates_Click( wxCommandEvent& )
 	AppSaveSettings();
 }
 
+void MainEmuFrame::Menu_EnableIncrementalStates_Click( wxCommandEvent& )
+{
+	g_Conf->EmuOptions.IncrementalSavestates = GetMenuBar()->IsChecked( MenuId_EnableIncrementalStates );
+	AppApplySettings();
+	AppSaveSettings();
+}
+
 void MainEmuFrame::Menu_EnablePatches_Click( wxCommandEvent& )
 {
 	g_Conf->EmuOptions.EnablePatches = GetMenuBar()->IsChecked( MenuId_EnablePatches );
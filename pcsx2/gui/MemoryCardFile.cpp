@@ -40,26 +40,79 @@ struct Component_FileMcd;
 
 #include <wx/ffile.h>
 #include <map>
+#include <memory>
+#include <atomic>
+
+#ifdef __WXMSW__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 static const int MCD_SIZE	= 1024 *  8  * 16;		// Legacy PSX card default size
 
 static const int MC2_MBSIZE	= 1024 * 528 * 2;		// Size of a single megabyte of card data
 
+class FileMemoryCard;
+
+// --------------------------------------------------------------------------------------
+//  McdWriteBackThread
+// --------------------------------------------------------------------------------------
+// Writes the modified erase blocks of the cached memory card images back to their files.
+// Woken by the first write after the previous batch; waits a little so that the burst of
+// sector writes a save usually consists of reaches the disk as a single batch.
+//
+class McdWriteBackThread : public pxThread
+{
+	typedef pxThread _parent;
+
+protected:
+	FileMemoryCard&		m_card;
+	Semaphore			m_sem_event;
+	std::atomic<bool>	m_exit;
+
+public:
+	McdWriteBackThread( FileMemoryCard& card );
+	virtual ~McdWriteBackThread();
+
+	void Wake() { m_sem_event.Post(); }
+
+	// Writes out anything still pending and waits for the thread to end.
+	void Stop();
+
+protected:
+	void OnStart();
+	void ExecuteTaskInThread();
+};
+
 // --------------------------------------------------------------------------------------
 //  FileMemoryCard
 // --------------------------------------------------------------------------------------
-// Provides thread-safe direct file IO mapping.
+// Keeps a full in-memory image of every card file.  Reads and writes are served from the
+// image; modified erase blocks are flagged and written back to the file (followed by a
+// single flush to disk) by the McdWriteBackThread.
 //
 class FileMemoryCard
 {
+	friend class McdWriteBackThread;
+
 protected:
+	static const uint WriteBackDelayMs = 250;
+
 	wxFFile			m_file[8];
+	std::vector<u8>	m_image[8];		// contents of the whole file, including any PSX header
+	std::vector<u8>	m_dirty[8];		// one flag per erase block (in file offsets) awaiting write-back
+	u32				m_offset[8];	// size of the legacy PSX header, added to every card address
 	u8				m_effeffs[528*16];
-	SafeArray<u8>	m_currentdata;
 	u64				m_chksum[8];
 	bool			m_ispsx[8];
 	u32				m_chkaddr;
 
+	Mutex			m_lock_dirty;	// guards m_dirty, m_pending and the image while it is snapshot
+	bool			m_pending;
+
+	std::unique_ptr<McdWriteBackThread> m_writer;
+
 public:
 	FileMemoryCard();
 	virtual ~FileMemoryCard() = default;
@@ -79,7 +132,10 @@ public:
 	u64  GetCRC		( uint slot );
 
 protected:
-	bool Seek( wxFFile& f, u32 adr );
+	u32  GetHeaderOffset( u32 size ) const;
+	bool Load( uint slot );
+	void MarkDirty( uint slot, u32 pos, u32 size );
+	void WriteBack();
 	bool Create( const wxString& mcdFile, uint sizeInMB );
 
 	wxString GetDisabledMessage( uint slot ) const
@@ -143,10 +199,64 @@ wxString FileMcd_GetDefaultName(uint slot)
 		return wxsFormat( L"Mcd%03u.ps2", slot+1 );
 }
 
+McdWriteBackThread::McdWriteBackThread( FileMemoryCard& card )
+	: m_card( card )
+{
+	m_name = L"McdWriteBack";
+	m_exit = false;
+}
+
+McdWriteBackThread::~McdWriteBackThread()
+{
+	try {
+		_parent::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void McdWriteBackThread::OnStart()
+{
+	_parent::OnStart();
+	m_exit = false;
+	m_sem_event.Reset();
+}
+
+void McdWriteBackThread::Stop()
+{
+	if( !IsRunning() ) return;
+
+	m_exit = true;
+	m_sem_event.Post();
+	Block();
+}
+
+void McdWriteBackThread::ExecuteTaskInThread()
+{
+	while( !m_exit )
+	{
+		m_sem_event.WaitWithoutYield();
+		if( !m_exit ) Threading::Sleep( FileMemoryCard::WriteBackDelayMs );
+		m_card.WriteBack();
+	}
+}
+
+// Pushes the file's buffered data all the way to the disk.
+static void FlushToDisk( wxFFile& f )
+{
+	f.Flush();
+#ifdef __WXMSW__
+	_commit( _fileno( f.fp() ) );
+#else
+	fsync( fileno( f.fp() ) );
+#endif
+}
+
 FileMemoryCard::FileMemoryCard()
 {
 	memset8<0xff>( m_effeffs );
 	m_chkaddr = 0;
+	m_pending = false;
+	memzero( m_offset );
 }
 
 void FileMemoryCard::Open()
@@ -206,8 +316,10 @@ void FileMemoryCard::Open()
 		NTFS_CompressFile( str, g_Conf->McdCompressNTFS );
 #endif
 
-		if( !m_file[slot].Open( str.c_str(), L"r+b" ) )
+		if( !m_file[slot].Open( str.c_str(), L"r+b" ) || !Load( slot ) )
 		{
+			m_file[slot].Close();
+
 			// Translation note: detailed description should mention that the memory card will be disabled
 			// for the duration of this session.
 			Msgbox::Alert(
@@ -217,50 +329,146 @@ void FileMemoryCard::Open()
 		}
 		else // Load checksum
 		{
-			m_ispsx[slot] = m_file[slot].Length() == 0x20000;
+			m_ispsx[slot] = m_image[slot].size() == 0x20000;
 			m_chkaddr = 0x210;
 
-			if(!m_ispsx[slot] && !!m_file[slot].Seek( m_chkaddr ))
-				m_file[slot].Read( &m_chksum[slot], 8 );
+			if(!m_ispsx[slot] && m_chkaddr + 8 <= m_image[slot].size())
+				memcpy( &m_chksum[slot], &m_image[slot][m_chkaddr], 8 );
 		}
 	}
+
+	if( !m_writer ) m_writer = std::unique_ptr<McdWriteBackThread>( new McdWriteBackThread( *this ) );
+	m_writer->Start();
 }
 
 void FileMemoryCard::Close()
 {
+	if( m_writer ) m_writer->Stop();
+	WriteBack();
+
 	for( int slot=0; slot<8; ++slot )
 	{
 		if (m_file[slot].IsOpened()) {
 			// Store checksum
 			if(!m_ispsx[slot] && !!m_file[slot].Seek(  m_chkaddr ))
+			{
 				m_file[slot].Write( &m_chksum[slot], 8 );
+				FlushToDisk( m_file[slot] );
+			}
 
 			m_file[slot].Close();
 		}
+
+		m_image[slot].clear();
+		m_dirty[slot].clear();
 	}
 }
 
-// Returns FALSE if the seek failed (is outside the bounds of the file).
-bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
+// Returns the number of header bytes that precede the card data in a file of the given size.
+u32 FileMemoryCard::GetHeaderOffset( u32 size ) const
 {
-	const u32 size = f.Length();
-
 	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
 	// cards, perhaps hacked support for some special emulator-specific memcard formats that
 	// had header info?), then please replace this comment with something useful.  Thanks!  -- air
 
-	u32 offset = 0;
-
 	if( size == MCD_SIZE + 64 )
-		offset = 64;
+		return 64;
 	else if( size == MCD_SIZE + 3904 )
-		offset = 3904;
-	else
+		return 3904;
+
+	// perform sanity checks here?
+	return 0;
+}
+
+// Reads the whole card file into its image.  Returns FALSE if the file could not be read.
+bool FileMemoryCard::Load( uint slot )
+{
+	wxFFile& mcfp( m_file[slot] );
+	const wxFileOffset size = mcfp.Length();
+	if( size <= 0 || !mcfp.Seek( 0 ) ) return false;
+
+	m_image[slot].resize( (size_t)size );
+	if( mcfp.Read( m_image[slot].data(), size ) != (size_t)size )
+	{
+		m_image[slot].clear();
+		return false;
+	}
+
+	m_dirty[slot].assign( (size + sizeof(m_effeffs) - 1) / sizeof(m_effeffs), 0 );
+	m_offset[slot] = GetHeaderOffset( (u32)size );
+	return true;
+}
+
+// Flags the erase blocks covering the given file range for write-back.  Must be called
+// with m_lock_dirty held.
+void FileMemoryCard::MarkDirty( uint slot, u32 pos, u32 size )
+{
+	const u32 first = pos / sizeof(m_effeffs);
+	const u32 last = (pos + size - 1) / sizeof(m_effeffs);
+
+	for( u32 i = first; i <= last; ++i )
+		m_dirty[slot][i] = 1;
+
+	if( !m_pending )
+	{
+		m_pending = true;
+		if( m_writer ) m_writer->Wake();
+	}
+}
+
+// Writes every flagged erase block back to its file and flushes the touched files to disk.
+// The image is only modified by the emulation thread, so the blocks are copied out under
+// the lock and the slow file IO happens without it.
+void FileMemoryCard::WriteBack()
+{
+	struct Run { uint slot; u32 pos; u32 size; };
+
+	std::vector<Run> runs;
+	std::vector<u8> data;
+
+	{
+		ScopedLock lock( m_lock_dirty );
+		if( !m_pending ) return;
+		m_pending = false;
+
+		for( uint slot=0; slot<8; ++slot )
+		{
+			std::vector<u8>& dirty( m_dirty[slot] );
+			const u32 filesize = m_image[slot].size();
+
+			for( u32 i = 0; i < dirty.size(); ++i )
+			{
+				if( !dirty[i] ) continue;
+
+				// Merge neighbouring blocks into one contiguous write.
+				u32 end = i;
+				while( end < dirty.size() && dirty[end] ) dirty[end++] = 0;
+
+				const u32 pos = i * sizeof(m_effeffs);
+				const u32 size = std::min<u32>( end * sizeof(m_effeffs), filesize ) - pos;
+
+				runs.push_back( { slot, pos, size } );
+				data.insert( data.end(), &m_image[slot][pos], &m_image[slot][pos] + size );
+				i = end;
+			}
+		}
+	}
+
+	bool touched[8] = {};
+	const u8* src = data.data();
+
+	for( const Run& run : runs )
 	{
-		// perform sanity checks here?
+		wxFFile& mcfp( m_file[run.slot] );
+		if( !mcfp.Seek( run.pos ) || mcfp.Write( src, run.size ) != run.size )
+			Console.Error( "(FileMcd) Failed to write back %u bytes at %08X to slot %u.", run.size, run.pos, run.slot );
+
+		touched[run.slot] = true;
+		src += run.size;
 	}
 
-	return f.Seek( adr + offset );
+	for( uint slot=0; slot<8; ++slot )
+		if( touched[slot] ) FlushToDisk( m_file[slot] );
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -293,7 +501,7 @@ void FileMemoryCard::GetSizeInfo( uint slot, PS2E_McdSizeInfo& outways )
 	outways.Xor						= 18;  // 0x12, XOR 02 00 00 10
 
 	if( pxAssert( m_file[slot].IsOpened() ) )
-		outways.McdSizeInSectors	= m_file[slot].Length() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+		outways.McdSizeInSectors	= m_image[slot].size() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
 	else
 		outways.McdSizeInSectors	= 0x4000;
 
@@ -308,44 +516,49 @@ bool FileMemoryCard::IsPSX( uint slot )
 
 s32 FileMemoryCard::Read( uint slot, u8 *dest, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted read from disabled slot." );
 		memset(dest, 0, size);
 		return 1;
 	}
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Read( dest, size ) != 0;
+
+	const std::vector<u8>& image( m_image[slot] );
+	const u32 pos = adr + m_offset[slot];
+	if( pos >= image.size() ) return 0;
+
+	memcpy( dest, &image[pos], std::min<u32>( size, image.size() - pos ) );
+	return 1;
 }
 
 s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted save/write to disabled slot." );
 		return 1;
 	}
 
+	std::vector<u8>& image( m_image[slot] );
+	const u32 pos = adr + m_offset[slot];
+	if( pos >= image.size() || size <= 0 ) return 0;
+	size = std::min<u32>( size, image.size() - pos );
+
+	u8* dest = &image[pos];
+
+	ScopedLock lock( m_lock_dirty );
+
 	if(m_ispsx[slot])
 	{
-		m_currentdata.MakeRoomFor( size );
-		for (int i=0; i<size; i++) m_currentdata[i] = src[i];
+		memcpy( dest, src, size );
 	}
 	else
 	{
-		if( !Seek(mcfp, adr) ) return 0;
-		m_currentdata.MakeRoomFor( size );
-		mcfp.Read( m_currentdata.GetPtr(), size);
-		
-
 		for (int i=0; i<size; i++)
 		{
-			if ((m_currentdata[i] & src[i]) != src[i])
+			if ((dest[i] & src[i]) != src[i])
 				Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
-			m_currentdata[i] &= src[i];
+			dest[i] &= src[i];
 		}
 
 		// Checksumness
@@ -353,69 +566,71 @@ s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 			if(adr == m_chkaddr) 
 				Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
 
-			u64 *pdata = (u64*)&m_currentdata[0];
 			u32 loops = size / 8;
 
 			for(u32 i = 0; i < loops; i++)
-				m_chksum[slot] ^= pdata[i];
+			{
+				u64 qword;
+				memcpy( &qword, dest + i*8, 8 );
+				m_chksum[slot] ^= qword;
+			}
 		}
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
+	MarkDirty( slot, pos, size );
 
-	int status = mcfp.Write( m_currentdata.GetPtr(), size );
+	static auto last = std::chrono::time_point<std::chrono::system_clock>();
 
-	if( status ) {
-		static auto last = std::chrono::time_point<std::chrono::system_clock>();
-
-		std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
-		if(elapsed > std::chrono::seconds(5)) {
-			wxString name, ext;
-			wxFileName::SplitPath(m_file[slot].GetName(), NULL, NULL, &name, &ext);
-			OSDlog( Color_StrongYellow, false, "Memory Card %s written.", (const char *)(name + "." + ext).c_str() );
-			last = std::chrono::system_clock::now();
-		}
-		return 1;
+	std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
+	if(elapsed > std::chrono::seconds(5)) {
+		wxString name, ext;
+		wxFileName::SplitPath(m_file[slot].GetName(), NULL, NULL, &name, &ext);
+		OSDlog( Color_StrongYellow, false, "Memory Card %s written.", (const char *)(name + "." + ext).c_str() );
+		last = std::chrono::system_clock::now();
 	}
-
-	return 0;
+	return 1;
 }
 
 s32 FileMemoryCard::EraseBlock( uint slot, u32 adr )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "MemoryCard: Ignoring erase for disabled slot." );
 		return 1;
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Write( m_effeffs, sizeof(m_effeffs) ) != 0;
+	std::vector<u8>& image( m_image[slot] );
+	const u32 pos = adr + m_offset[slot];
+	if( pos >= image.size() ) return 0;
+	const u32 size = std::min<u32>( sizeof(m_effeffs), image.size() - pos );
+
+	ScopedLock lock( m_lock_dirty );
+	memcpy( &image[pos], m_effeffs, size );
+	MarkDirty( slot, pos, size );
+	return 1;
 }
 
 u64 FileMemoryCard::GetCRC( uint slot )
 {
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() ) return 0;
+	if( !m_file[slot].IsOpened() ) return 0;
 
 	u64 retval = 0;
 
 	if(m_ispsx[slot])
 	{
-		if( !Seek( mcfp, 0 ) ) return 0;
-
-		// Process the file in 4k chunks.  Speeds things up significantly.
-	
-		u64 buffer[528*8];		// use 528 (sector size), ensures even divisibility
-	
-		const uint filesize = mcfp.Length() / sizeof(buffer);
-		for( uint i=filesize; i; --i )
+		// Only whole 64-sector chunks are summed; a trailing partial chunk is not part of the CRC.
+		const std::vector<u8>& image( m_image[slot] );
+		const u32 chunk = 528*8*sizeof(u64);
+		const u32 length = (image.size() / chunk) * chunk;
+		const u8* data = &image[m_offset[slot]];
+
+		if( m_offset[slot] + length > image.size() ) return 0;
+
+		for( u32 i = 0; i < length; i += 8 )
 		{
-			mcfp.Read( &buffer, sizeof(buffer) );
-			for( uint t=0; t<ArraySize(buffer); ++t )
-				retval ^= buffer[t];
+			u64 qword;
+			memcpy( &qword, data + i, 8 );
+			retval ^= qword;
 		}
 	}
 	else
@@ -34,16 +34,21 @@ FolderMemoryCard::FolderMemoryCard() {
 	m_timeLastWritten = 0;
 	m_filteringEnabled = false;
 	m_filteringString = L"";
+	m_flushInProgress = false;
 }
 
 void FolderMemoryCard::InitializeInternalData() {
+	FinishFlush();
+
 	memset( &m_superBlock, 0xFF, sizeof( m_superBlock ) );
 	memset( &m_indirectFat, 0xFF, sizeof( m_indirectFat ) );
 	memset( &m_fat, 0xFF, sizeof( m_fat ) );
 	memset( &m_backupBlock1, 0xFF, sizeof( m_backupBlock1 ) );
 	memset( &m_backupBlock2, 0xFF, sizeof( m_backupBlock2 ) );
 	m_cache.clear();
-	m_oldDataCache.clear();
+	m_cacheIndex.clear();
+	m_flushOperations.clear();
+	m_flushData.clear();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 	m_timeLastWritten = 0;
@@ -109,12 +114,18 @@ void FolderMemoryCard::Open( const wxString& fullPath, const AppConfig::McdOptio
 void FolderMemoryCard::Close( bool flush ) {
 	if ( !m_isEnabled ) { return; }
 
+	FinishFlush();
+	if ( m_flushThread ) {
+		m_flushThread->Stop();
+	}
+
 	if ( flush ) {
 		Flush();
+		WriteFlushOperations();
 	}
 
 	m_cache.clear();
-	m_oldDataCache.clear();
+	m_cacheIndex.clear();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 }
@@ -768,9 +779,9 @@ s32 FolderMemoryCard::Read( u8 *dest, u32 adr, int size ) {
 		const u32 dataLength = std::min( (u32)size, (u32)( PageSize - offset ) );
 
 		// if we have a cache for this page, just load from that
-		auto it = m_cache.find( page );
-		if ( it != m_cache.end() ) {
-			memcpy( dest, &it->second.raw[offset], dataLength );
+		const MemoryCardCachePage* const cachePage = GetCachedPage( page );
+		if ( cachePage != nullptr ) {
+			memcpy( dest, &cachePage->data.raw[offset], dataLength );
 		} else {
 			ReadDataWithoutCache( dest, adr, dataLength );
 		}
@@ -832,19 +843,20 @@ s32 FolderMemoryCard::Save( const u8 *src, u32 adr, int size ) {
 		const u32 dataLength = std::min( (u32)size, PageSize - offset );
 
 		// if cache page has not yet been touched, fill it with the data from our memory card
-		auto it = m_cache.find( page );
-		MemoryCardPage* cachePage;
-		if ( it == m_cache.end() ) {
-			cachePage = &m_cache[page];
+		MemoryCardCachePage* cachePage = GetCachedPage( page );
+		if ( cachePage == nullptr ) {
+			cachePage = AddCachedPage( page );
 			const u32 adrLoad = page * PageSizeRaw;
-			ReadDataWithoutCache( &cachePage->raw[0], adrLoad, PageSize );
-			memcpy( &m_oldDataCache[page].raw[0], &cachePage->raw[0], PageSize );
-		} else {
-			cachePage = &it->second;
+			ReadDataWithoutCache( &cachePage->data.raw[0], adrLoad, PageSize );
+			memcpy( &cachePage->oldData.raw[0], &cachePage->data.raw[0], PageSize );
+		} else if ( !cachePage->dirty ) {
+			// still being written by the flush thread, which is what the file system will contain afterwards
+			memcpy( &cachePage->oldData.raw[0], &cachePage->data.raw[0], PageSize );
 		}
 
 		// then just write to the cache
-		memcpy( &cachePage->raw[offset], src, dataLength );
+		cachePage->dirty = true;
+		memcpy( &cachePage->data.raw[offset], src, dataLength );
 
 		SetTimeLastWrittenToNow();
 	}
@@ -852,10 +864,181 @@ s32 FolderMemoryCard::Save( const u8 *src, u32 adr, int size ) {
 	return 1;
 }
 
+MemoryCardCachePage* FolderMemoryCard::GetCachedPage( const u32 page ) {
+	if ( page >= m_cacheIndex.size() || m_cacheIndex[page] == CachePageUnused ) {
+		return nullptr;
+	}
+	return &m_cache[m_cacheIndex[page]];
+}
+
+MemoryCardCachePage* FolderMemoryCard::AddCachedPage( const u32 page ) {
+	if ( page >= m_cacheIndex.size() ) {
+		m_cacheIndex.resize( std::max( page + 1, (u32)TotalPages ), (u32)CachePageUnused );
+	}
+
+	m_cacheIndex[page] = m_cache.size();
+	m_cache.emplace_back();
+	m_cache.back().page = page;
+	m_cache.back().dirty = false;
+	return &m_cache.back();
+}
+
+void FolderMemoryCard::RemoveCachedPage( const u32 page ) {
+	if ( page >= m_cacheIndex.size() || m_cacheIndex[page] == CachePageUnused ) { return; }
+
+	// move the last cached page into the freed spot
+	const u32 index = m_cacheIndex[page];
+	if ( index != m_cache.size() - 1 ) {
+		m_cache[index] = m_cache.back();
+		m_cacheIndex[m_cache[index].page] = index;
+	}
+	m_cache.pop_back();
+	m_cacheIndex[page] = CachePageUnused;
+}
+
 void FolderMemoryCard::NextFrame() {
+	if ( m_flushInProgress && !m_flushThread->IsBusy() ) {
+		FinishFlush();
+	}
+
 	if ( m_framesUntilFlush > 0 && --m_framesUntilFlush == 0 ) {
-		Flush();
+		if ( m_flushInProgress ) {
+			// previous flush is still being written, try again next frame
+			m_framesUntilFlush = 1;
+			return;
+		}
+
+		BeginFlush();
+	}
+}
+
+void FolderMemoryCard::BeginFlush() {
+	Flush();
+
+	if ( !m_flushOperations.empty() ) {
+		if ( !m_flushThread ) {
+			m_flushThread = std::unique_ptr<FolderMemoryCardFlushThread>( new FolderMemoryCardFlushThread( *this ) );
+		}
+		m_flushThread->Start();
+		m_flushInProgress = true;
+		m_flushThread->BeginFlush();
+	}
+}
+
+void FolderMemoryCard::FinishFlush() {
+	if ( !m_flushInProgress ) { return; }
+
+	m_flushThread->WaitForFlush();
+	m_flushInProgress = false;
+
+	// the file system is up to date now, so only pages modified since the flush need to stay cached
+	for ( size_t i = m_cache.size(); i > 0; --i ) {
+		if ( !m_cache[i - 1].dirty ) {
+			RemoveCachedPage( m_cache[i - 1].page );
+		}
+	}
+
+	// open files anew on the next read, so nothing buffered from before the flush is returned
+	m_lastAccessedFile.CloseAll();
+}
+
+FolderMemoryCardFlushOperation& FolderMemoryCard::AddFlushOperation( FolderMemoryCardFlushOperation::OperationType type, const u8* data, u32 dataLength ) {
+	m_flushOperations.emplace_back();
+	FolderMemoryCardFlushOperation& op = m_flushOperations.back();
+	op.type = type;
+	op.fileRef = nullptr;
+	op.fileOffset = 0;
+	op.dataOffset = m_flushData.size();
+	op.dataLength = dataLength;
+
+	if ( dataLength > 0 ) {
+		m_flushData.insert( m_flushData.end(), data, data + dataLength );
 	}
+
+	return op;
+}
+
+void FolderMemoryCard::WriteFlushOperations() {
+	if ( m_flushOperations.empty() ) { return; }
+
+	const u64 timeWriteStart = wxGetLocalTimeMillis().GetValue();
+
+	for ( const FolderMemoryCardFlushOperation& op : m_flushOperations ) {
+		switch ( op.type ) {
+		case FolderMemoryCardFlushOperation::WriteFile: {
+			wxFileName fn( op.path );
+			if ( !fn.DirExists() ) {
+				fn.Mkdir();
+			}
+			wxFFile file( op.path, L"wb" );
+			if ( file.IsOpened() ) {
+				file.Write( &m_flushData[op.dataOffset], op.dataLength );
+				file.Close();
+			}
+			break;
+		}
+
+		case FolderMemoryCardFlushOperation::RemoveFile:
+			if ( wxFileName::FileExists( op.path ) ) {
+				wxRemoveFile( op.path );
+			}
+			break;
+
+		case FolderMemoryCardFlushOperation::CreateEmptyFile: {
+			wxFileName fn( op.path );
+			if ( !fn.FileExists() ) {
+				if ( !fn.DirExists() ) {
+					fn.Mkdir( 0777, wxPATH_MKDIR_FULL );
+				}
+				wxFFile createEmptyFile( op.path, L"wb" );
+				createEmptyFile.Close();
+			}
+			break;
+		}
+
+		case FolderMemoryCardFlushOperation::RenameToDeleted:
+			if ( wxFileName::DirExists( op.newPath ) ) {
+				// wxRenameFile doesn't overwrite directories, so we have to remove the old one first
+				RemoveDirectory( op.newPath );
+			}
+			wxRenameFile( op.path, op.newPath );
+			break;
+
+		case FolderMemoryCardFlushOperation::WriteFileData: {
+			wxFFile* file = m_flushFileAccess.ReOpen( m_flushFolderName, op.fileRef, true );
+			if ( file->IsOpened() ) {
+				wxFileOffset actualFileSize = file->Length();
+				if ( actualFileSize < op.fileOffset ) {
+					file->Seek( actualFileSize );
+					const u32 diff = op.fileOffset - actualFileSize;
+					u8 temp = 0xFF;
+					for ( u32 i = 0; i < diff; ++i ) {
+						file->Write( &temp, 1 );
+					}
+				}
+
+				const wxFileOffset fileOffset = file->Tell();
+				if ( fileOffset != op.fileOffset ) {
+					file->Seek( op.fileOffset );
+				}
+				if ( op.dataLength > 0 ) {
+					file->Write( &m_flushData[op.dataOffset], op.dataLength );
+				}
+			}
+			break;
+		}
+		}
+	}
+
+	m_flushFileAccess.FlushAll();
+	m_flushFileAccess.ClearMetadataWriteState();
+	m_flushFileAccess.CloseAll();
+
+	const u64 timeWriteEnd = wxGetLocalTimeMillis().GetValue();
+	Console.WriteLn( L"(FolderMcd) Wrote %u changes of slot %u to the file system in %u ms.", (u32)m_flushOperations.size(), m_slot, (u32)( timeWriteEnd - timeWriteStart ) );
+
+	m_flushOperations.clear();
+	m_flushData.clear();
 }
 
 void FolderMemoryCard::Flush() {
@@ -868,6 +1051,9 @@ void FolderMemoryCard::Flush() {
 	Console.WriteLn( L"(FolderMcd) Writing data for slot %u to file system...", m_slot );
 	const u64 timeFlushStart = wxGetLocalTimeMillis().GetValue();
 
+	// the flush thread works on its own copy of the folder name
+	m_flushFolderName = wxFileName( m_folderName.GetFullPath() );
+
 	// Keep a copy of the old file entries so we can figure out which files and directories, if any, have been deleted from the memory card.
 	std::vector<MemoryCardFileEntryTreeNode> oldFileEntryTree;
 	if ( IsFormatted() ) {
@@ -918,10 +1104,6 @@ void FolderMemoryCard::Flush() {
 		FlushPage( i );
 	}
 
-	m_lastAccessedFile.FlushAll();
-	m_lastAccessedFile.ClearMetadataWriteState();
-	m_oldDataCache.clear();
-
 	const u64 timeFlushEnd = wxGetLocalTimeMillis().GetValue();
 	Console.WriteLn( L"(FolderMcd) Done! Took %u ms.", timeFlushEnd - timeFlushStart );
 
@@ -931,13 +1113,18 @@ void FolderMemoryCard::Flush() {
 }
 
 bool FolderMemoryCard::FlushPage( const u32 page ) {
-	auto it = m_cache.find( page );
-	if ( it != m_cache.end() ) {
-		WriteWithoutCache( &it->second.raw[0], page * PageSizeRaw, PageSize );
-		m_cache.erase( it );
-		return true;
+	MemoryCardCachePage* const cachePage = GetCachedPage( page );
+	if ( cachePage == nullptr || !cachePage->dirty ) { return false; }
+
+	cachePage->dirty = false;
+	const size_t operationCount = m_flushOperations.size();
+	WriteWithoutCache( &cachePage->data.raw[0], page * PageSizeRaw, PageSize );
+
+	// pages going to a host file stay cached until the flush thread has written them
+	if ( m_flushOperations.size() == operationCount ) {
+		RemoveCachedPage( page );
 	}
-	return false;
+	return true;
 }
 
 bool FolderMemoryCard::FlushCluster( const u32 cluster ) {
@@ -960,10 +1147,7 @@ bool FolderMemoryCard::FlushBlock( const u32 block ) {
 void FolderMemoryCard::FlushSuperBlock() {
 	if ( FlushBlock( 0 ) && m_performFileWrites ) {
 		wxFileName superBlockFileName( m_folderName.GetPath(), L"_pcsx2_superblock" );
-		wxFFile superBlockFile( superBlockFileName.GetFullPath().c_str(), L"wb" );
-		if ( superBlockFile.IsOpened() ) {
-			superBlockFile.Write( &m_superBlock.raw, sizeof( m_superBlock.raw ) );
-		}
+		AddFlushOperation( FolderMemoryCardFlushOperation::WriteFile, &m_superBlock.raw[0], sizeof( m_superBlock.raw ) ).path = superBlockFileName.GetFullPath();
 	}
 }
 
@@ -996,21 +1180,12 @@ void FolderMemoryCard::FlushFileEntries( const u32 dirCluster, const u32 remaini
 
 				if ( m_performFileWrites ) {
 					// if this directory has nonstandard metadata, write that to the file system
-					wxFileName metaFileName( m_folderName.GetFullPath() + subDirPath + L"/_pcsx2_meta_directory" );
+					const wxString metaFilePath( m_folderName.GetFullPath() + subDirPath + L"/_pcsx2_meta_directory" );
 					if ( filenameCleaned || entry->entry.data.mode != MemoryCardFileEntry::DefaultDirMode || entry->entry.data.attr != 0 ) {
-						if ( !metaFileName.DirExists() ) {
-							metaFileName.Mkdir();
-						}
-						wxFFile metaFile( metaFileName.GetFullPath(), L"wb" );
-						if ( metaFile.IsOpened() ) {
-							metaFile.Write( entry->entry.raw, sizeof( entry->entry.raw ) );
-							metaFile.Close();
-						}
+						AddFlushOperation( FolderMemoryCardFlushOperation::WriteFile, entry->entry.raw, sizeof( entry->entry.raw ) ).path = metaFilePath;
 					} else {
 						// if metadata is standard make sure to remove a possibly existing metadata file
-						if ( metaFileName.FileExists() ) {
-							wxRemoveFile( metaFileName.GetFullPath() );
-						}
+						AddFlushOperation( FolderMemoryCardFlushOperation::RemoveFile ).path = metaFilePath;
 					}
 				}
 
@@ -1028,14 +1203,7 @@ void FolderMemoryCard::FlushFileEntries( const u32 dirCluster, const u32 remaini
 				const wxString filePath = dirPath + L"/" + wxString::FromAscii( (const char*)cleanName );
 
 				if ( m_performFileWrites ) {
-					wxFileName fn( m_folderName.GetFullPath() + filePath );
-					if ( !fn.FileExists() ) {
-						if ( !fn.DirExists() ) {
-							fn.Mkdir( 0777, wxPATH_MKDIR_FULL );
-						}
-						wxFFile createEmptyFile( fn.GetFullPath(), L"wb" );
-						createEmptyFile.Close();
-					}
+					AddFlushOperation( FolderMemoryCardFlushOperation::CreateEmptyFile ).path = m_folderName.GetFullPath() + filePath;
 				}
 			}
 		}
@@ -1070,12 +1238,9 @@ void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache( const s
 				const wxString fileName = wxString::FromAscii( cleanName );
 				const wxString filePath = m_folderName.GetFullPath() + dirPath + L"/" + fileName;
 				m_lastAccessedFile.CloseMatching( filePath );
-				const wxString newFilePath = m_folderName.GetFullPath() + dirPath + L"/_pcsx2_deleted_" + fileName;
-				if ( wxFileName::DirExists( newFilePath ) ) {
-					// wxRenameFile doesn't overwrite directories, so we have to remove the old one first
-					RemoveDirectory( newFilePath );
-				}
-				wxRenameFile( filePath, newFilePath );
+				FolderMemoryCardFlushOperation& op = AddFlushOperation( FolderMemoryCardFlushOperation::RenameToDeleted );
+				op.path = filePath;
+				op.newPath = m_folderName.GetFullPath() + dirPath + L"/_pcsx2_deleted_" + fileName;
 			} else if ( entry->IsDir() ) {
 				// still exists and is a directory, recursive call for subdir
 				char cleanName[sizeof( entry->entry.data.name )];
@@ -1108,13 +1273,11 @@ void FolderMemoryCard::RemoveUnchangedDataFromCache( const MemoryCardFileEntry*
 	while ( cluster != LastDataCluster ) {
 		for ( int i = 0; i < 2; ++i ) {
 			const u32 page = ( cluster + alloc_offset ) * 2 + i;
-			auto newIt = m_cache.find( page );
-			if ( newIt == m_cache.end() ) { continue; }
-			auto oldIt = m_oldDataCache.find( page );
-			if ( oldIt == m_oldDataCache.end() ) { continue; }
+			const MemoryCardCachePage* const cachePage = GetCachedPage( page );
+			if ( cachePage == nullptr || !cachePage->dirty ) { continue; }
 
-			if ( memcmp( &oldIt->second.raw[0], &newIt->second.raw[0], PageSize ) == 0 ) {
-				m_cache.erase( newIt );
+			if ( memcmp( &cachePage->oldData.raw[0], &cachePage->data.raw[0], PageSize ) == 0 ) {
+				RemoveCachedPage( page );
 			}
 		}
 
@@ -1176,34 +1339,16 @@ bool FolderMemoryCard::WriteToFile( const u8* src, u32 adr, u32 dataLength ) {
 		const u32 clusterNumber = it->second.consecutiveCluster;
 		
 		if ( m_performFileWrites ) {
-			wxFFile* file = m_lastAccessedFile.ReOpen( m_folderName, &it->second, true );
-			if ( file->IsOpened() ) {
-				const u32 clusterOffset = ( page % 2 ) * PageSize + offset;
-				const u32 fileSize = entry->entry.data.length;
-				const u32 fileOffsetStart = std::min( clusterNumber * ClusterSize + clusterOffset, fileSize );
-				const u32 fileOffsetEnd = std::min( fileOffsetStart + dataLength, fileSize );
-				const u32 bytesToWrite = fileOffsetEnd - fileOffsetStart;
-
-				wxFileOffset actualFileSize = file->Length();
-				if ( actualFileSize < fileOffsetStart ) {
-					file->Seek( actualFileSize );
-					const u32 diff = fileOffsetStart - actualFileSize;
-					u8 temp = 0xFF;
-					for ( u32 i = 0; i < diff; ++i ) {
-						file->Write( &temp, 1 );
-					}
-				}
-
-				const wxFileOffset fileOffset = file->Tell();
-				if ( fileOffset != fileOffsetStart ) {
-					file->Seek( fileOffsetStart );
-				}
-				if ( bytesToWrite > 0 ) {
-					file->Write( src, bytesToWrite );
-				}
-			} else {
-				return false;
-			}
+			const u32 clusterOffset = ( page % 2 ) * PageSize + offset;
+			const u32 fileSize = entry->entry.data.length;
+			const u32 fileOffsetStart = std::min( clusterNumber * ClusterSize + clusterOffset, fileSize );
+			const u32 fileOffsetEnd = std::min( fileOffsetStart + dataLength, fileSize );
+			const u32 bytesToWrite = fileOffsetEnd - fileOffsetStart;
+
+			// the actual write happens in WriteFlushOperations()
+			FolderMemoryCardFlushOperation& op = AddFlushOperation( FolderMemoryCardFlushOperation::WriteFileData, src, bytesToWrite );
+			op.fileRef = &it->second;
+			op.fileOffset = fileOffsetStart;
 		}
 
 		return true;
@@ -1386,6 +1531,142 @@ void FolderMemoryCard::WriteToFile( const wxString& filename ) {
 	targetFile.Close();
 }
 
+void FolderMemoryCard::Benchmark() {
+	static const u32 BenchFileSize = 512 * 1024;
+	static const int BenchRounds = 8;
+
+	const wxString folder = wxFileName::GetTempDir() + L"/pcsx2-mcdbench";
+	if ( wxDirExists( folder ) ) {
+		RemoveDirectory( folder );
+	}
+
+	// one save with a single 512kb file, so each round rewrites 1024 pages of file data
+	const wxString saveFolder = folder + L"/BENCHMARK";
+	if ( !wxFileName::Mkdir( saveFolder, 0777, wxPATH_MKDIR_FULL ) ) {
+		Console.Warning( L"(FolderMcd) Benchmark: couldn't create %s", WX_STR( saveFolder ) );
+		return;
+	}
+	{
+		// the superblock of a freshly formatted 8MB card, so the folder gets indexed
+		superBlockUnion superBlock;
+		memset( &superBlock, 0xFF, sizeof( superBlock ) );
+		memcpy( superBlock.data.magic, "Sony PS2 Memory Card Format ", sizeof( superBlock.data.magic ) );
+		memcpy( superBlock.data.version, "1.2.0.0\0\0\0\0\0", sizeof( superBlock.data.version ) );
+		superBlock.data.page_len = PageSize;
+		superBlock.data.pages_per_cluster = ClusterSize / PageSize;
+		superBlock.data.pages_per_block = BlockSize / PageSize;
+		superBlock.data.unused = 0xFF00;
+		superBlock.data.clusters_per_card = TotalClusters;
+		superBlock.data.alloc_offset = TotalClusters / 0x100 + 9;
+		superBlock.data.alloc_end = TotalClusters - 0x10 - superBlock.data.alloc_offset;
+		superBlock.data.rootdir_cluster = 0;
+		superBlock.data.backup_block1 = TotalBlocks - 1;
+		superBlock.data.backup_block2 = TotalBlocks - 2;
+		superBlock.data.ifc_list[0] = 8;
+		superBlock.data.card_type = 2;
+		superBlock.data.card_flags = 0x52;
+
+		wxFFile file( folder + L"/_pcsx2_superblock", L"wb" );
+		file.Write( &superBlock.raw[0], sizeof( superBlock.raw ) );
+	}
+	{
+		std::vector<u8> data( BenchFileSize, 0xA5 );
+		wxFFile file( saveFolder + L"/DATA.BIN", L"wb" );
+		file.Write( &data[0], data.size() );
+	}
+
+	std::unique_ptr<FolderMemoryCard> card( new FolderMemoryCard() );
+	AppConfig::McdOptions options;
+	options.Enabled = true;
+	options.Type = MemoryCardType::MemoryCard_Folder;
+	card->Open( folder, options, 0, false, L"" );
+
+	std::vector<u32> clusters;
+	for ( const auto& it : card->m_fileMetadataQuickAccess ) {
+		// skip the directory entry clusters
+		if ( it.second.consecutiveCluster != 0xFFFFFFFFu ) {
+			clusters.push_back( it.first + card->m_superBlock.data.alloc_offset );
+		}
+	}
+
+	u64 stallTotal = 0, stallMax = 0, writeTotal = 0, writeMax = 0;
+	for ( int round = 0; round < BenchRounds; ++round ) {
+		u8 page[PageSize];
+		memset( page, round, PageSize );
+		for ( const u32 cluster : clusters ) {
+			card->Save( page, cluster * ClusterSizeRaw, PageSize );
+			card->Save( page, cluster * ClusterSizeRaw + PageSizeRaw, PageSize );
+		}
+
+		// the emulation thread is blocked for BeginFlush(), the rest used to be part of the stall too
+		const u64 start = GetCPUTicks();
+		card->BeginFlush();
+		const u64 handedOver = GetCPUTicks();
+		card->FinishFlush();
+		const u64 written = GetCPUTicks();
+
+		stallTotal += handedOver - start;
+		stallMax = std::max( stallMax, handedOver - start );
+		writeTotal += written - handedOver;
+		writeMax = std::max( writeMax, written - handedOver );
+	}
+
+	card->Close( false );
+	card.reset();
+	RemoveDirectory( folder );
+
+	const double usecPerTick = 1000000.0 / GetTickFrequency();
+	Console.WriteLn( Color_StrongBlack, L"(FolderMcd) Flush benchmark (%d rounds of %u pages)", BenchRounds, (u32)clusters.size() * 2 );
+	Console.WriteLn( L"  emulation thread stall:  avg %8.0f us, max %8.0f us", stallTotal * usecPerTick / BenchRounds, stallMax * usecPerTick );
+	Console.WriteLn( L"  file system writes:      avg %8.0f us, max %8.0f us", writeTotal * usecPerTick / BenchRounds, writeMax * usecPerTick );
+}
+
+FolderMemoryCardFlushThread::FolderMemoryCardFlushThread( FolderMemoryCard& card )
+	: m_card( card ) {
+	m_name = L"FolderMcdFlush";
+	m_busy = false;
+	m_exit = false;
+}
+
+FolderMemoryCardFlushThread::~FolderMemoryCardFlushThread() {
+	try {
+		_parent::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void FolderMemoryCardFlushThread::OnStart() {
+	_parent::OnStart();
+	m_exit = false;
+}
+
+void FolderMemoryCardFlushThread::BeginFlush() {
+	m_busy = true;
+	m_sem_event.Post();
+}
+
+void FolderMemoryCardFlushThread::WaitForFlush() {
+	m_sem_finished.WaitWithoutYield();
+}
+
+void FolderMemoryCardFlushThread::Stop() {
+	if ( !IsRunning() ) { return; }
+
+	m_exit = true;
+	m_sem_event.Post();
+	Block();
+}
+
+void FolderMemoryCardFlushThread::ExecuteTaskInThread() {
+	while ( true ) {
+		m_sem_event.WaitWithoutYield();
+		if ( m_exit ) { return; }
+
+		m_card.WriteFlushOperations();
+		m_busy = false;
+		m_sem_finished.Post();
+	}
+}
 
 FileAccessHelper::FileAccessHelper() {
 	m_files.clear();
@@ -1616,6 +1897,10 @@ FolderMemoryCardAggregator::FolderMemoryCardAggregator() {
 }
 
 void FolderMemoryCardAggregator::Open() {
+	if ( EmuConfig.Profiler.Enabled && EmuConfig.Profiler.Bench_FolderMcd ) {
+		FolderMemoryCard::Benchmark();
+	}
+
 	for ( int i = 0; i < TotalCardSlots; ++i ) {
 		m_cards[i].Open( m_enableFiltering, m_lastKnownFilter );
 	}
@@ -20,7 +20,10 @@
 #include <wx/ffile.h>
 #include <map>
 #include <vector>
+#include <memory>
+#include <atomic>
 
+#include "Utilities/PersistentThread.h"
 #include "PluginCallbacks.h"
 #include "AppConfig.h"
 
@@ -179,6 +182,19 @@ struct MemoryCardPage {
 };
 #pragma pack(pop)
 
+// a page in FolderMemoryCard's write cache
+struct MemoryCardCachePage {
+	u32 page;
+	// set when the page was written to since the last flush; pages without it are only kept
+	// until the flush thread has written them to the file system
+	bool dirty;
+	MemoryCardPage data;
+	// contains the state of how the data looked before the first write to it
+	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
+	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
+	MemoryCardPage oldData;
+};
+
 struct MemoryCardFileEntryTreeNode {
 	MemoryCardFileEntry entry;
 	std::vector<MemoryCardFileEntryTreeNode> subdir;
@@ -250,11 +266,71 @@ protected:
 	void WriteMetadata( bool metadataIsNonstandard, wxFileName& metadataFilename, const MemoryCardFileEntry* const entry );
 };
 
+// --------------------------------------------------------------------------------------
+//  FolderMemoryCardFlushOperation
+// --------------------------------------------------------------------------------------
+// A change to the host file system recorded by FolderMemoryCard::Flush(), to be carried out
+// afterwards, usually on the FolderMemoryCardFlushThread.
+struct FolderMemoryCardFlushOperation {
+	enum OperationType {
+		WriteFile,       // (over)write the file at path with the attached data
+		RemoveFile,      // remove the file at path, if it exists
+		CreateEmptyFile, // create an empty file at path, if it doesn't exist yet
+		RenameToDeleted, // rename path to newPath, replacing a directory of that name
+		WriteFileData,   // write the attached data into the file of fileRef at fileOffset
+	};
+
+	OperationType type;
+	wxString path;
+	wxString newPath;
+	MemoryCardFileMetadataReference* fileRef;
+	u32 fileOffset;
+	size_t dataOffset; // position of the attached data in FolderMemoryCard::m_flushData
+	u32 dataLength;
+};
+
+class FolderMemoryCard;
+
+// --------------------------------------------------------------------------------------
+//  FolderMemoryCardFlushThread
+// --------------------------------------------------------------------------------------
+// Carries out the recorded operations of a FolderMemoryCard flush so the emulation thread
+// doesn't have to wait for the host file system.
+class FolderMemoryCardFlushThread : public Threading::pxThread {
+	typedef Threading::pxThread _parent;
+
+protected:
+	FolderMemoryCard& m_card;
+	Threading::Semaphore m_sem_event;
+	Threading::Semaphore m_sem_finished;
+	std::atomic<bool> m_busy;
+	std::atomic<bool> m_exit;
+
+public:
+	FolderMemoryCardFlushThread( FolderMemoryCard& card );
+	virtual ~FolderMemoryCardFlushThread();
+
+	// hands the card's recorded flush operations to the thread
+	void BeginFlush();
+	// true while the operations handed over by the last BeginFlush() are still being written
+	bool IsBusy() const { return m_busy; }
+	// waits for the flush started by the last BeginFlush(); must be called exactly once per BeginFlush()
+	void WaitForFlush();
+	// ends the thread, must not be called while a flush is in progress
+	void Stop();
+
+protected:
+	void OnStart();
+	void ExecuteTaskInThread();
+};
+
 // --------------------------------------------------------------------------------------
 //  FolderMemoryCard
 // --------------------------------------------------------------------------------------
 // Fakes a memory card using a regular folder/file structure in the host file system
 class FolderMemoryCard {
+	friend class FolderMemoryCardFlushThread;
+
 public:
 	// a few constants so we could in theory change the memory card size without too much effort
 	static const int IndirectFatClusterCount = 1; // should be 32 but only 1 is ever used
@@ -277,6 +353,8 @@ public:
 
 	static const int FramesAfterWriteUntilFlush = 2;
 
+	static const u32 CachePageUnused = 0xFFFFFFFFu;
+
 protected:
 	union superBlockUnion {
 		superblock data;
@@ -302,11 +380,19 @@ protected:
 	std::map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
 
 	// holds a copy of modified pages of the memory card before they're flushed to the file system
-	std::map<u32, MemoryCardPage> m_cache;
-	// contains the state of how the data looked before the first write to it
-	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
-	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
-	std::map<u32, MemoryCardPage> m_oldDataCache;
+	std::vector<MemoryCardCachePage> m_cache;
+	// index into m_cache for every memory card page, CachePageUnused if the page is not cached
+	std::vector<u32> m_cacheIndex;
+
+	// file system changes recorded by the last Flush() and the data they write
+	std::vector<FolderMemoryCardFlushOperation> m_flushOperations;
+	std::vector<u8> m_flushData;
+	// private copy of m_folderName and the file handles used while carrying out the above
+	wxFileName m_flushFolderName;
+	FileAccessHelper m_flushFileAccess;
+	// set while m_flushThread is working on the recorded operations
+	bool m_flushInProgress;
+	std::unique_ptr<FolderMemoryCardFlushThread> m_flushThread;
 	// if > 0, the amount of frames until data is flushed to the file system
 	// reset to FramesAfterWriteUntilFlush on each write
 	int m_framesUntilFlush;
@@ -375,6 +461,10 @@ public:
 
 	void WriteToFile( const wxString& filename );
 
+	// measures how long a flush of a burst of writes stalls the emulation thread, on a scratch
+	// card in the temp folder (see Profiler.Bench_FolderMcd)
+	static void Benchmark();
+
 protected:
 	// initializes memory card data, as if it was fresh from the factory
 	void InitializeInternalData();
@@ -482,9 +572,29 @@ protected:
 	bool WriteToFile( const u8* src, u32 adr, u32 dataLength );
 
 
-	// flush the whole cache to the internal data and/or host file system
+	// returns the cache entry of the given page, or nullptr if the page is not cached
+	MemoryCardCachePage* GetCachedPage( const u32 page );
+	// adds an (uninitialized) cache entry for the given page, which must not be cached yet
+	MemoryCardCachePage* AddCachedPage( const u32 page );
+	// removes the given page from the cache, if it is cached
+	void RemoveCachedPage( const u32 page );
+
+	// flush the whole cache to the internal data and record the resulting host file system changes
+	// in m_flushOperations, to be carried out by WriteFlushOperations()
 	void Flush();
 
+	// carries out and clears the operations recorded by Flush(); called on the flush thread, or directly when closing
+	void WriteFlushOperations();
+
+	// Flush(), then hands the recorded operations to the flush thread
+	void BeginFlush();
+
+	// waits for a flush handed to the flush thread to finish, and drops the cached pages it has written
+	void FinishFlush();
+
+	// records a file system change for WriteFlushOperations(), with an optional copy of data to write
+	FolderMemoryCardFlushOperation& AddFlushOperation( FolderMemoryCardFlushOperation::OperationType type, const u8* data = nullptr, u32 dataLength = 0 );
+
 	// flush a single page of the cache to the internal data and/or host file system
 	bool FlushPage( const u32 page );
 
@@ -291,6 +291,10 @@ Panels::VideoPanel::VideoPanel( wxWindow* parent ) :
 		_t("For troubleshooting potential bugs in the MTGS only, as it is potentially very slow.")
 	);
 
+	m_check_CoalesceGS = new pxCheckBox( left, _("Merge GS packets in the MTGS ring"),
+		_t("Sends adjacent packets of the same GIF path to the GS as one transfer.")
+	);
+
 	m_restore_defaults = new wxButton(right, wxID_DEFAULT, _("Restore Defaults"));
 
 	m_check_SynchronousGS->SetToolTip( pxEt( L"Enable this if you think MTGS thread sync is causing crashes or graphical errors.")
@@ -316,6 +320,7 @@ Panels::VideoPanel::VideoPanel( wxWindow* parent ) :
 	*left		+= m_fpan		| pxExpand;
 	*left		+= 5;
 	*left		+= m_check_SynchronousGS | StdExpand();
+	*left		+= m_check_CoalesceGS | StdExpand();
 
 	*s_table	+= left		| StdExpand();
 	*s_table	+= right	| StdExpand();
@@ -347,6 +352,7 @@ void Panels::VideoPanel::OnOpenWindowSettings( wxCommandEvent& evt )
 void Panels::VideoPanel::Apply()
 {
 	g_Conf->EmuOptions.GS.SynchronousMTGS	= m_check_SynchronousGS->GetValue();
+	g_Conf->EmuOptions.GS.CoalescePackets	= m_check_CoalesceGS->GetValue();
 }
 
 void Panels::VideoPanel::AppStatusEvent_OnSettingsApplied()
@@ -357,8 +363,10 @@ void Panels::VideoPanel::AppStatusEvent_OnSettingsApplied()
 void Panels::VideoPanel::ApplyConfigToGui( AppConfig& configToApply, int flags ){
 	
 	m_check_SynchronousGS->SetValue( configToApply.EmuOptions.GS.SynchronousMTGS );
+	m_check_CoalesceGS->SetValue( configToApply.EmuOptions.GS.CoalescePackets );
 
 	m_check_SynchronousGS->Enable(!configToApply.EnablePresets);
+	m_check_CoalesceGS->Enable(!configToApply.EnablePresets);
 
 	if( flags & AppConfig::APPLY_FLAG_MANUALLY_PROPAGATE )
 	{
@@ -15,9 +15,11 @@
 
 #include "PrecompiledHeader.h"
 #include "MemoryTypes.h"
+#include "Memory.h"
 #include "App.h"
 
 #include "System/SysThreads.h"
+#include "System/Timeline.h"
 #include "SaveState.h"
 #include "VUmicro.h"
 
@@ -56,6 +58,10 @@ public:
 	virtual void FreezeIn( pxInputStream& reader ) const=0;
 	virtual void FreezeOut( SaveStateBase& writer ) const=0;
 	virtual bool IsRequired() const=0;
+
+	// Data written to the archive as is instead of through FreezeOut, or NULL (see the
+	// incremental savestate snapshot below).
+	virtual const u8* GetSnapshot( uint& size ) const { return NULL; }
 };
 
 class MemorySavestateEntry : public BaseSavestateEntry
@@ -137,6 +143,59 @@ void PluginSavestateEntry::FreezeOut( SaveStateBase& writer ) const
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  Incremental savestate snapshot
+// --------------------------------------------------------------------------------------
+// With EmuConfig.IncrementalSavestates, EE and IOP main memory go into the archive from a copy
+// which is kept from one save to the next.  Refreshing it only copies the pages written since
+// the previous save (see mmap_CopyDirtyPages), so the core is paused for a fraction of the 34MB
+// copy.  The compress thread reads the copy directly, which is why downloads hold
+// mtx_CompressToDisk while refreshing it.
+
+static SafeArray<u8> s_SnapshotEE( L"Savestate snapshot (EE memory)" );
+static SafeArray<u8> s_SnapshotIOP( L"Savestate snapshot (IOP memory)" );
+static u64 s_SnapshotGeneration = 0;
+// dirty tracking stats at the previous refresh, valid while the generation matches
+static DirtyTrackStats s_SnapshotStats;
+// set while the current download writes memory from the snapshot
+static bool s_SnapshotInUse = false;
+
+static void RefreshStateSnapshot()
+{
+	static const uint TotalPages = (sizeof(eeMem->Main) + sizeof(iopMem->Main)) / __pagesize;
+	const u64 start = GetCPUTicks();
+	const double tickMs = 1000.0 / GetTickFrequency();
+
+	// the dirty bits only cover the changes since the checkpoint made by the previous refresh
+	if( s_SnapshotEE.IsDisposed() || s_SnapshotGeneration != mmap_GetDirtyGeneration() )
+	{
+		s_SnapshotEE.ExactAlloc( sizeof(eeMem->Main) );
+		s_SnapshotIOP.ExactAlloc( sizeof(iopMem->Main) );
+		memcpy( s_SnapshotEE.GetPtr(), eeMem->Main, sizeof(eeMem->Main) );
+		memcpy( s_SnapshotIOP.GetPtr(), iopMem->Main, sizeof(iopMem->Main) );
+
+		DevCon.WriteLn( "(SysState) Incremental savestate: full copy of %u memory pages in %.2f ms.",
+			TotalPages, (GetCPUTicks() - start) * tickMs );
+	}
+	else
+	{
+		uint copied;
+		copied  = mmap_CopyDirtyPages( DirtyTrack_EERam, s_SnapshotEE.GetPtr() );
+		copied += mmap_CopyDirtyPages( DirtyTrack_IOPRam, s_SnapshotIOP.GetPtr() );
+
+		// tracking pays off while the faults cost less than copying the clean pages would
+		const DirtyTrackStats& stats = mmap_GetDirtyTrackStats();
+		DevCon.WriteLn( "(SysState) Incremental savestate: copied %u of %u memory pages in %.2f ms, "
+			"%u write faults took %.2f ms since the last save.",
+			copied, TotalPages, (GetCPUTicks() - start) * tickMs,
+			(u32)(stats.Faults - s_SnapshotStats.Faults), (stats.FaultTicks - s_SnapshotStats.FaultTicks) * tickMs );
+	}
+
+	mmap_DirtyCheckpoint();
+	s_SnapshotGeneration = mmap_GetDirtyGeneration();
+	s_SnapshotStats = mmap_GetDirtyTrackStats();
+}
+
 // --------------------------------------------------------------------------------------
 //  SavestateEntry_* (EmotionMemory, IopMemory, etc)
 // --------------------------------------------------------------------------------------
@@ -160,6 +219,13 @@ public:
 		SysClearExecutionCache();
 		MemorySavestateEntry::FreezeIn( reader );
 	}
+
+	virtual const u8* GetSnapshot( uint& size ) const
+	{
+		if( !s_SnapshotInUse ) return NULL;
+		size = s_SnapshotEE.GetSizeInBytes();
+		return s_SnapshotEE.GetPtr();
+	}
 };
 
 class SavestateEntry_IopMemory : public MemorySavestateEntry
@@ -170,6 +236,13 @@ public:
 	wxString GetFilename() const		{ return L"iopMemory.bin"; }
 	u8* GetDataPtr() const				{ return iopMem->Main; }
 	uint GetDataSize() const			{ return sizeof(iopMem->Main); }
+
+	virtual const u8* GetSnapshot( uint& size ) const
+	{
+		if( !s_SnapshotInUse ) return NULL;
+		size = s_SnapshotIOP.GetSizeInBytes();
+		return s_SnapshotIOP.GetPtr();
+	}
 };
 
 class SavestateEntry_HwRegs : public MemorySavestateEntry
@@ -328,6 +401,14 @@ public:
 protected:
 	void InvokeEvent()
 	{
+		TraceEvents::Scope trace( Timeline::Executor, "Savestate download" );
+
+		// The snapshot can't change while the previous save is still being compressed.  Waiting
+		// for that before pausing keeps the core running in the meantime.
+		ScopedLock lock_snapshot;
+		if( EmuConfig.IncrementalSavestates )
+			lock_snapshot.AssignAndLock( mtx_CompressToDisk );
+
 		ScopedCoreThreadPause paused_core;
 
 		if( !SysHasValidState() )
@@ -345,8 +426,22 @@ protected:
 		internals.SetDataSize( saveme.GetCurrentPos() - internals.GetDataIndex() );
 		m_dest_list->Add( internals );
 
+		s_SnapshotInUse = lock_snapshot.IsLocked() && mmap_IsDirtyTracking();
+		if( s_SnapshotInUse )
+			RefreshStateSnapshot();
+
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
+			uint snapshotSize;
+			if (const u8* snapshot = SavestateEntries[i]->GetSnapshot( snapshotSize ))
+			{
+				m_dest_list->Add( ArchiveEntry( SavestateEntries[i]->GetFilename() )
+					.SetExternalData( snapshot )
+					.SetDataSize( snapshotSize )
+				);
+				continue;
+			}
+
 			uint startpos = saveme.GetCurrentPos();
 			SavestateEntries[i]->FreezeOut( saveme );
 			m_dest_list->Add( ArchiveEntry( SavestateEntries[i]->GetFilename() )
@@ -355,6 +450,8 @@ protected:
 			);
 		}
 
+		s_SnapshotInUse = false;
+
 		UI_EnableStateActions();
 		paused_core.AllowResume();
 	}
@@ -427,6 +524,8 @@ public:
 protected:
 	void InvokeEvent()
 	{
+		TraceEvents::Scope trace( Timeline::Executor, "Savestate zip setup" );
+
 		// Provisionals for scoped cleanup, in case of exception:
 		std::unique_ptr<ArchiveEntryList> elist(m_src_list);
 
@@ -513,6 +612,7 @@ public:
 protected:
 	void InvokeEvent()
 	{
+		TraceEvents::Scope trace( Timeline::Executor, "Savestate unzip" );
 		ScopedLock lock( mtx_CompressToDisk );
 
 		// Ugh.  Exception handling made crappy because wxWidgets classes don't support scoped pointers yet.
@@ -616,6 +716,8 @@ protected:
 		GetCoreThread().Pause();
 		SysClearExecutionCache();
 
+		TraceEvents::Scope upload( Timeline::Executor, "Savestate upload" );
+
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
 			if (!foundEntry[i]) continue;
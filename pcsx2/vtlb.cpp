@@ -655,6 +655,20 @@ __fi void* vtlb_GetPhyPtr(u32 paddr)
 		return reinterpret_cast<void*>(vtlbdata.pmap[paddr>>VTLB_PAGE_BITS]+(paddr&VTLB_PAGE_MASK));
 }
 
+// Returns the host memory behind an EE virtual address, or NULL if the page is mapped to
+// a handler or if accesses have to go through the interpreter's cache emulation.
+void* vtlb_GetVirtPtr(u32 vaddr)
+{
+	if (!CHECK_EEREC && CHECK_CACHE)
+		return NULL;
+
+	sptr ppf = vaddr + vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS];
+	if (ppf < 0)
+		return NULL;
+
+	return reinterpret_cast<void*>(ppf);
+}
+
 __fi u32 vtlb_V2P(u32 vaddr)
 {
 	u32 paddr = vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS];
@@ -670,6 +684,8 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 	verify(0==(paddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	cacheInvalidateFastTags();
+
 	while (size > 0)
 	{
 		sptr pme;
@@ -704,6 +720,8 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	verify(0==(vaddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	cacheInvalidateFastTags();
+
 	uptr bu8 = (uptr)buffer;
 	while (size > 0)
 	{
@@ -719,6 +737,8 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 	verify(0==(vaddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	cacheInvalidateFastTags();
+
 	while (size > 0)
 	{
 		u32 handl = UnmappedVirtHandler0;
@@ -12,11 +12,12 @@
 
 #include "gdxsv_network.h"
 #include "gdx_rpc.h"
+#include "Utilities/Telemetry.h"
 
 class GdxsvBackendUdp {
 public:
 	GdxsvBackendUdp(const std::map<std::string, u32>& symbols, std::atomic<int>& maxlag)
-		: symbols_(symbols), maxlag_(maxlag) {
+		: symbols_(symbols), maxlag_(maxlag), telemetry_rtt_("netplay.rtt_ms"), telemetry_maxlag_("netplay.maxlag") {
 	}
 
 	~GdxsvBackendUdp() {
@@ -199,6 +200,7 @@ private:
 					NOTICE_LOG(COMMON, "PING AVG %.2f ms", rtt);
 					maxlag_ = std::min<int>(0x7f, std::max(5, 4 + (int)std::floor(rtt / 16)));
 					NOTICE_LOG(COMMON, "set maxlag %d", (int)maxlag_);
+					telemetry_maxlag_.Set(maxlag_);
 
 #ifdef DC_PLATFORM_DREAMCAST
 					char osd_msg[128] = {};
@@ -272,6 +274,7 @@ private:
 					auto rtt = static_cast<float>(t2 - pkt.pong_data().timestamp());
 					ping_recv_count++;
 					rtt_sum += rtt;
+					telemetry_rtt_.Record(static_cast<u64>(rtt));
 				}
 											 break;
 
@@ -318,6 +321,8 @@ private:
 
 	std::string session_id_;
 	std::atomic<int>& maxlag_;
+	Telemetry::Histogram telemetry_rtt_;
+	Telemetry::Gauge telemetry_maxlag_;
 	std::atomic<bool> net_terminate_;
 	std::mutex send_buf_mtx_;
 	std::mutex recv_buf_mtx_;
@@ -0,0 +1,232 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "IopCommon.h"
+#include "R3000A_Profiler.h"
+#include "Plugins.h"
+#include "Utilities/AsciiFile.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace x86Emitter;
+
+iopProfiler IOP::Profiler;
+
+// Functions further than this past the closest export are reported as unknown
+static const u32 MaxExportDistance = 0x10000;
+
+// Number of blocks and libraries listed on the console, the file gets all of them
+static const uint ConsoleReportLines = 30;
+
+iopProfiler::iopProfiler()
+{
+	m_enabled = false;
+	m_current = NULL;
+}
+
+// Drops the counts gathered so far, called when a game starts.  The names are kept, since
+// the IRX modules which registered them may still be loaded.  Live blocks are referenced by
+// the code cache, so their counters are cleared in place.
+void iopProfiler::Reset()
+{
+	m_totals.clear();
+
+	for (Block& block : m_blocks)
+		block.entries = 0;
+}
+
+// Called whenever the IOP code cache is flushed.  The counters of the flushed blocks are
+// folded into the totals, and the profiler starts over if it has just been enabled.
+void iopProfiler::OnRecReset()
+{
+	const bool enabled = EmuConfig.Profiler.Enabled && EmuConfig.Profiler.RecBlocks_IOP;
+
+	if (enabled && !m_enabled)
+		m_totals.clear();
+	else
+		Fold();
+
+	m_blocks.clear();
+	m_current = NULL;
+	m_enabled = enabled;
+}
+
+void iopProfiler::EmitBlock(u32 startpc)
+{
+	m_current = NULL;
+	if (!m_enabled) return;
+
+	m_blocks.push_back(Block());
+	m_current = &m_blocks.back();
+	m_current->startpc = startpc;
+	m_current->cycles = 0;
+	m_current->entries = 0;
+
+	xADD(ptr32[&(((u32*)&m_current->entries)[0])], 1);
+	xADC(ptr32[&(((u32*)&m_current->entries)[1])], 0);
+}
+
+void iopProfiler::EndBlock(u32 cycles)
+{
+	if (m_current)
+		m_current->cycles = cycles;
+}
+
+// Names the import stub at stubpc.  Stubs are two instructions (a jump to the linked
+// export and the addiu which holds the index), so every call through an import shows up as
+// one entry of the stub's block.
+void iopProfiler::AddImport(u32 stubpc, const std::string& libname, u16 index)
+{
+	if (!m_enabled) return;
+
+	const char* funcname = irxImportFuncname(libname, index);
+	m_imports[stubpc] = funcname ? libname + "." + funcname : libname + "." + std::to_string(index);
+}
+
+static void __fastcall iopProfilerRegisterLibrary()
+{
+	IOP::Profiler.RegisterLibrary(psxRegs.GPR.n.a0);
+}
+
+irxDEBUG iopProfiler::ImportHook(const std::string& libname, u16 index) const
+{
+	if (m_enabled && libname == "loadcore" && index == 6)
+		return iopProfilerRegisterLibrary;
+
+	return NULL;
+}
+
+// Records the functions of an export table passed to loadcore's RegisterLibraryEntries.
+// The table holds the library name at +12, followed by the function addresses up to a null.
+void iopProfiler::RegisterLibrary(u32 table)
+{
+	const std::string libname = iopMemReadString(table + 12, 8);
+
+	for (u16 index = 0; index < 256; index++)
+	{
+		u32 addr = iopMemRead32(table + 20 + index * 4);
+		if (!addr) break;
+
+		const char* funcname = irxImportFuncname(libname, index);
+		m_exports[addr & 0x1fffffff] = funcname ? libname + "." + funcname : libname + "." + std::to_string(index);
+	}
+}
+
+std::string iopProfiler::Resolve(u32 pc) const
+{
+	pc &= 0x1fffffff;
+
+	auto import = m_imports.find(pc);
+	if (import != m_imports.end())
+		return import->second + " (import)";
+
+	auto it = m_exports.upper_bound(pc);
+	if (it == m_exports.begin())
+		return "?";
+	--it;
+
+	u32 offset = pc - it->first;
+	if (offset >= MaxExportDistance)
+		return "?";
+	if (!offset)
+		return it->second;
+
+	char buf[16];
+	sprintf(buf, "+0x%x", offset);
+	return it->second + buf;
+}
+
+void iopProfiler::Fold()
+{
+	for (const Block& block : m_blocks)
+	{
+		if (!block.entries) continue;
+
+		Totals& totals = m_totals[block.startpc];
+		totals.entries += block.entries;
+		totals.cycles += block.entries * block.cycles;
+		totals.name = Resolve(block.startpc);
+	}
+}
+
+void iopProfiler::Print()
+{
+	if (!m_enabled && m_totals.empty()) return;
+
+	// The live blocks are still referenced by the code cache, so fold them into a copy
+	std::map<u32, Totals> totals(m_totals);
+	for (const Block& block : m_blocks)
+	{
+		if (!block.entries) continue;
+
+		Totals& t = totals[block.startpc];
+		t.entries += block.entries;
+		t.cycles += block.entries * block.cycles;
+		t.name = Resolve(block.startpc);
+	}
+
+	u64 total = 0;
+	std::vector< std::pair<u64, u32> > blocks;
+	std::map<std::string, u64> libraries;
+	for (const auto& it : totals)
+	{
+		total += it.second.cycles;
+		blocks.push_back(std::make_pair(it.second.cycles, it.first));
+
+		const std::string& name = it.second.name;
+		libraries[name.substr(0, name.find('.'))] += it.second.cycles;
+	}
+	if (!total) return;
+
+	std::sort(blocks.begin(), blocks.end(), std::greater< std::pair<u64, u32> >());
+
+	std::vector< std::pair<u64, std::string> > libs;
+	for (const auto& it : libraries)
+		libs.push_back(std::make_pair(it.second, it.first));
+	std::sort(libs.begin(), libs.end(), std::greater< std::pair<u64, std::string> >());
+
+	// The core knows the logs folder through the plugin manager, which gets it from the UI
+	const wxString logs(GetCorePlugins().GetLogFolder());
+	if (!logs.IsEmpty())
+		wxDirName(logs).Mkdir();
+	AsciiFile f(Path::Combine(logs, L"iopProfile.txt"), L"w");
+
+	DevCon.WriteLn("IOP Profiler: %u blocks, %llu cycles", (u32)blocks.size(), (unsigned long long)total);
+	f.Printf("IOP Profiler: %u blocks, %llu cycles\n\nLibraries:\n", (u32)blocks.size(), (unsigned long long)total);
+
+	for (uint i = 0; i < libs.size(); i++)
+	{
+		double stat = (double)libs[i].first / (double)total * 100.0;
+		if (i < ConsoleReportLines)
+			DevCon.WriteLn("  %-12s [%3.4f%%]", libs[i].second.c_str(), stat);
+		f.Printf("  %-12s [%3.4f%%][cycles=%llu]\n", libs[i].second.c_str(), stat, (unsigned long long)libs[i].first);
+	}
+
+	DevCon.WriteLn("IOP Profiler, blocks:");
+	f.Printf("\nBlocks:\n");
+
+	for (uint i = 0; i < blocks.size(); i++)
+	{
+		const Totals& t = totals[blocks[i].second];
+		double stat = (double)blocks[i].first / (double)total * 100.0;
+		if (i < ConsoleReportLines)
+			DevCon.WriteLn("  %08x %-40s [%3.4f%%][count=%llu]", blocks[i].second, t.name.c_str(), stat, (unsigned long long)t.entries);
+		f.Printf("  %08x %-40s [%3.4f%%][count=%llu][cycles=%llu]\n", blocks[i].second, t.name.c_str(), stat,
+			(unsigned long long)t.entries, (unsigned long long)blocks[i].first);
+	}
+}
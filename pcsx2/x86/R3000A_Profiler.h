@@ -0,0 +1,87 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Defs.h"
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include "IopBios.h"
+
+// --------------------------------------------------------------------------------------
+//  iopProfiler
+// --------------------------------------------------------------------------------------
+// Per-block profiling for the IOP recompiler, enabled by Profiler.Enabled and
+// Profiler.RecBlocks_IOP.  Every block gets an entry counter bumped by its own code, and
+// the block's cycle count is known at compile time, so entries * cycles gives the IOP time
+// spent in it.
+//
+// Blocks are named after the IRX module functions they belong to: exported functions are
+// learned from loadcore's RegisterLibraryEntries at runtime, and import stubs are named when
+// they're compiled.  The sorted report goes to the dev console and to iopProfile.txt in the
+// logs folder.
+//
+class iopProfiler
+{
+protected:
+	struct Block
+	{
+		u32 startpc;
+		u32 cycles;		// scaled IOP cycles of one pass through the block
+		u64 entries;
+	};
+
+	struct Totals
+	{
+		u64 entries;
+		u64 cycles;
+		std::string name;
+	};
+
+	bool m_enabled;
+	Block* m_current;
+
+	std::deque<Block> m_blocks;			// blocks in the current code cache
+	std::map<u32, Totals> m_totals;		// by startpc, from previous code caches
+	std::map<u32, std::string> m_exports;	// function address -> "library.function"
+	std::map<u32, std::string> m_imports;	// import stub address -> "library.function"
+
+public:
+	iopProfiler();
+
+	bool IsEnabled() const { return m_enabled; }
+
+	void Reset();
+	void OnRecReset();
+
+	void EmitBlock(u32 startpc);
+	void EndBlock(u32 cycles);
+
+	void AddImport(u32 stubpc, const std::string& libname, u16 index);
+	irxDEBUG ImportHook(const std::string& libname, u16 index) const;
+	void RegisterLibrary(u32 table);
+
+	void Print();
+
+protected:
+	void Fold();
+	std::string Resolve(u32 pc) const;
+};
+
+namespace IOP {
+	extern iopProfiler Profiler;
+}
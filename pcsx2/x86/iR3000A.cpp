@@ -21,8 +21,10 @@
 #include "PrecompiledHeader.h"
 
 #include "iR3000A.h"
+#include "R3000A_Profiler.h"
 #include "BaseblockEx.h"
 #include "System/RecTypes.h"
+#include "System/Timeline.h"
 #include "Debugger/GundamDXDebug.h"
 
 #include <time.h>
@@ -516,6 +518,7 @@ static void psxRecompileIrxImport()
 	const std::string libname = iopMemReadString(import_table + 12, 8);
 
 	irxHLE hle = irxImportHLE(libname, index);
+	int fastpath = hle ? -1 : irxImportFastPath(libname, index);
 #ifdef PCSX2_DEVBUILD
 	const irxDEBUG debug = irxImportDebug(libname, index);
 	const char* funcname = irxImportFuncname(libname, index);
@@ -523,8 +526,11 @@ static void psxRecompileIrxImport()
 	const irxDEBUG debug = 0;
 	const char *funcname = nullptr;
 #endif
+	const irxDEBUG profile = IOP::Profiler.ImportHook(libname, index);
 
-	if (!hle && !debug && (!SysTraceActive(IOP.Bios) || !funcname))
+	IOP::Profiler.AddImport(psxpc - 8, libname, index);
+
+	if (!hle && (fastpath < 0) && !debug && !profile && (!SysTraceActive(IOP.Bios) || !funcname))
 		return;
 
 	// gdx_on_load_irx(funcname, import_table, index);
@@ -542,11 +548,20 @@ static void psxRecompileIrxImport()
 	if (debug)
 		xFastCall((void *)debug);
 
+	if (profile)
+		xFastCall((void *)profile);
+
 	if (hle) {
 		xFastCall((void *)hle);
 		xTEST(eax, eax);
 		xJNZ(iopDispatcherReg);
 	}
+
+	if (fastpath >= 0) {
+		xFastCall((void *)irxFastPathExec, (u32)fastpath);
+		xTEST(eax, eax);
+		xJNZ(iopDispatcherReg);
+	}
 }
 
 // rt = rs op imm16
@@ -688,6 +703,8 @@ void recResetIOP()
 
 	Perf::iop.reset();
 
+	IOP::Profiler.OnRecReset();
+
 	recAlloc();
 	recMem->Reset();
 
@@ -1075,6 +1092,8 @@ static void __fastcall  PreBlockCheck( u32 blockpc )
 
 static void __fastcall iopRecRecompile( const u32 startpc )
 {
+	TraceEvents::Scope trace(Timeline::EE, "IOP recompile");
+
 	u32 i;
 	u32 willbranch3 = 0;
 
@@ -1118,6 +1137,8 @@ static void __fastcall iopRecRecompile( const u32 startpc )
 	s_pCurBlock->SetFnptr( (uptr)x86Ptr );
 	s_psxBlockCycles = 0;
 
+	IOP::Profiler.EmitBlock(startpc);
+
 	// reset recomp state variables
 	psxpc = startpc;
 	g_psxHasConstReg = g_psxFlushedConstReg = 1;
@@ -1255,6 +1276,8 @@ StartRecomp:
 	if( IsDebugBuild && (psxdump & 1) )
 		iIopDumpBlock(startpc, recPtr);
 
+	IOP::Profiler.EndBlock(psxScaleBlockCycles());
+
 	pxAssert( (psxpc-startpc)>>2 <= 0xffff );
 	s_pCurBlockEx->size = (psxpc-startpc)>>2;
 
@@ -22,12 +22,14 @@
 #include "R5900OpcodeTables.h"
 #include "iR5900.h"
 #include "BaseblockEx.h"
+#include "R3000A_Profiler.h"
 #include "System/RecTypes.h"
 
 #include "vtlb.h"
 #include "Dump.h"
 
 #include "System/SysThreads.h"
+#include "System/Timeline.h"
 #include "GS.h"
 #include "CDVD/CDVD.h"
 #include "Elfheader.h"
@@ -730,6 +732,7 @@ static void recExecute()
 #endif
 
 	EE::Profiler.Print();
+	IOP::Profiler.Print();
 }
 
 ////////////////////////////////////////////////////
@@ -1173,6 +1176,19 @@ void __fastcall dynarecMemLogcheck(u32 start, bool store)
 		DevCon.WriteLn("Hit load breakpoint @0x%x", start);
 }
 
+// Out of line part of recMemcheck, only reached for accesses to pages with a memcheck.
+template<bool store>
+static void __fastcall dynarecMemcheckRange(u32 addr, u32 size)
+{
+	u32 start = standardizeBreakpointAddress(addr);
+	MemCheckResult result = CBreakPoints::CheckMemAccess(start, size, store);
+
+	if (result & MEMCHECK_LOG)
+		dynarecMemLogcheck(start, store);
+	if (result & MEMCHECK_BREAK)
+		dynarecMemcheck();
+}
+
 void recMemcheck(u32 op, u32 bits, bool store)
 {
 	iFlushCall(FLUSH_EVERYTHING|FLUSH_PC);
@@ -1184,46 +1200,18 @@ void recMemcheck(u32 op, u32 bits, bool store)
 	if (bits == 128)
 		xAND(ecx, ~0x0F);
 
-	xFastCall((void*)standardizeBreakpointAddress, ecx);
-	xMOV(ecx,eax);
-	xMOV(edx,eax);
-	xADD(edx,bits/8);
-
 	// ecx = access address
-	// edx = access address+size
-
-	auto checks = CBreakPoints::GetMemChecks();
-	for (size_t i = 0; i < checks.size(); i++)
-	{
-		if (checks[i].result == 0)
-			continue;
-		if ((checks[i].cond & MEMCHECK_WRITE) == 0 && store)
-			continue;
-		if ((checks[i].cond & MEMCHECK_READ) == 0 && !store)
-			continue;
-
-		// logic: memAddress < bpEnd && bpStart < memAddress+memSize
-
-		xMOV(eax,standardizeBreakpointAddress(checks[i].end));
-		xCMP(ecx,eax);				// address < end
-		xForwardJGE8 next1;			// if address >= end then goto next1
 
-		xMOV(eax,standardizeBreakpointAddress(checks[i].start));
-		xCMP(eax,edx);				// start < address+size
-		xForwardJGE8 next2;			// if start >= address+size then goto next2
+	// page bitmap test, the range checks only run for pages that have a memcheck
+	xMOV(eax, ecx);
+	xSHR(eax, 12);
+	xBT(ptr[(void*)CBreakPoints::GetMemCheckPages()], eax);
+	xForwardJNC8 skip;
 
-		// hit the breakpoint
-		if (checks[i].result & MEMCHECK_LOG) {
-			xMOV(edx, store);
-			xFastCall((void*)dynarecMemLogcheck, ecx, edx);
-		}
-		if (checks[i].result & MEMCHECK_BREAK) {
-			xFastCall((void*)dynarecMemcheck);
-		}
+	xMOV(edx, bits/8);
+	xFastCall(store ? (void*)dynarecMemcheckRange<true> : (void*)dynarecMemcheckRange<false>, ecx, edx);
 
-		next1.SetTarget();
-		next2.SetTarget();
-	}
+	skip.SetTarget();
 }
 
 void encodeBreakpoint()
@@ -1613,6 +1601,8 @@ void doPlace0Patches()
 
 static void __fastcall recRecompile( const u32 startpc )
 {
+	TraceEvents::Scope trace(Timeline::EE, "EE recompile");
+
 	u32 i = 0;
 	u32 willbranch3 = 0;
 	u32 usecop2;
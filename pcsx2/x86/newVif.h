@@ -79,3 +79,4 @@ extern __aligned16 nVifCall nVifUpk[(2*2*16)*4]; // ([USN][Masking][Unpack Type]
 extern __aligned16 u32		nVifMask[3][4][4];	 // [MaskNumber][CycleNumber][Vector]
 
 static const bool newVifDynaRec = 1; // Use code in newVif_Dynarec.inl
+static const bool newVifAVX2   = 1; // Unpack 2 quadwords per AVX2 op (V4-32/V4-16) when available
@@ -22,12 +22,196 @@
 #include "MTVU.h"
 #include "Utilities/Perf.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+// Hot block persistence (see EmuConfig.Cpu.Recompiler.PersistVifUnpack)
+// The compiled code itself isn't saved (it embeds host addresses), only the keys
+// of the most used blocks, which get recompiled when the cache is reset.
+//
+// The keys are kept in memory (s_hotBlocks) and only read from/written to disk by
+// the core thread when a game starts and when the core thread shuts down, since the
+// cache resets can happen during emulation (and on the MTVU thread for VIF1).
+static const u32 HotBlocksMagic   = 0x4B50556E; // 'nUPK'
+static const u32 HotBlocksVersion = 1;
+static const u32 HotBlocksMax     = 512; // Max amount of blocks saved
+static const u32 HotBlocksMinUses = 32;  // Min amount of executions to be saved
+
+struct HotBlockKey {
+	u32 hash_key;
+	u32 key0;
+	u32 key1;
+
+	bool operator<(const HotBlockKey& right) const {
+		if (hash_key != right.hash_key) return hash_key < right.hash_key;
+		if (key0     != right.key0)     return key0     < right.key0;
+		return key1 < right.key1;
+	}
+	bool operator==(const HotBlockKey& right) const {
+		return hash_key == right.hash_key && key0 == right.key0 && key1 == right.key1;
+	}
+};
+
+struct HotBlock {
+	HotBlockKey key;
+	u64         uses;
+};
+
+static std::mutex            s_hotBlocksLock;
+static std::vector<HotBlock> s_hotBlocks[2];        // Sorted by uses, most used first
+static std::atomic<bool>     s_hotBlocksPending[2]; // Loaded but not precompiled yet
+
+static wxString dVifHotBlocksFilename(const wxString& folder, int idx) {
+	return Path::Combine(folder, wxsFormat(L"vif%d_unpack.bin", idx));
+}
+
+static void dVifPrintStats(int idx) {
+	const HashBucket&      blocks = nVif[idx].vifBlocks;
+	const HashBucketStats& stats  = blocks.stats();
+	if (!stats.compiles && !stats.precompiles) return;
+
+	const u64 lookups = stats.hits + stats.misses;
+	DevCon.WriteLn("nVif%d: Unpack cache [blocks=%u][compiles=%llu][precompiled=%llu][hits=%llu (%.2f%%)][probes/lookup=%.3f]",
+		idx, blocks.size(), stats.compiles, stats.precompiles, stats.hits,
+		lookups ? 100.0 * stats.hits / lookups : 0.0,
+		lookups ? (double)stats.probes / lookups : 0.0);
+}
+
+// Merges the hot blocks of the current cache into the in-memory list (no I/O).
+// Must be called while the cache isn't in use.
+static void dVifCollectHotBlocks(int idx) {
+	std::vector<HotBlock> hot;
+	nVif[idx].vifBlocks.for_each([&](const nVifBlock& block, u64 uses) {
+		if (uses >= HotBlocksMinUses)
+			hot.push_back(HotBlock{HotBlockKey{block.hash_key, block.key0, block.key1}, uses});
+	});
+	if (hot.empty()) return;
+
+	std::lock_guard<std::mutex> lock(s_hotBlocksLock);
+	std::vector<HotBlock>& list = s_hotBlocks[idx];
+
+	list.insert(list.end(), hot.begin(), hot.end());
+	std::sort(list.begin(), list.end(), [](const HotBlock& a, const HotBlock& b) {
+		return a.key < b.key;
+	});
+
+	// Sum the uses of the blocks present in both lists
+	size_t count = 0;
+	for (size_t i = 0; i < list.size(); i++) {
+		if (count && list[count - 1].key == list[i].key)
+			list[count - 1].uses += list[i].uses;
+		else
+			list[count++] = list[i];
+	}
+	list.resize(count);
+
+	std::sort(list.begin(), list.end(), [](const HotBlock& a, const HotBlock& b) {
+		return a.uses > b.uses;
+	});
+	if (list.size() > HotBlocksMax) list.resize(HotBlocksMax);
+}
+
+_vifT static nVifBlock* dVifCompile(nVifBlock& block, bool isFill);
+
+// Compiles the blocks of the in-memory list into the cache (on the thread which owns it)
+static void dVifPrecompileHotBlocks(int idx) {
+	std::lock_guard<std::mutex> lock(s_hotBlocksLock);
+	nVifStruct& v = nVif[idx];
+
+	s_hotBlocksPending[idx] = false;
+
+	for (const HotBlock& hot : s_hotBlocks[idx]) {
+		// Leave room for the emulation, precompiling must never trigger a cache reset
+		if (v.recWritePtr > (v.recReserve->GetPtrEnd() - _1mb)) break;
+
+		nVifBlock block;
+		memzero(block);
+		block.hash_key = (u16)hot.key.hash_key;
+		block.key0     = hot.key.key0;
+		block.key1     = hot.key.key1;
+		if ((block.upkType & 0xf) == 3 || (block.upkType & 0xf) == 7 || (block.upkType & 0xf) == 11)
+			continue; // Invalid unpacks, don't trust the file
+		if (v.vifBlocks.peek(block)) continue;
+
+		const int  wl     = block.wl ? block.wl : 256;
+		const bool isFill = (block.cl < wl);
+		if (idx) dVifCompile<1>(block, isFill);
+		else     dVifCompile<0>(block, isFill);
+		v.vifBlocks.precompiled();
+	}
+}
+
+// Called by the core thread when a game starts. The blocks are precompiled by the
+// thread of the VIF on its next cache miss.
+void dVifLoadHotBlocks(const wxString& folder) {
+	for (int idx = 0; idx < 2; idx++) {
+		const wxString fname(dVifHotBlocksFilename(folder, idx));
+		if (!wxFileExists(fname)) continue;
+
+		wxFFile fp(fname, L"rb");
+		if (!fp.IsOpened()) continue;
+
+		u32 header[3];
+		if (fp.Read(header, sizeof(header)) != sizeof(header) || header[0] != HotBlocksMagic || header[1] != HotBlocksVersion) {
+			Console.Warning(L"nVif%d: Ignoring invalid hot unpack blocks file %s", idx, WX_STR(fname));
+			continue;
+		}
+
+		std::vector<HotBlock> list;
+		const u32 count = std::min(header[2], HotBlocksMax);
+		for (u32 i = 0; i < count; i++) {
+			HotBlockKey key;
+			if (fp.Read(&key, sizeof(key)) != sizeof(key)) break;
+			list.push_back(HotBlock{key, count - i}); // Keep the saved order
+		}
+
+		std::lock_guard<std::mutex> lock(s_hotBlocksLock);
+		if (s_hotBlocks[idx].empty()) s_hotBlocks[idx].swap(list);
+		s_hotBlocksPending[idx] = true;
+
+		DevCon.WriteLn("nVif%d: Loaded %u hot unpack blocks", idx, (u32)s_hotBlocks[idx].size());
+	}
+}
+
+// Called by the core thread when it shuts down, once the MTVU thread is idle.
+void dVifSaveHotBlocks(const wxString& folder) {
+	for (int idx = 0; idx < 2; idx++) {
+		dVifCollectHotBlocks(idx);
+
+		std::lock_guard<std::mutex> lock(s_hotBlocksLock);
+		const std::vector<HotBlock>& list = s_hotBlocks[idx];
+		if (list.empty()) continue; // Keep the previous list
+
+		const wxString fname(dVifHotBlocksFilename(folder, idx));
+		wxFFile fp(fname, L"wb");
+		if (!fp.IsOpened()) {
+			Console.Warning(L"nVif%d: Unable to save hot unpack blocks to %s", idx, WX_STR(fname));
+			continue;
+		}
+
+		u32 header[3] = { HotBlocksMagic, HotBlocksVersion, (u32)list.size() };
+		fp.Write(header, sizeof(header));
+		for (const HotBlock& it : list)
+			fp.Write(&it.key, sizeof(HotBlockKey));
+
+		DevCon.WriteLn("nVif%d: Saved %u hot unpack blocks", idx, (u32)list.size());
+	}
+}
+
 static void recReset(int idx) {
+	dVifPrintStats(idx);
+	if (EmuConfig.Cpu.Recompiler.PersistVifUnpack)
+		dVifCollectHotBlocks(idx);
+
 	nVif[idx].vifBlocks.reset();
 
 	nVif[idx].recReserve->Reset();
 
 	nVif[idx].recWritePtr = nVif[idx].recReserve->GetPtr();
+
+	if (EmuConfig.Cpu.Recompiler.PersistVifUnpack)
+		dVifPrecompileHotBlocks(idx);
 }
 
 void dVifReserve(int idx) {
@@ -37,13 +221,23 @@ void dVifReserve(int idx) {
 	nVif[idx].recReserve->Reserve( 8 * _1mb, idx ? HostMemoryMap::VIF1rec : HostMemoryMap::VIF0rec );
 }
 
+static void dVifBenchmark();
+
 void dVifReset(int idx) {
 	pxAssertDev(nVif[idx].recReserve, "Dynamic VIF recompiler reserve must be created prior to VIF use or reset!");
 
+	// Uses the VIF0 cache, which is reset right after
+	if (!idx && EmuConfig.Profiler.Enabled && EmuConfig.Profiler.Bench_VifUnpack)
+		dVifBenchmark();
+
 	recReset(idx);
 }
 
 void dVifClose(int idx) {
+	dVifPrintStats(idx);
+	if (EmuConfig.Cpu.Recompiler.PersistVifUnpack)
+		dVifCollectHotBlocks(idx);
+
 	if (nVif[idx].recReserve)
 		nVif[idx].recReserve->Reset();
 }
@@ -64,6 +258,7 @@ VifUnpackSSE_Dynarec::VifUnpackSSE_Dynarec(const nVifStruct& vif_, const nVifBlo
 	doMode		= vB.mode & 3;
 	IsAligned   = vB.aligned;
 	vCL			= 0;
+	allowAVX2	= newVifAVX2;
 }
 
 __fi void makeMergeMask(u32& x)
@@ -210,6 +405,12 @@ void VifUnpackSSE_Dynarec::CompileRoutine() {
 	uint vNum	= vB.num ? vB.num : 256;
 	doMode		= (upkNum == 0xf) ? 0 : doMode;		// V4_5 has no mode feature.
 	UnpkNoOfIterations = 0;
+
+	if (CanUseAVX2(upkNum)) {
+		CompileRoutineAVX2();
+		return;
+	}
+
 	MSKPATH3_LOG("Compiling new block, unpack number %x, mode %x, masking %x, vNum %x", upkNum, doMode, doMask, vNum);
 
 	pxAssume(vCL == 0);
@@ -260,6 +461,137 @@ void VifUnpackSSE_Dynarec::CompileRoutine() {
 	xRET();
 }
 
+// =====================================================================================================
+//  AVX2 path
+// =====================================================================================================
+// Unpacks 2 consecutive quadwords per instruction (ymm) for the most common unpack types.
+// Quadwords which can't be paired (last one of a cycle, or an odd num) use the 128-bit VEX
+// form of the same code, so the whole routine stays VEX encoded (no SSE/AVX transition).
+// Difference mode (row accumulation) and filling writes keep using the SSE routine.
+
+// Converts a 'one bit per field' mask (field n on bit n*2) into a vpblendd lane mask
+static __fi u32 blendFields(u32 m) {
+	return (m & 1) | ((m >> 1) & 2) | ((m >> 2) & 4) | ((m >> 3) & 8);
+}
+
+bool VifUnpackSSE_Dynarec::CanUseAVX2(int upknum) const {
+	if (!allowAVX2 || !x86caps.hasAVX2)  return false;
+	if (isFill || doMode >= 2)           return false;
+	// V3-32 isn't paired: its 12 bytes source stride still needs a load per vector (or a
+	// 32 bytes load and a cross-lane vpermd), so a pair costs as many uops as two SSE vectors
+	// and ran 15-25% slower in Profiler.Bench_VifUnpack, with either form.
+	return upknum == 12 || upknum == 13; // V4-32, V4-16
+}
+
+void VifUnpackSSE_Dynarec::xUnpackAVX2(int upknum, bool wide) {
+	switch (upknum) {
+		case 12: // V4-32
+			xVMOVDQU(destReg, ptr[srcIndirect], wide);
+			break;
+		case 13: // V4-16
+			if (usn) xVPMOVZXWD(destReg, ptr[srcIndirect], wide);
+			else     xVPMOVSXWD(destReg, ptr[srcIndirect], wide);
+			break;
+		jNO_DEFAULT;
+	}
+}
+
+// Applies the row/col/write-protect masks and the offset mode to 1 or 2 vectors
+// (same logic as doMaskWrite, with both cycles merged in one blend mask).
+void VifUnpackSSE_Dynarec::xMovDestAVX2(bool wide) const {
+	const u32 lanes   = wide ? 2 : 1;
+	const u32 allBits = wide ? 0xff : 0x0f;
+	u32 rowBits = 0, colBits = 0, protBits = 0;
+
+	for (u32 l = 0; l < lanes; l++) {
+		int cc = std::min(vCL + (int)l, 3);
+		u32 m0 = (vB.mask >> (cc * 8)) & 0xff;
+		u32 m3 = ((m0 & 0xaa)>>1) & ~m0;
+		u32 m2 = (m0 & 0x55) & (~m0>>1);
+		u32 m4 = (m0 & ~((m3<<1) | m2)) & 0x55;
+		rowBits  |= blendFields(m2) << (l * 4);
+		colBits  |= blendFields(m3) << (l * 4);
+		protBits |= blendFields(m4) << (l * 4);
+	}
+
+	// xmmRow/xmmCol* hold a single vector, duplicate it in both halves when needed
+	const xRegisterSSE& rowReg = wide ? workReg : xmmRow;
+
+	if (doMask && rowBits) {
+		if (wide) xVINSERTI128(workReg, xmmRow, xmmRow, 1, true);
+		xVPBLENDD(destReg, destReg, rowReg, rowBits, wide);
+	}
+	if (doMask && colBits) {
+		xRegisterSSE col0(xmmCol0.Id + std::min(vCL, 3));
+		if (wide) {
+			xRegisterSSE col1(xmmCol0.Id + std::min(vCL + 1, 3));
+			xVINSERTI128(workReg, col0, col1, 1, true);
+			xVPBLENDD(destReg, destReg, workReg, colBits, true);
+		}
+		else xVPBLENDD(destReg, destReg, col0, colBits, false);
+	}
+	if (doMask && protBits) {
+		xVMOVDQU (workReg, ptr[dstIndirect], wide);
+		xVPBLENDD(destReg, destReg, workReg, protBits, wide);
+	}
+	if (doMode) { // Offset mode
+		u32 addBits = doMask ? (~(rowBits | colBits | protBits) & allBits) : allBits;
+		if (addBits) {
+			if (wide) xVINSERTI128(workReg, xmmRow, xmmRow, 1, true);
+			if (addBits != allBits) {
+				xVPXOR   (xmmTemp, xmmTemp, xmmTemp, wide);
+				xVPBLENDD(xmmTemp, xmmTemp, rowReg, addBits, wide);
+				xVPADDD  (destReg, destReg, xmmTemp, wide);
+			}
+			else xVPADDD(destReg, destReg, rowReg, wide);
+		}
+	}
+	xVMOVDQU_STORE(ptr[dstIndirect], destReg, wide);
+}
+
+void VifUnpackSSE_Dynarec::CompileRoutineAVX2() {
+	const int  wl		 = vB.wl ? vB.wl : 256; //0 is taken as 256 (KH2)
+	const int  upkNum	 = vB.upkType & 0xf;
+	const u8&  vift		 = nVifT[upkNum];
+	const int  cycleSize = wl; // Never filling here
+	const int  blockSize = vB.cl;
+	const int  skipSize	 = blockSize - cycleSize;
+
+	uint vNum = vB.num ? vB.num : 256;
+
+	pxAssume(vCL == 0);
+
+	// Masks are loaded with legacy SSE ops while the upper ymm state is still clean
+	SetMasks(cycleSize);
+
+	while (vNum) {
+		ShiftDisplacementWindow( dstIndirect, ecx );
+		ShiftDisplacementWindow( srcIndirect, edx );
+
+		if (vCL < cycleSize) {
+			const bool wide = (vNum >= 2) && (vCL + 1 < cycleSize);
+			const int  qwc  = wide ? 2 : 1;
+
+			xUnpackAVX2(upkNum, wide);
+			xMovDestAVX2(wide);
+
+			dstIndirect += 16 * qwc;
+			srcIndirect += vift * qwc;
+
+			vNum -= qwc;
+			vCL  += qwc;
+			if (vCL == blockSize) vCL = 0;
+		}
+		else {
+			dstIndirect += (16 * skipSize);
+			vCL = 0;
+		}
+	}
+
+	xVZEROUPPER();
+	xRET();
+}
+
 static u16 dVifComputeLength(uint cl, uint wl, u8 num, bool isFill) {
 	uint length   = (num > 0) ? (num * 16) : 4096; // 0 = 256
 
@@ -272,7 +604,7 @@ static u16 dVifComputeLength(uint cl, uint wl, u8 num, bool isFill) {
 	return std::min(length, 0xFFFFu);
 }
 
-_vifT __fi nVifBlock* dVifCompile(nVifBlock& block, bool isFill) {
+_vifT static nVifBlock* dVifCompile(nVifBlock& block, bool isFill) {
 	nVifStruct& v = nVif[idx];
 
 	// Check size before the compilation
@@ -338,7 +670,12 @@ _vifT __fi void dVifUnpack(const u8* data, bool isFill) {
 	// Seach in cache before trying to compile the block
 	nVifBlock*  b = v.vifBlocks.find(block);
 	if (unlikely(b == nullptr)) {
-		b = dVifCompile<idx>(block, isFill);
+		if (s_hotBlocksPending[idx].load(std::memory_order_relaxed)) {
+			dVifPrecompileHotBlocks(idx);
+			b = v.vifBlocks.peek(block);
+		}
+		if (b == nullptr)
+			b = dVifCompile<idx>(block, isFill);
 	}
 
 	{ // Execute the block
@@ -361,3 +698,127 @@ _vifT __fi void dVifUnpack(const u8* data, bool isFill) {
 
 template void dVifUnpack<0>(const u8* data, bool isFill);
 template void dVifUnpack<1>(const u8* data, bool isFill);
+
+// =====================================================================================================
+//  Unpack benchmark (Profiler.Bench_VifUnpack)
+// =====================================================================================================
+// Compiles the unpacks handled by the AVX2 routine with both routines, runs them over
+// a synthetic stream (256 quadwords per call, cl=wl=4), and reports the written bytes
+// per second.  The output of both routines is compared, so this doubles as a check.
+
+struct VifBenchCase {
+	const char* name;
+	u8          upkType;	// [usn1:mask1:upk*4]
+	u32         mask;
+	u8          mode;
+};
+
+static const VifBenchCase s_vifBenchCases[] = {
+	{ "V4-32",          12,        0,          0 },
+	{ "V4-32 masked",   12 | 0x10, 0x40404040, 0 }, // W from the row register
+	{ "V4-32 offset",   12,        0,          1 },
+	{ "V4-16",          13,        0,          0 },
+	{ "V4-16 unsigned", 13 | 0x20, 0,          0 },
+};
+
+static const uint VifBenchCalls = 100000;
+
+static nVifrecCall dVifBenchCompile(const nVifBlock& block, bool avx2) {
+	nVifStruct& v = nVif[0];
+
+	xSetPtr(v.recWritePtr);
+	nVifrecCall func = (nVifrecCall)xGetAlignedCallTarget();
+
+	VifUnpackSSE_Dynarec routine(v, block);
+	routine.allowAVX2 = avx2;
+	routine.CompileRoutine();
+
+	v.recWritePtr = xGetPtr();
+	return func;
+}
+
+// Returns the written bytes per second (best of 3 runs)
+static double dVifBenchRun(nVifrecCall func, u8* dest, const u8* src) {
+	u64 best = ~0ULL;
+	for (int run = 0; run < 3; run++) {
+		const u64 start = GetCPUTicks();
+		for (uint i = 0; i < VifBenchCalls; i++)
+			func((uptr)dest, (uptr)src);
+		best = std::min(best, GetCPUTicks() - start);
+	}
+	return (double)VifBenchCalls * 256 * 16 * GetTickFrequency() / (double)std::max<u64>(best, 1);
+}
+
+static void dVifBenchmark() {
+	nVifStruct& v = nVif[0];
+	v.recWritePtr = v.recReserve->GetPtr();
+
+	const bool avx2 = newVifAVX2 && x86caps.hasAVX2;
+
+	// 256 quadwords of 16 bytes at most
+	u8* src   = (u8*)_aligned_malloc(256 * 16, 32);
+	u8* dest0 = (u8*)_aligned_malloc(256 * 16, 32);
+	u8* dest1 = (u8*)_aligned_malloc(256 * 16, 32);
+	if (!src || !dest0 || !dest1) {
+		safe_aligned_free(src);
+		safe_aligned_free(dest0);
+		safe_aligned_free(dest1);
+		return;
+	}
+
+	u32 seed = 0x12345678;
+	for (uint i = 0; i < 256 * 16; i++) {
+		seed = seed * 1103515245 + 12345;
+		src[i] = (u8)(seed >> 16);
+	}
+
+	// The routines read the row/col registers of VIF0
+	const u128 savedRow = vif0.MaskRow;
+	const u128 savedCol = vif0.MaskCol;
+	vif0.MaskRow._u32[0] = 0x3f800000; vif0.MaskRow._u32[1] = 1;
+	vif0.MaskRow._u32[2] = 0x7fffffff; vif0.MaskRow._u32[3] = 0x80000000;
+	vif0.MaskCol = vif0.MaskRow;
+
+	Console.WriteLn(Color_StrongBlack, "nVif: Unpack benchmark (%u calls of 256 quadwords, %s)",
+		VifBenchCalls, avx2 ? "SSE vs AVX2" : "SSE only, no AVX2");
+
+	for (const VifBenchCase& bench : s_vifBenchCases) {
+		nVifBlock block;
+		memzero(block);
+		block.num     = 0; // 256
+		block.upkType = bench.upkType;
+		block.mask    = bench.mask;
+		block.mode    = bench.mode;
+		block.aligned = 1;
+		block.cl      = 4;
+		block.wl      = 4;
+
+		const nVifrecCall sse = dVifBenchCompile(block, false);
+		memset(dest0, 0, 256 * 16);
+		sse((uptr)dest0, (uptr)src);
+		const double sseRate = dVifBenchRun(sse, dest0, src);
+
+		if (!avx2) {
+			Console.WriteLn("  %-16s SSE %6.2f GB/s", bench.name, sseRate / _1gb);
+			continue;
+		}
+
+		const nVifrecCall vex = dVifBenchCompile(block, true);
+		memset(dest0, 0, 256 * 16);
+		memset(dest1, 0, 256 * 16);
+		sse((uptr)dest0, (uptr)src);
+		vex((uptr)dest1, (uptr)src);
+		const bool same = !memcmp(dest0, dest1, 256 * 16);
+		const double vexRate = dVifBenchRun(vex, dest1, src);
+
+		Console.WriteLn(same ? Color_Current : Color_StrongRed, "  %-16s SSE %6.2f GB/s, AVX2 %6.2f GB/s (x%.2f)%s",
+			bench.name, sseRate / _1gb, vexRate / _1gb, vexRate / sseRate, same ? "" : " - output mismatch!");
+	}
+
+	vif0.MaskRow = savedRow;
+	vif0.MaskCol = savedCol;
+
+	safe_aligned_free(src);
+	safe_aligned_free(dest0);
+	safe_aligned_free(dest1);
+}
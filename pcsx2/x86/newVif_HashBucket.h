@@ -15,10 +15,8 @@
 
 #pragma once
 
-#include <array>
-
-// nVifBlock - Ordered for Hashing; the 'num' and 'upkType' fields are
-//             used as the hash bucket selector.
+// nVifBlock - The first 12 bytes (hash_key/key0/key1) are the lookup key of
+//             the compiled unpack routine.
 union nVifBlock {
 	// Warning: order depends on the newVifDynaRec code
 	struct {
@@ -43,92 +41,170 @@ union nVifBlock {
 
 }; // 16 bytes
 
-// 0x4000 is enough but 0x10000 allow
-// * to skip the compare value of the first double world in lookup
-// * to use a 16 bits move instead of an 'and' mask to compute the hashed key
-#define hSize 0x10000 // [usn*1:mask*1:upk*4:num*8] hash...
+// Initial amount of slots of the table (must be a power of 2). The table doubles
+// in size whenever it gets half full, so probe chains stay short.
+#define hInitSize 0x1000
+
+struct HashBucketStats {
+	u64 hits;			// Lookups that found a compiled block
+	u64 misses;			// Lookups that required a compilation
+	u64 compiles;		// Blocks added to the table
+	u64 precompiles;	// Blocks added ahead of time (hot block persistence)
+	u64 probes;			// Extra slots visited because of collisions
+	void Reset() { memzero(*this); }
+};
 
-// HashBucket is a container which uses a built-in hash function
-// to perform quick searches. It is designed around the nVifBlock structure
+// HashBucket is an open-addressing (linear probing) hash table of nVifBlock.
 //
-// The hash function is determined by taking the first bytes of data and
-// performing a modulus the size of hSize. So the most diverse-data should
-// be in the first bytes of the struct. (hence why nVifBlock is specifically sorted)
+// The hash is computed on the full key (hash_key/key0/key1), so blocks which only
+// differ by their mask or cycle/mode fields don't end up in the same chain. A slot
+// with a null startPtr marks the end of a probe chain. A per-slot use counter is
+// kept on the side (so the block stay 16 bytes) to find out the hot routines.
 class HashBucket {
 protected:
-	std::array<nVifBlock*, hSize> m_bucket;
+	nVifBlock* m_table;
+	u64*       m_uses;
+	u32        m_mask;
+	u32        m_count;
+
+	HashBucketStats m_stats;
+
+	static __fi u32 hash(const nVifBlock& dataPtr) {
+		// Murmur3 style mixing of the 3 key words
+		u32 h = dataPtr.hash_key;
+		h ^= dataPtr.key0 * 0xcc9e2d51u;
+		h  = (h << 13) | (h >> 19);
+		h ^= dataPtr.key1 * 0x1b873593u;
+		h ^= h >> 16;
+		h *= 0x85ebca6bu;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35u;
+		h ^= h >> 16;
+		return h;
+	}
+
+	static __fi bool equal(const nVifBlock& a, const nVifBlock& b) {
+		return a.hash_key == b.hash_key && a.key0 == b.key0 && a.key1 == b.key1;
+	}
+
+	void alloc(u32 size) {
+		m_table = (nVifBlock*)_aligned_malloc(sizeof(nVifBlock) * size, 64);
+		m_uses  = (u64*)_aligned_malloc(sizeof(u64) * size, 64);
+		if (!m_table || !m_uses) {
+			throw Exception::OutOfMemory(
+				wxsFormat(L"HashBucket Table (size=%d)", size)
+			);
+		}
+		memset(m_table, 0, sizeof(nVifBlock) * size);
+		memset(m_uses,  0, sizeof(u64) * size);
+		m_mask  = size - 1;
+		m_count = 0;
+	}
+
+	nVifBlock* insert(const nVifBlock& dataPtr, u64 uses) {
+		u32 i = hash(dataPtr) & m_mask;
+		while (m_table[i].startPtr != 0)
+			i = (i + 1) & m_mask;
+
+		memcpy(&m_table[i], &dataPtr, sizeof(nVifBlock));
+		m_uses[i] = uses;
+		m_count++;
+		return &m_table[i];
+	}
+
+	void grow() {
+		nVifBlock* oldTable = m_table;
+		u64*       oldUses  = m_uses;
+		u32        oldSize  = m_mask + 1;
+
+		alloc(oldSize * 2);
+		for (u32 i = 0; i < oldSize; i++) {
+			if (oldTable[i].startPtr != 0)
+				insert(oldTable[i], oldUses[i]);
+		}
+
+		safe_aligned_free(oldTable);
+		safe_aligned_free(oldUses);
+		DevCon.WriteLn("recVifUnpk: HashBucket grown to %d entries", m_mask + 1);
+	}
 
 public:
-	HashBucket() {
-		m_bucket.fill(nullptr);
+	HashBucket() : m_table(nullptr), m_uses(nullptr), m_mask(0), m_count(0) {
+		m_stats.Reset();
 	}
 
 	~HashBucket() { clear(); }
 
 	__fi nVifBlock* find(const nVifBlock& dataPtr) {
-		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
+		u32 i = hash(dataPtr) & m_mask;
 
 		while (true) {
-			if (chainpos->key0 == dataPtr.key0 && chainpos->key1 == dataPtr.key1)
-				return chainpos;
+			nVifBlock& slot = m_table[i];
 
-			if (chainpos->startPtr == 0)
+			if (slot.startPtr == 0) {
+				m_stats.misses++;
 				return nullptr;
+			}
+
+			if (equal(slot, dataPtr)) {
+				m_uses[i]++;
+				m_stats.hits++;
+				return &slot;
+			}
 
-			chainpos++;
+			m_stats.probes++;
+			i = (i + 1) & m_mask;
 		}
 	}
 
-	void add(const nVifBlock& dataPtr) {
-		u32 b = dataPtr.hash_key;
-
-		u32 size = bucket_size( dataPtr );
+	// Lookup which doesn't count in the stats nor in the use counters
+	nVifBlock* peek(const nVifBlock& dataPtr) const {
+		if (!m_table) return nullptr;
 
-		// Warning there is an extra +1 due to the empty cell
-		// Performance note: 64B align to reduce cache miss penalty in `find`
-		if( (m_bucket[b] = (nVifBlock*)pcsx2_aligned_realloc( m_bucket[b], sizeof(nVifBlock)*(size+2), 64, sizeof(nVifBlock)*(size+1) )) == NULL ) {
-			throw Exception::OutOfMemory(
-				wxsFormat(L"HashBucket Chain (bucket size=%d)", size+2)
-			);
+		for (u32 i = hash(dataPtr) & m_mask; m_table[i].startPtr != 0; i = (i + 1) & m_mask) {
+			if (equal(m_table[i], dataPtr))
+				return &m_table[i];
 		}
-
-		// Replace the empty cell by the new block and create a new empty cell
-		memcpy(&m_bucket[b][size++], &dataPtr, sizeof(nVifBlock));
-		memset(&m_bucket[b][size], 0, sizeof(nVifBlock));
-
-		if( size > 3 ) DevCon.Warning( "recVifUnpk: Bucket 0x%04x has %d micro-programs", b, size );
+		return nullptr;
 	}
 
-	u32 bucket_size(const nVifBlock& dataPtr) {
-		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
+	void add(const nVifBlock& dataPtr) {
+		if ((m_count + 1) * 2 > m_mask + 1)
+			grow();
 
-		u32 size = 0;
+		insert(dataPtr, 0);
+		m_stats.compiles++;
+	}
 
-		while (chainpos->startPtr != 0) {
-			size++;
-			chainpos++;
+	// Calls func(block, uses) for every compiled block
+	template <typename Func>
+	void for_each(Func func) const {
+		if (!m_table) return;
+		for (u32 i = 0; i <= m_mask; i++) {
+			if (m_table[i].startPtr != 0)
+				func(m_table[i], m_uses[i]);
 		}
+	}
 
-		return size;
+	// Moves the last compile to the precompiled blocks
+	void precompiled() {
+		m_stats.compiles--;
+		m_stats.precompiles++;
 	}
 
+	u32 size() const                       { return m_count; }
+	const HashBucketStats& stats() const   { return m_stats; }
+
 	void clear() {
-		for (auto& bucket : m_bucket)
-			safe_aligned_free(bucket);
+		safe_aligned_free(m_table);
+		safe_aligned_free(m_uses);
+		m_mask  = 0;
+		m_count = 0;
 	}
 
 	void reset() {
 		clear();
-
-		// Allocate an empty cell for all buckets
-		for (auto& bucket : m_bucket) {
-			if( (bucket = (nVifBlock*)_aligned_malloc( sizeof(nVifBlock), 64 )) == nullptr ) {
-				throw Exception::OutOfMemory(
-						wxsFormat(L"HashBucket Chain (bucket size=%d)", 1)
-						);
-			}
-
-			memset(bucket, 0, sizeof(nVifBlock));
-		}
+		alloc(hInitSize);
+		m_stats.Reset();
 	}
 };
@@ -108,6 +108,7 @@ class VifUnpackSSE_Dynarec : public VifUnpackSSE_Base
 public:
 	bool			isFill;
 	int				doMode;			// two bit value representing... something!
+	bool			allowAVX2;		// newVifAVX2, can be cleared to compare both routines
 	
 protected:
 	const nVifStruct&	v;			// vif0 or vif1
@@ -123,6 +124,7 @@ public:
 	{
 		isFill	= src.isFill;
 		vCL		= src.vCL;
+		allowAVX2 = src.allowAVX2;
 	}
 
 	virtual ~VifUnpackSSE_Dynarec() = default;
@@ -138,6 +140,11 @@ protected:
 	void SetMasks(int cS) const;
 	void writeBackRow() const;
 
+	bool CanUseAVX2(int upknum) const;
+	void CompileRoutineAVX2();
+	void xUnpackAVX2(int upknum, bool wide);
+	void xMovDestAVX2(bool wide) const;
+
 	static VifUnpackSSE_Dynarec FillingWrite( const VifUnpackSSE_Dynarec& src )
 	{
 		VifUnpackSSE_Dynarec fillingWrite( src );
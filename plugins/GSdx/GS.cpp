@@ -29,6 +29,7 @@
 #include "Renderers/OpenGL/GSRendererOGL.h"
 #include "Renderers/OpenCL/GSRendererCL.h"
 #include "GSLzma.h"
+#include "Utilities/TraceEvents.h"
 
 #ifdef _WIN32
 
@@ -861,6 +862,13 @@ EXPORT_C GSabout()
 {
 }
 
+// Lets the emulator enable the timeline markers of the rasterizer threads and export them
+// along with its own.
+EXPORT_C_(void*) GStraceRegistry()
+{
+	return &TraceEvents::GetRegistry();
+}
+
 EXPORT_C GSirqCallback(void (*irq)())
 {
 	s_irq = irq;
@@ -396,6 +396,11 @@ GSCapture::GSCapture()
 	m_threads = theApp.GetConfigI("capture_threads");
 #if defined(__unix__)
 	m_compression_level = theApp.GetConfigI("png_compression_level");
+	m_format = theApp.GetConfigI("capture_format");
+	m_y4m = nullptr;
+	m_dropped = 0;
+	m_repeated = 0;
+	m_max_depth = 0;
 #endif
 }
 
@@ -494,13 +499,39 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 
 	// Really cheap recording
 	m_frame = 0;
+	m_dropped = 0;
+	m_repeated = 0;
+	m_max_depth = 0;
 	// Add option !!!
 	m_size.x = theApp.GetConfigI("CaptureWidth");
 	m_size.y = theApp.GetConfigI("CaptureHeight");
 
-	for(int i = 0; i < m_threads; i++) {
-		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+	int threads = m_threads;
+	if (threads <= 0)
+		threads = std::max<int>(std::thread::hardware_concurrency() / 2, 1);
+
+	if (m_format == CAPTURE_Y4M) {
+		std::string out_file = m_out_dir + "/capture.y4m";
+		m_y4m = px_fopen(out_file, "wb");
+		if (m_y4m == nullptr)
+			return false;
+
+		m_y4m_frame.clear();
+
+		fprintf(m_y4m, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444\n", m_size.x, m_size.y, (int)(fps * 1000.0f + 0.5f));
+
+		// A single stream, frames must be written in order
+		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker([this](std::shared_ptr<GSPng::Transaction>& item) { WriteY4MFrame(*item); })));
+	} else {
+		for(int i = 0; i < threads; i++) {
+			m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+		}
 	}
+
+	// A few frames in flight per worker. When they are all taken the workers can't keep
+	// up, and the frame is dropped rather than stalling the emulation. A Y4M stream has
+	// a fixed frame rate, so it repeats the previous frame instead to stay in sync.
+	m_pool.reset(new GSPng::BufferPool(m_size.x * m_size.y * 4, (int)m_workers.size() * 4));
 #endif
 
 	m_capturing = true;
@@ -530,9 +561,46 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 
 #elif defined(__unix__)
 
-	std::string out_file = m_out_dir + format("/frame.%010d.png", m_frame);
+	uint8* image = m_pool->Acquire();
+
+	if(image == NULL)
+	{
+		if(m_y4m)
+		{
+			// No image, the worker writes the previous frame again
+			m_workers[0]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, std::string(), *m_pool, nullptr, m_size.x, m_size.y, m_size.x * 4, m_compression_level, false));
+
+			m_repeated++;
+		}
+		else
+		{
+			m_dropped++;
+		}
+
+		m_frame++;
+
+		return false;
+	}
+
+	m_max_depth = std::max(m_max_depth, m_pool->InUse());
+
+	const int row_size = m_size.x * 4;
+	for(int y = 0; y < m_size.y; y++)
+	{
+		memcpy(image + y * row_size, static_cast<const uint8*>(bits) + y * pitch, row_size);
+	}
+
+	// Hand the frame to the least busy worker
+	GSPng::Worker* worker = m_workers[0].get();
+	for(auto& w : m_workers)
+	{
+		if(w->GetDepth() < worker->GetDepth())
+			worker = w.get();
+	}
+
+	std::string out_file = m_y4m ? std::string() : m_out_dir + format("/frame.%010d.png", m_frame);
 	//GSPng::Save(GSPng::RGB_PNG, out_file, (uint8*)bits, m_size.x, m_size.y, pitch, m_compression_level);
-	m_workers[m_frame%m_threads]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level));
+	worker->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, *m_pool, image, m_size.x, m_size.y, row_size, m_compression_level, m_format == CAPTURE_PNG_FAST));
 
 	m_frame++;
 
@@ -563,8 +631,13 @@ bool GSCapture::EndCapture()
 
 #elif defined(__unix__)
 	m_workers.clear();
+	m_pool.reset();
 
-	m_frame = 0;
+	if(m_y4m)
+	{
+		fclose(m_y4m);
+		m_y4m = nullptr;
+	}
 
 #endif
 
@@ -572,3 +645,72 @@ bool GSCapture::EndCapture()
 
 	return true;
 }
+
+std::string GSCapture::GetStats()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_lock);
+
+#if defined(__unix__)
+
+	if(m_frame > 0)
+	{
+		return format("Captured %llu frames (%llu dropped, %llu repeated, up to %d queued)",
+			(unsigned long long)(m_frame - m_dropped), (unsigned long long)m_dropped, (unsigned long long)m_repeated, m_max_depth);
+	}
+
+#endif
+
+	return std::string();
+}
+
+#if defined(__unix__)
+
+// Converts an RGBX frame to planar BT.601 (limited range) 4:4:4 YCbCr and appends it to the stream
+void GSCapture::WriteY4MFrame(const GSPng::Transaction& frame)
+{
+	const int w = frame.m_w;
+	const int h = frame.m_h;
+	const size_t plane = (size_t)w * h;
+
+	if(frame.m_image == nullptr)
+	{
+		// Repeat the previous frame, or black if there is none yet
+		if(m_y4m_frame.empty())
+		{
+			m_y4m_frame.resize(plane * 3, 128);
+			memset(m_y4m_frame.data(), 16, plane);
+		}
+
+		fputs("FRAME\n", m_y4m);
+		fwrite(m_y4m_frame.data(), 1, m_y4m_frame.size(), m_y4m);
+
+		return;
+	}
+
+	m_y4m_frame.resize(plane * 3);
+
+	uint8* Y = m_y4m_frame.data();
+	uint8* U = Y + plane;
+	uint8* V = U + plane;
+
+	for(int y = 0; y < h; y++)
+	{
+		const uint8* src = frame.m_image + y * frame.m_pitch;
+
+		for(int x = 0; x < w; x++, src += 4)
+		{
+			const int r = src[0];
+			const int g = src[1];
+			const int b = src[2];
+
+			*Y++ = (uint8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			*U++ = (uint8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			*V++ = (uint8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	fputs("FRAME\n", m_y4m);
+	fwrite(m_y4m_frame.data(), 1, m_y4m_frame.size(), m_y4m);
+}
+
+#endif
@@ -44,8 +44,24 @@ class GSCapture
 
 	#elif defined(__unix__)
 
+	enum CaptureFormat
+	{
+		CAPTURE_PNG = 0,
+		CAPTURE_PNG_FAST,
+		CAPTURE_Y4M,
+	};
+
 	std::vector<std::unique_ptr<GSPng::Worker>> m_workers;
+	std::unique_ptr<GSPng::BufferPool> m_pool;
 	int m_compression_level;
+	int m_format;
+	FILE* m_y4m;
+	std::vector<uint8> m_y4m_frame;
+	uint64 m_dropped;
+	uint64 m_repeated;
+	int m_max_depth;
+
+	void WriteY4MFrame(const GSPng::Transaction& frame);
 
 	#endif
 
@@ -56,6 +72,8 @@ public:
 	bool BeginCapture(float fps, GSVector2i recommendedResolution, float aspect);
 	bool DeliverFrame(const void* bits, int pitch, bool rgba);
 	bool EndCapture();
+	// Summary of the last capture, empty when there is nothing to report
+	std::string GetStats();
 
 	bool IsCapturing() {return m_capturing;}
 	GSVector2i GetSize() {return m_size;}
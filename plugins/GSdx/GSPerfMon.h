@@ -35,7 +35,8 @@ public:
 	
 	enum counter_t 
 	{
-		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint,
+		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint, WorkerSleep,
+		TextureHash, TextureHashHit, TextureReupload,
 		CounterLast,
 	};
 
@@ -43,7 +43,7 @@ namespace GSPng {
 
     bool SaveFile(const std::string& file, const Format fmt, const uint8* const image,
         uint8* const row, const int width, const int height, const int pitch,
-        const int compression, const bool rb_swapped = false, const bool first_image = false)
+        const int compression, const bool rb_swapped = false, const bool first_image = false, const bool fast = false)
     {
         const int channel_bit_depth = pixel[fmt].channel_bit_depth;
         const int bytes_per_pixel_in = pixel[fmt].bytes_per_pixel_in;
@@ -73,6 +73,8 @@ namespace GSPng {
 
             png_init_io(png_ptr, fp);
             png_set_compression_level(png_ptr, compression);
+            if (fast)
+                png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
             png_set_IHDR(png_ptr, info_ptr, width, height, channel_bit_depth, type,
                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
             png_write_info(png_ptr, info_ptr);
@@ -82,7 +84,18 @@ namespace GSPng {
             if (rb_swapped && type != PNG_COLOR_TYPE_GRAY)
                 png_set_bgr(png_ptr);
 
+            // 8 bits RGB(A) rows can be handed to libpng as they are, it drops the
+            // unused alpha byte itself
+            const bool direct = first_image && bytes_per_pixel_in == 4 && channel_bit_depth == 8 && type != PNG_COLOR_TYPE_GRAY;
+            if (direct && bytes_per_pixel_out == 3)
+                png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
+
             for (int y = 0; y < height; ++y) {
+                if (direct) {
+                    png_write_row(png_ptr, const_cast<uint8*>(image + y * pitch));
+                    continue;
+                }
+
                 for (int x = 0; x < width; ++x)
                     for (int i = 0; i < bytes_per_pixel_out; ++i)
                         row[bytes_per_pixel_out * x + i] = image[y * pitch + bytes_per_pixel_in * x + i + offset];
@@ -104,7 +117,7 @@ namespace GSPng {
         return success;
     }
 
-    bool Save(GSPng::Format fmt, const std::string& file, uint8* image, int w, int h, int pitch, int compression, bool rb_swapped)
+    bool Save(GSPng::Format fmt, const std::string& file, uint8* image, int w, int h, int pitch, int compression, bool rb_swapped, bool fast)
     {
         std::string root = file;
         root.replace(file.length() - 4, 4, "");
@@ -117,7 +130,7 @@ namespace GSPng {
         std::unique_ptr<uint8[]> row(new uint8[pixel[fmt].bytes_per_pixel_out * w]);
 
         std::string filename = root + pixel[fmt].extension[0];
-        if (!SaveFile(filename, fmt, image, row.get(), w, h, pitch, compression, rb_swapped, true))
+        if (!SaveFile(filename, fmt, image, row.get(), w, h, pitch, compression, rb_swapped, true, fast))
             return false;
 
         // Second image
@@ -125,11 +138,56 @@ namespace GSPng {
             return true;
 
         filename = root + pixel[fmt].extension[1];
-        return SaveFile(filename, fmt, image, row.get(), w, h, pitch, compression);
+        return SaveFile(filename, fmt, image, row.get(), w, h, pitch, compression, false, false, fast);
+    }
+
+    BufferPool::BufferPool(size_t size, int count)
+        : m_size(size), m_count(count)
+    {
+        for (int i = 0; i < count; i++) {
+            uint8* buffer = (uint8*)_aligned_malloc(size, 32);
+            if (buffer)
+                m_free.push_back(buffer);
+        }
+    }
+
+    BufferPool::~BufferPool()
+    {
+        // All transactions must be gone by now
+        ASSERT((int)m_free.size() == m_count);
+
+        for (uint8* buffer : m_free)
+            _aligned_free(buffer);
+    }
+
+    uint8* BufferPool::Acquire()
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+
+        if (m_free.empty())
+            return nullptr;
+
+        uint8* buffer = m_free.back();
+        m_free.pop_back();
+        return buffer;
+    }
+
+    void BufferPool::Release(uint8* buffer)
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+
+        m_free.push_back(buffer);
+    }
+
+    int BufferPool::InUse()
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+
+        return m_count - (int)m_free.size();
     }
 
     Transaction::Transaction(GSPng::Format fmt, const std::string& file, const uint8* image, int w, int h, int pitch, int compression)
-        : m_fmt(fmt), m_file(file), m_w(w), m_h(h), m_pitch(pitch), m_compression(compression)
+        : m_fmt(fmt), m_file(file), m_pool(nullptr), m_w(w), m_h(h), m_pitch(pitch), m_compression(compression), m_fast(false)
     {
         // Note: yes it would be better to use shared pointer
         m_image = (uint8*)_aligned_malloc(pitch*h, 32);
@@ -137,15 +195,25 @@ namespace GSPng {
             memcpy(m_image, image, pitch*h);
     }
 
+    Transaction::Transaction(GSPng::Format fmt, const std::string& file, BufferPool& pool, uint8* image, int w, int h, int pitch, int compression, bool fast)
+        : m_fmt(fmt), m_file(file), m_image(image), m_pool(&pool), m_w(w), m_h(h), m_pitch(pitch), m_compression(compression), m_fast(fast)
+    {
+    }
+
     Transaction::~Transaction()
     {
-        if (m_image)
+        if (m_image == nullptr)
+            return;
+
+        if (m_pool)
+            m_pool->Release(m_image);
+        else
             _aligned_free(m_image);
     }
 
     void Process(std::shared_ptr<Transaction>& item)
     {
-        Save(item->m_fmt, item->m_file, item->m_image, item->m_w, item->m_h, item->m_pitch, item->m_compression);
+        Save(item->m_fmt, item->m_file, item->m_image, item->m_w, item->m_h, item->m_pitch, item->m_compression, false, item->m_fast);
     }
 
 }
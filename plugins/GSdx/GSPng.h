@@ -35,22 +35,47 @@ namespace GSPng {
         COUNT
     };
 
+	// Fixed size image buffers recycled between captured frames, so the capture doesn't
+	// allocate (and fault in) a new frame sized buffer for every frame.
+	class BufferPool
+	{
+			std::mutex m_lock;
+			std::vector<uint8*> m_free;
+			size_t m_size;
+			int m_count;
+
+		public:
+			BufferPool(size_t size, int count);
+			~BufferPool();
+
+			// Returns nullptr when every buffer is in use
+			uint8* Acquire();
+			void Release(uint8* buffer);
+
+			int InUse();
+	};
+
 	class Transaction
 	{
 		public:
 			Format m_fmt;
 			const std::string m_file;
 			uint8* m_image;
+			BufferPool* m_pool;
 			int m_w;
 			int m_h;
 			int m_pitch;
 			int m_compression;
+			bool m_fast;
 
 			Transaction(GSPng::Format fmt, const std::string& file, const uint8* image, int w, int h, int pitch, int compression);
+			// Takes ownership of an already filled buffer of the pool
+			Transaction(GSPng::Format fmt, const std::string& file, BufferPool& pool, uint8* image, int w, int h, int pitch, int compression, bool fast);
 			~Transaction();
 	};
 
-    bool Save(GSPng::Format fmt, const std::string& file, uint8* image, int w, int h, int pitch, int compression, bool rb_swapped = false);
+    // fast disables PNG row filtering, which costs more than the actual compression at low levels
+    bool Save(GSPng::Format fmt, const std::string& file, uint8* image, int w, int h, int pitch, int compression, bool rb_swapped = false, bool fast = false);
 
     void Process(std::shared_ptr<Transaction> &item);
 
@@ -267,6 +267,7 @@ void GSState::Reset()
 	m_vertex.tail = 0;
 	m_vertex.next = 0;
 	m_index.tail = 0;
+	m_index.irregular = false;
 
 	m_texflush = true;
 }
@@ -788,6 +789,12 @@ __forceinline void GSState::ApplyPRIM(uint32 prim)
 		Flush();
 	}
 
+	// Strips restart below, and a list sharing the buffer with a strip breaks both patterns
+	if(m_index.tail > 0 && ((prim & 7) != m_env.PRIM.PRIM || (prim & 7) == GS_TRIANGLESTRIP))
+	{
+		m_index.irregular = true;
+	}
+
 	m_env.PRIM.u32[0] = prim;
 	m_env.PRMODE._PRIM = prim;
 
@@ -1649,7 +1656,7 @@ void GSState::FlushPrim()
 
 		if(GSLocalMemory::m_psm[m_context->FRAME.PSM].fmt < 3 && GSLocalMemory::m_psm[m_context->ZBUF.PSM].fmt < 3)
 		{
-			m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM));
+			m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM), GetIndexLayout());
 
 			m_context->SaveReg();
 
@@ -1676,6 +1683,7 @@ void GSState::FlushPrim()
 		}
 
 		m_index.tail = 0;
+		m_index.irregular = false;
 
 		m_vertex.head = 0;
 
@@ -2792,6 +2800,7 @@ __forceinline void GSState::VertexKick(uint32 skip)
 		case GS_LINESTRIP:
 		case GS_TRIANGLESTRIP:
 			m_vertex.head = head + 1;
+			m_index.irregular = true;
 			// fall through
 		case GS_TRIANGLEFAN:
 			if(tail >= m_vertex.maxcount) GrowVertexBuffer(); // in case too many vertices were skipped
@@ -2886,6 +2895,31 @@ __forceinline void GSState::VertexKick(uint32 skip)
 		FlushPrim();
 }
 
+// VertexKick emits lists as a plain sequence of vertices and triangle strips as
+// (k, k + 1, k + 2), so the vertex trace can read the vertices without going through
+// the indices, unless the pattern was broken since the last flush.
+
+GSVertexTrace::IndexLayout GSState::GetIndexLayout() const
+{
+	if(!m_index.irregular)
+	{
+		switch(PRIM->PRIM)
+		{
+		case GS_POINTLIST:
+		case GS_LINELIST:
+		case GS_TRIANGLELIST:
+		case GS_SPRITE:
+			return GSVertexTrace::IndexLayout::List;
+		case GS_TRIANGLESTRIP:
+			return GSVertexTrace::IndexLayout::Strip;
+		default:
+			break;
+		}
+	}
+
+	return GSVertexTrace::IndexLayout::Indexed;
+}
+
 void GSState::GetTextureMinMax(GSVector4i& r, const GIFRegTEX0& TEX0, const GIFRegCLAMP& CLAMP, bool linear)
 {
 	// TODO: some of the +1s can be removed if linear == false
@@ -186,8 +186,11 @@ protected:
 	{
 		uint32* buff; 
 		size_t tail;
+		bool irregular; // a strip was cut or PRIM changed, the indices don't follow PRIM's pattern
 	} m_index;
 
+	GSVertexTrace::IndexLayout GetIndexLayout() const;
+
 	void UpdateContext();
 	void UpdateScissor();
 
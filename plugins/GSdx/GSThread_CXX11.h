@@ -26,7 +26,32 @@
 
 template<class T, int CAPACITY> class GSJobQueue final
 {
+public:
+	struct Stats
+	{
+		uint64 enqueued;
+		uint64 dequeued;
+		uint64 spin_hits;	// worker found new jobs while spinning
+		uint64 sleeps;		// worker parked on m_notempty
+		uint64 wait_sleeps;	// Wait() parked on m_empty
+	};
+
 private:
+	// Spin budgets in _mm_pause iterations. The worker adapts its budget to how often
+	// spinning actually catches the next job, Wait() always uses the same small budget.
+	static const int SPIN_MIN = 16;
+	static const int SPIN_MAX = 4096;
+	static const int WAIT_SPIN = 1024;
+
+	struct AtomicStats
+	{
+		std::atomic<uint64> enqueued;
+		std::atomic<uint64> dequeued;
+		std::atomic<uint64> spin_hits;
+		std::atomic<uint64> sleeps;
+		std::atomic<uint64> wait_sleeps;
+	};
+
 	std::thread m_thread;
 	std::function<void(T&)> m_func;
 	bool m_exit;
@@ -37,37 +62,104 @@ private:
 	std::condition_variable m_empty;
 	std::condition_variable m_notempty;
 
-	void ThreadProc() {
-		std::unique_lock<std::mutex> l(m_lock);
+	// Set while the worker is (about to be) parked on m_notempty, or while a thread is
+	// parked in Wait(). Push and the worker only take the locks and signal when these
+	// are set, so the common case stays free of syscalls.
+	std::atomic<bool> m_sleeping;
+	std::atomic<bool> m_waiting;
+	int m_spin;
 
-		while (true) {
+	AtomicStats m_stats;
 
-			while (m_queue.empty()) {
-				if (m_exit)
-					return;
+	// Each counter has a single writer, so a relaxed load/store pair is enough and
+	// avoids a locked add per job.
+	static void Inc(std::atomic<uint64>& counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
 
-				m_notempty.wait(l);
+	// Spins until the queue's emptiness matches the requested state, returns false if
+	// the budget ran out first.
+	bool Spin(int count, bool empty)
+	{
+		for (int i = 0; i < count; i++) {
+			if (m_queue.empty() == empty)
+				return true;
+
+			_mm_pause();
+		}
+
+		return m_queue.empty() == empty;
+	}
+
+	void Notify()
+	{
+		// Pairs with the fence in ThreadProc: either the worker sees the new job before
+		// it parks, or we see m_sleeping and wake it up.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (m_sleeping.load(std::memory_order_relaxed)) {
+			{
+				std::lock_guard<std::mutex> l(m_lock);
 			}
+			m_notempty.notify_one();
+		}
+	}
 
-			l.unlock();
+	void ThreadProc() {
+		while (true) {
 
 			while (m_queue.consume_one(*this))
-				;
+				Inc(m_stats.dequeued);
 
-			{
-				std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (m_waiting.load(std::memory_order_relaxed)) {
+				{
+					std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+				}
+				m_empty.notify_one();
+			}
+
+			if (Spin(m_spin, false)) {
+				Inc(m_stats.spin_hits);
+				m_spin = std::min(m_spin * 2, SPIN_MAX);
+				continue;
 			}
-			m_empty.notify_one();
 
-			l.lock();
+			m_spin = std::max(m_spin / 2, SPIN_MIN);
+
+			std::unique_lock<std::mutex> l(m_lock);
+
+			m_sleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			while (m_queue.empty()) {
+				if (m_exit)
+					return;
+
+				Inc(m_stats.sleeps);
+				m_notempty.wait(l);
+			}
+
+			m_sleeping.store(false, std::memory_order_relaxed);
 		}
 	}
 
 public:
 	GSJobQueue(std::function<void(T&)> func) :
 		m_func(func),
-		m_exit(false)
+		m_exit(false),
+		m_sleeping(false),
+		m_waiting(false),
+		m_spin(SPIN_MIN)
 	{
+		m_stats.enqueued = 0;
+		m_stats.dequeued = 0;
+		m_stats.spin_hits = 0;
+		m_stats.sleeps = 0;
+		m_stats.wait_sleeps = 0;
+
 		m_thread = std::thread(&GSJobQueue::ThreadProc, this);
 	}
 
@@ -91,24 +183,65 @@ public:
 		while(!m_queue.push(item))
 			std::this_thread::yield();
 
-		{
-			std::lock_guard<std::mutex> l(m_lock);
+		Inc(m_stats.enqueued);
+
+		Notify();
+	}
+
+	// Number of jobs not completed yet, including the one being processed.
+	size_t GetDepth() const
+	{
+		return m_queue.size();
+	}
+
+	// Queues several jobs and wakes the worker once at the end.
+	void Push(const T* items, size_t count) {
+		for (size_t i = 0; i < count; i++) {
+			while (!m_queue.push(items[i])) {
+				// Full, make sure the worker is awake to drain it.
+				Notify();
+				std::this_thread::yield();
+			}
+
+			Inc(m_stats.enqueued);
 		}
-		m_notempty.notify_one();
+
+		Notify();
 	}
 
 	void Wait()
 	{
-		if (IsEmpty())
+		if (Spin(WAIT_SPIN, true))
 			return;
 
 		std::unique_lock<std::mutex> l(m_wait_lock);
-		while (!IsEmpty())
+
+		m_waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		while (!IsEmpty()) {
+			Inc(m_stats.wait_sleeps);
 			m_empty.wait(l);
+		}
+
+		m_waiting.store(false, std::memory_order_relaxed);
 
 		assert(IsEmpty());
 	}
 
+	Stats GetStats() const
+	{
+		Stats s;
+
+		s.enqueued = m_stats.enqueued.load(std::memory_order_relaxed);
+		s.dequeued = m_stats.dequeued.load(std::memory_order_relaxed);
+		s.spin_hits = m_stats.spin_hits.load(std::memory_order_relaxed);
+		s.sleeps = m_stats.sleeps.load(std::memory_order_relaxed);
+		s.wait_sleeps = m_stats.wait_sleeps.load(std::memory_order_relaxed);
+
+		return s;
+	}
+
 	void operator() (T& item) {
 		m_func(item);
 	}
@@ -317,6 +317,10 @@ void GSdxApp::Init()
 	m_gs_tv_shaders.push_back(GSSetting(3, "Triangular filter", ""));
 	m_gs_tv_shaders.push_back(GSSetting(4, "Wave filter", ""));
 
+	m_gs_capture_format.push_back(GSSetting(0, "PNG", ""));
+	m_gs_capture_format.push_back(GSSetting(1, "PNG", "Fast"));
+	m_gs_capture_format.push_back(GSSetting(2, "YUV4MPEG", "Uncompressed"));
+
 	// PSX options that start with m_gpu.
 	m_gpu_renderers.push_back(GSSetting(static_cast<int8>(GPURendererType::D3D11_SW), "Direct3D 11", "Software"));
 	m_gpu_renderers.push_back(GSSetting(static_cast<int8>(GPURendererType::NULL_Renderer), "Null", ""));
@@ -365,8 +369,9 @@ void GSdxApp::Init()
 	m_default_configuration["AspectRatio"]                                = "1";
 	m_default_configuration["autoflush_sw"]                               = "1";
 	m_default_configuration["capture_enabled"]                            = "0";
+	m_default_configuration["capture_format"]                             = "0";
 	m_default_configuration["capture_out_dir"]                            = "/tmp/GSdx_Capture";
-	m_default_configuration["capture_threads"]                            = "4";
+	m_default_configuration["capture_threads"]                            = "0";
 	m_default_configuration["CaptureHeight"]                              = "480";
 	m_default_configuration["CaptureWidth"]                               = "640";
 	m_default_configuration["clut_load_before_draw"]                      = "0";
@@ -441,6 +446,7 @@ void GSdxApp::Init()
 	m_default_configuration["shaderfx"]                                   = "0";
 	m_default_configuration["shaderfx_conf"]                              = "shaders/GSdx_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"]                              = "shaders/GSdx.fx";
+	m_default_configuration["texture_cache_hash"]                         = "0";
 	m_default_configuration["TVShader"]                                   = "0";
 	m_default_configuration["upscale_multiplier"]                         = "1";
 	m_default_configuration["UserHacks"]                                  = "0";
@@ -466,6 +472,7 @@ void GSdxApp::Init()
 	m_default_configuration["UserHacks_TriFilter"]                        = std::to_string(static_cast<int8>(TriFiltering::None));
 	m_default_configuration["UserHacks_WildHack"]                         = "0";
 	m_default_configuration["wrap_gs_mem"]                                = "0";
+	m_default_configuration["vertex_trace_bench"]                         = "0";
 	m_default_configuration["vsync"]                                      = "0";
 }
 
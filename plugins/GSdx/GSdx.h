@@ -81,6 +81,7 @@ public:
 	std::vector<GSSetting> m_gs_acc_blend_level;
 	std::vector<GSSetting> m_gs_acc_blend_level_d3d11;
 	std::vector<GSSetting> m_gs_tv_shaders;
+	std::vector<GSSetting> m_gs_capture_format;
 
 	std::vector<GSSetting> m_gpu_renderers;
 	std::vector<GSSetting> m_gpu_filter;
@@ -385,7 +385,17 @@ void GSRenderer::VSync(int field)
 					sum += m_perfmon.CPU(GSPerfMon::WorkerDraw0 + i);
 				}
 
-				s += format(" | %d%% CPU", sum);
+				s += format(" | %d%% CPU | %d sleeps", sum, (int)m_perfmon.Get(GSPerfMon::WorkerSleep));
+			}
+
+			double hashed = m_perfmon.Get(GSPerfMon::TextureHash);
+
+			if(hashed > 0)
+			{
+				s += format(" | %.2f hash | %.1f H/%.1f R",
+					hashed / 1024,
+					m_perfmon.Get(GSPerfMon::TextureHashHit),
+					m_perfmon.Get(GSPerfMon::TextureReupload));
 			}
 		}
 		else
@@ -539,6 +549,13 @@ bool GSRenderer::BeginCapture()
 void GSRenderer::EndCapture()
 {
 	m_capture.EndCapture();
+
+	std::string stats = m_capture.GetStats();
+
+	if(!stats.empty() && m_dev)
+	{
+		m_dev->m_osd.Log(stats.c_str());
+	}
 }
 
 void GSRenderer::KeyEvent(GSKeyEventData* e)
@@ -23,6 +23,7 @@
 #include "GSVertexTrace.h"
 #include "GSUtil.h"
 #include "GSState.h"
+#include <chrono>
 
 GSVector4 GSVertexTrace::s_minmax;
 
@@ -35,12 +36,25 @@ GSVertexTrace::GSVertexTrace(const GSState* state)
 	: m_accurate_stq(false), m_state(state), m_primclass(GS_INVALID_CLASS)
 {
 	m_force_filter = static_cast<BiFiltering>(theApp.GetConfigI("filter"));
+	m_bench_draws = std::max(theApp.GetConfigI("vertex_trace_bench"), 0);
 	memset(&m_alpha, 0, sizeof(m_alpha));
 
+	#if _M_SSE >= 0x501
+
+	#define InitUpdate3(P, IIP, TME, FST, COLOR) \
+		m_fmm[0][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMax<P, IIP, TME, FST, COLOR, 0>; \
+		m_fmm[1][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMax<P, IIP, TME, FST, COLOR, 1>; \
+		m_fmm_avx2[0][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMaxAVX2<P, IIP, TME, FST, COLOR, 0>; \
+		m_fmm_avx2[1][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMaxAVX2<P, IIP, TME, FST, COLOR, 1>; \
+
+	#else
+
 	#define InitUpdate3(P, IIP, TME, FST, COLOR) \
 		m_fmm[0][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMax<P, IIP, TME, FST, COLOR, 0>; \
 		m_fmm[1][COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMax<P, IIP, TME, FST, COLOR, 1>; \
 
+	#endif
+
 	#define InitUpdate2(P, IIP, TME) \
 		InitUpdate3(P, IIP, TME, 0, 0) \
 		InitUpdate3(P, IIP, TME, 0, 1) \
@@ -59,7 +73,16 @@ GSVertexTrace::GSVertexTrace(const GSState* state)
 	InitUpdate(GS_SPRITE_CLASS);
 }
 
-void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count, int i_count, GS_PRIM_CLASS primclass)
+GSVertexTrace::~GSVertexTrace()
+{
+	for(auto& d : m_bench)
+	{
+		_aligned_free(d.vertex);
+		_aligned_free(d.index);
+	}
+}
+
+void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count, int i_count, GS_PRIM_CLASS primclass, IndexLayout layout)
 {
 	m_primclass = primclass;
 
@@ -68,7 +91,32 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count,
 	uint32 fst = m_state->PRIM->FST;
 	uint32 color = !(m_state->PRIM->TME && m_state->m_context->TEX0.TFX == TFX_DECAL && m_state->m_context->TEX0.TCC);
 
-	(this->*m_fmm[m_accurate_stq][color][fst][tme][iip][primclass])(vertex, index, i_count);
+	if(m_bench_draws > 0 && i_count > 0)
+	{
+		BenchDraw d;
+
+		d.vertex = (GSVertex*)_aligned_malloc(sizeof(GSVertex) * v_count, 32);
+		d.index = (uint32*)_aligned_malloc(sizeof(uint32) * i_count, 32);
+		d.count = i_count;
+		d.primclass = primclass;
+		d.layout = layout;
+		d.iip = iip;
+		d.tme = tme;
+		d.fst = fst;
+		d.color = color;
+
+		memcpy(d.vertex, vertex, sizeof(GSVertex) * v_count);
+		memcpy(d.index, index, sizeof(uint32) * i_count);
+
+		m_bench.push_back(d);
+
+		if(m_bench.size() >= m_bench_draws)
+		{
+			Benchmark();
+		}
+	}
+
+	UpdateMinMax(vertex, index, i_count, primclass, layout, iip, tme, fst, color);
 
 	// Potential float overflow detected. Better uses the slower division instead
 	// Note: If Q is too big, 1/Q will end up as 0. 1e30 is a random number
@@ -76,7 +124,7 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count,
 	if (!fst && !m_accurate_stq && m_min.t.z > 1e30) {
 		fprintf(stderr, "Vertex Trace: float overflow detected ! min %e max %e\n", m_min.t.z, m_max.t.z);
 		m_accurate_stq = true;
-		(this->*m_fmm[m_accurate_stq][color][fst][tme][iip][primclass])(vertex, index, i_count);
+		UpdateMinMax(vertex, index, i_count, primclass, layout, iip, tme, fst, color);
 	}
 
 	m_eq.value = (m_min.c == m_max.c).mask() | ((m_min.p == m_max.p).mask() << 16) | ((m_min.t == m_max.t).mask() << 20);
@@ -157,8 +205,6 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count,
 template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
 void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int count)
 {
-	const GSDrawingContext* context = m_state->m_context;
-
 	int n = 1;
 
 	switch(primclass)
@@ -528,11 +574,19 @@ void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int coun
 
 	#endif
 
+	StoreMinMax<tme, fst, color>(cmin, cmax, tmin, tmax, GSVector4(pmin), GSVector4(pmax));
+}
+
+template<uint32 tme, uint32 fst, uint32 color>
+void GSVertexTrace::StoreMinMax(const GSVector4i& cmin, const GSVector4i& cmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4& pmin, const GSVector4& pmax)
+{
+	const GSDrawingContext* context = m_state->m_context;
+
 	GSVector4 o(context->XYOFFSET);
 	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
 
-	m_min.p = (GSVector4(pmin) - o) * s;
-	m_max.p = (GSVector4(pmax) - o) * s;
+	m_min.p = (pmin - o) * s;
+	m_max.p = (pmax - o) * s;
 
 	if(tme)
 	{
@@ -566,6 +620,333 @@ void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int coun
 	}
 }
 
+void GSVertexTrace::UpdateMinMax(const void* vertex, const uint32* index, int count, GS_PRIM_CLASS primclass, IndexLayout layout, uint32 iip, uint32 tme, uint32 fst, uint32 color)
+{
+	#if _M_SSE >= 0x501
+
+	if(layout != IndexLayout::Indexed && count > 0)
+	{
+		vertex = (const GSVertex*)vertex + index[0];
+		index = NULL;
+	}
+
+	(this->*m_fmm_avx2[m_accurate_stq][color][fst][tme][iip][primclass])(vertex, index, count, layout);
+
+	#else
+
+	(this->*m_fmm[m_accurate_stq][color][fst][tme][iip][primclass])(vertex, index, count);
+
+	#endif
+}
+
+#if _M_SSE >= 0x501
+
+// Two vertices per register, one in each 128-bit lane. The lanes are folded at the end.
+
+struct GSVertexTraceMinMax8
+{
+	GSVector8i cmin, cmax;
+	GSVector8 tmin, tmax;
+	GSVector8i pmin, pmax;
+
+	template<uint32 vcolor, uint32 tme, uint32 fst, uint32 accurate_stq>
+	__forceinline void Add(const GSVector8i& c, const GSVector8i& xyzf)
+	{
+		if(vcolor)
+		{
+			AddColor(c);
+		}
+
+		if(tme)
+		{
+			if(!fst)
+			{
+				GSVector8 stq = GSVector8::cast(c);
+
+				GSVector8 q = stq.wwww();
+
+				if(accurate_stq)
+					stq = (stq.xyww() / q).xyww(q);
+				else
+					stq = (stq.xyww() * q.rcpnr()).xyww(q);
+
+				tmin = tmin.min(stq);
+				tmax = tmax.max(stq);
+			}
+			else
+			{
+				GSVector8 st = GSVector8(xyzf.uph16()).xyxy();
+
+				tmin = tmin.min(st);
+				tmax = tmax.max(st);
+			}
+		}
+
+		GSVector8i p = xyzf.upl16().blend16<0xf0>(xyzf.yyyy().uph32(xyzf));
+
+		pmin = pmin.min_u32(p);
+		pmax = pmax.max_u32(p);
+	}
+
+	// Sprites keep both vertices of one primitive in a register, q and fog come from the second one
+
+	template<uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
+	__forceinline void AddSprite(const GSVector8i& c, const GSVector8i& xyzf)
+	{
+		if(color)
+		{
+			AddColor(iip ? c : c.bb());
+		}
+
+		if(tme)
+		{
+			if(!fst)
+			{
+				GSVector8 stq = GSVector8::cast(c);
+
+				GSVector8 q = stq.bb().wwww();
+
+				if(accurate_stq)
+					stq = (stq.xyww() / q).xyww(q);
+				else
+					stq = (stq.xyww() * q.rcpnr()).xyww(q);
+
+				tmin = tmin.min(stq);
+				tmax = tmax.max(stq);
+			}
+			else
+			{
+				GSVector8 st = GSVector8(xyzf.uph16()).xyxy();
+
+				tmin = tmin.min(st);
+				tmax = tmax.max(st);
+			}
+		}
+
+		GSVector8i p = xyzf.upl16().blend16<0xf0>(xyzf.yyyy().uph32(xyzf.bb()));
+
+		pmin = pmin.min_u32(p);
+		pmax = pmax.max_u32(p);
+	}
+
+	__forceinline void AddColor(const GSVector8i& c)
+	{
+		cmin = cmin.min_u8(c);
+		cmax = cmax.max_u8(c);
+	}
+};
+
+struct GSVertexTraceIndexed
+{
+	const GSVertex* RESTRICT v;
+	const uint32* RESTRICT index;
+
+	__forceinline const GSVertex& operator [] (int i) const {return v[index[i]];}
+};
+
+struct GSVertexTraceSequential
+{
+	const GSVertex* RESTRICT v;
+
+	__forceinline const GSVertex& operator [] (int i) const {return v[i];}
+};
+
+// count: vertices to trace, color of flat shaded primitives is taken from first, first + step, ...
+
+template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq, class T>
+static void FindMinMaxAVX2Loop(GSVertexTraceMinMax8& mm, const T& v, int count, int first, int step)
+{
+	if(primclass == GS_SPRITE_CLASS)
+	{
+		for(int i = 0; i < count; i += 2)
+		{
+			const GSVertex& v0 = v[i + 0];
+			const GSVertex& v1 = v[i + 1];
+
+			mm.AddSprite<iip, tme, fst, color, accurate_stq>(GSVector8i::load(&v0.m[0], &v1.m[0]), GSVector8i::load(&v0.m[1], &v1.m[1]));
+		}
+
+		return;
+	}
+
+	const uint32 vcolor = color && (iip || primclass == GS_POINT_CLASS);
+
+	int i = 0;
+
+	for(; i <= count - 4; i += 4)
+	{
+		const GSVertex& v0 = v[i + 0];
+		const GSVertex& v1 = v[i + 1];
+		const GSVertex& v2 = v[i + 2];
+		const GSVertex& v3 = v[i + 3];
+
+		mm.Add<vcolor, tme, fst, accurate_stq>(GSVector8i::load(&v0.m[0], &v1.m[0]), GSVector8i::load(&v0.m[1], &v1.m[1]));
+		mm.Add<vcolor, tme, fst, accurate_stq>(GSVector8i::load(&v2.m[0], &v3.m[0]), GSVector8i::load(&v2.m[1], &v3.m[1]));
+	}
+
+	for(; i < count; i += 2)
+	{
+		// an odd vertex is paired with itself, it doesn't change min/max
+
+		const GSVertex& v0 = v[i];
+		const GSVertex& v1 = v[std::min(i + 1, count - 1)];
+
+		mm.Add<vcolor, tme, fst, accurate_stq>(GSVector8i::load(&v0.m[0], &v1.m[0]), GSVector8i::load(&v0.m[1], &v1.m[1]));
+	}
+
+	if(color && !vcolor)
+	{
+		for(i = first; i < count; i += step * 2)
+		{
+			const GSVertex& v0 = v[i];
+			const GSVertex& v1 = v[i + step < count ? i + step : i];
+
+			mm.AddColor(GSVector8i::load(&v0.m[0], &v1.m[0]));
+		}
+	}
+}
+
+template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
+void GSVertexTrace::FindMinMaxAVX2(const void* vertex, const uint32* index, int count, IndexLayout layout)
+{
+	const int n = primclass == GS_POINT_CLASS ? 1 : primclass == GS_TRIANGLE_CLASS ? 3 : 2;
+
+	GSVertexTraceMinMax8 mm;
+
+	mm.cmin = GSVector8i::xffffffff();
+	mm.cmax = GSVector8i::zero();
+	mm.tmin = GSVector8::broadcast32(s_minmax.xxxx());
+	mm.tmax = GSVector8::broadcast32(s_minmax.yyyy());
+	mm.pmin = GSVector8i::xffffffff();
+	mm.pmax = GSVector8i::zero();
+
+	const GSVertex* RESTRICT v = (GSVertex*)vertex;
+
+	switch(layout)
+	{
+	case IndexLayout::Indexed:
+		FindMinMaxAVX2Loop<primclass, iip, tme, fst, color, accurate_stq>(mm, GSVertexTraceIndexed{v, index}, count, n - 1, n);
+		break;
+	case IndexLayout::List:
+		FindMinMaxAVX2Loop<primclass, iip, tme, fst, color, accurate_stq>(mm, GSVertexTraceSequential{v}, count, n - 1, n);
+		break;
+	case IndexLayout::Strip:
+		// every vertex from the third one is the last vertex of a triangle
+		FindMinMaxAVX2Loop<primclass, iip, tme, fst, color, accurate_stq>(mm, GSVertexTraceSequential{v}, count / 3 + 2, 2, 1);
+		break;
+	}
+
+	GSVector4i cmin = mm.cmin.extract<0>().min_u8(mm.cmin.extract<1>());
+	GSVector4i cmax = mm.cmax.extract<0>().max_u8(mm.cmax.extract<1>());
+	GSVector4 tmin = mm.tmin.extract<0>().min(mm.tmin.extract<1>());
+	GSVector4 tmax = mm.tmax.extract<0>().max(mm.tmax.extract<1>());
+	GSVector4i pmin = mm.pmin.extract<0>().min_u32(mm.pmin.extract<1>());
+	GSVector4i pmax = mm.pmax.extract<0>().max_u32(mm.pmax.extract<1>());
+
+	// see FindMinMax
+
+	pmin = pmin.blend16<0x30>(pmin.srl32(1));
+	pmax = pmax.blend16<0x30>(pmax.srl32(1));
+
+	StoreMinMax<tme, fst, color>(cmin, cmax, tmin, tmax, GSVector4(pmin), GSVector4(pmax));
+}
+
+#endif
+
+// Replays the captured draws through each FindMinMax variant, checks that they
+// agree with the indexed SSE version and prints the throughput.
+
+void GSVertexTrace::Benchmark()
+{
+	enum {SSE, AVX2, AVX2_IndexFree, VariantLast};
+
+	static const char* name[VariantLast] = {"SSE", "AVX2", "AVX2 index-free"};
+
+	size_t vertices = 0;
+	size_t index_free = 0;
+
+	for(auto& d : m_bench)
+	{
+		vertices += d.count;
+
+		index_free += d.layout != IndexLayout::Indexed;
+	}
+
+	fprintf(stderr, "Vertex Trace: benchmark over %d draws, %d vertices (%d index-free)\n", (int)m_bench.size(), (int)vertices, (int)index_free);
+
+	std::vector<Vertex> ref(m_bench.size() * 2);
+
+	for(int variant = SSE; variant < VariantLast; variant++)
+	{
+		#if _M_SSE < 0x501
+		if(variant != SSE) break;
+		#endif
+
+		auto run = [&](const BenchDraw& d)
+		{
+			#if _M_SSE >= 0x501
+			if(variant != SSE)
+			{
+				IndexLayout layout = variant == AVX2_IndexFree ? d.layout : IndexLayout::Indexed;
+
+				const GSVertex* v = layout == IndexLayout::Indexed ? d.vertex : d.vertex + d.index[0];
+
+				(this->*m_fmm_avx2[m_accurate_stq][d.color][d.fst][d.tme][d.iip][d.primclass])(v, d.index, d.count, layout);
+
+				return;
+			}
+			#endif
+
+			(this->*m_fmm[m_accurate_stq][d.color][d.fst][d.tme][d.iip][d.primclass])(d.vertex, d.index, d.count);
+		};
+
+		int mismatch = 0;
+
+		for(size_t i = 0; i < m_bench.size(); i++)
+		{
+			run(m_bench[i]);
+
+			if(variant == SSE)
+			{
+				ref[i * 2 + 0] = m_min;
+				ref[i * 2 + 1] = m_max;
+			}
+			else if(memcmp(&ref[i * 2 + 0], &m_min, sizeof(Vertex)) != 0 || memcmp(&ref[i * 2 + 1], &m_max, sizeof(Vertex)) != 0)
+			{
+				mismatch++;
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed;
+		size_t total = 0;
+
+		do
+		{
+			for(auto& d : m_bench)
+			{
+				run(d);
+			}
+
+			total += vertices;
+
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+		while(elapsed.count() < 0.5);
+
+		fprintf(stderr, "Vertex Trace: %-16s %8.2f Mvertices/s, %d mismatch\n", name[variant], total / elapsed.count() / 1e6, mismatch);
+	}
+
+	for(auto& d : m_bench)
+	{
+		_aligned_free(d.vertex);
+		_aligned_free(d.index);
+	}
+
+	m_bench.clear();
+	m_bench_draws = 0;
+}
+
 void GSVertexTrace::CorrectDepthTrace(const void* vertex, int count)
 {
 	if (m_eq.z == 0)
@@ -38,6 +38,9 @@ public:
 	struct VertexAlpha {int min, max; bool valid;};
 	bool m_accurate_stq;
 
+	// List: index[i] == index[0] + i, Strip: (k, k + 1, k + 2) for each triangle
+	enum class IndexLayout {Indexed, List, Strip};
+
 protected:
 	const GSState* m_state;
 
@@ -50,6 +53,39 @@ protected:
 	template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
 	void FindMinMax(const void* vertex, const uint32* index, int count);
 
+	#if _M_SSE >= 0x501
+
+	typedef void (GSVertexTrace::*FindMinMaxAVX2Ptr)(const void* vertex, const uint32* index, int count, IndexLayout layout);
+
+	FindMinMaxAVX2Ptr m_fmm_avx2[2][2][2][2][2][4];
+
+	template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
+	void FindMinMaxAVX2(const void* vertex, const uint32* index, int count, IndexLayout layout);
+
+	#endif
+
+	template<uint32 tme, uint32 fst, uint32 color>
+	void StoreMinMax(const GSVector4i& cmin, const GSVector4i& cmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4& pmin, const GSVector4& pmax);
+
+	void UpdateMinMax(const void* vertex, const uint32* index, int count, GS_PRIM_CLASS primclass, IndexLayout layout, uint32 iip, uint32 tme, uint32 fst, uint32 color);
+
+	// Draws captured for the FindMinMax benchmark (vertex_trace_bench)
+
+	struct BenchDraw
+	{
+		GSVertex* vertex;
+		uint32* index;
+		int count;
+		GS_PRIM_CLASS primclass;
+		IndexLayout layout;
+		uint32 iip, tme, fst, color;
+	};
+
+	std::vector<BenchDraw> m_bench;
+	size_t m_bench_draws;
+
+	void Benchmark();
+
 public:
 	GS_PRIM_CLASS m_primclass;
 
@@ -75,9 +111,10 @@ public:
 	static void InitVectors();
 
 	GSVertexTrace(const GSState* state);
-	virtual ~GSVertexTrace() {}
+	virtual ~GSVertexTrace();
 
-	void Update(const void* vertex, const uint32* index, int v_count, int i_count, GS_PRIM_CLASS primclass);
+	// layout is how the caller built the index buffer, Indexed when it doesn't know
+	void Update(const void* vertex, const uint32* index, int v_count, int i_count, GS_PRIM_CLASS primclass, IndexLayout layout = IndexLayout::Indexed);
 
 	bool IsLinear() const {return m_filter.opt_linear;}
 	bool IsRealLinear() const {return m_filter.linear;}
@@ -26,6 +26,7 @@
 
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
+bool GSTextureCache::m_texture_hashing = false;
 
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
@@ -50,6 +51,7 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	}
 
 	m_paltex = theApp.GetConfigB("paltex");
+	m_texture_hashing = theApp.GetConfigB("texture_cache_hash");
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
 	if (m_crc_hack_level == CRCHackLevel::Automatic)
 		m_crc_hack_level = GSUtil::GetRecommendedCRCHackLevel(theApp.GetCurrentRendererType());
@@ -841,6 +843,20 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 					}
 					else
 					{
+						if(m_texture_hashing)
+						{
+							if(!target)
+							{
+								s->m_hashed = false;
+								s->m_hash_blocked = true;
+							}
+							else if(!s->m_hashed && !s->m_hash_blocked)
+							{
+								// GS memory is about to be overwritten, it still holds the uploaded data
+								s->SaveHash();
+							}
+						}
+
 						uint32* RESTRICT valid = s->m_valid;
 
 						// Invalidate data of input texture
@@ -1615,6 +1631,12 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 	, m_p2t(NULL)
 	, m_from_target(NULL)
 	, m_from_target_TEX0(TEX0)
+	, m_pages_as_bit(NULL)
+	, m_hash(0)
+	, m_valid_hashed(NULL)
+	, m_complete_hashed(false)
+	, m_hashed(false)
+	, m_hash_blocked(false)
 {
 	m_TEX0 = TEX0;
 	m_TEXA = TEXA;
@@ -1650,6 +1672,152 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 GSTextureCache::Source::~Source()
 {
 	_aligned_free(m_write.rect);
+	_aligned_free(m_valid_hashed);
+}
+
+static __forceinline GSVector4i HashMul32(const GSVector4i& a, const GSVector4i& b)
+{
+#if _M_SSE >= 0x401
+	return GSVector4i(_mm_mullo_epi32(a, b));
+#else
+	GSVector4i lo = GSVector4i(_mm_mul_epu32(a, b));
+	GSVector4i hi = GSVector4i(_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)));
+
+	return GSVector4i(_mm_unpacklo_epi32(_mm_shuffle_epi32(lo, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 0, 2, 0))));
+#endif
+}
+
+// Hashes the 8KB pages selected by the page bitmap. Four independent 16 byte lanes
+// keep the multiplies pipelined, the lanes are only folded together at the end.
+static uint64 HashPages(const uint8* RESTRICT vm, const uint32* RESTRICT pages_as_bit, uint64& bytes)
+{
+	const GSVector4i prime((int)0x9e3779b1);
+
+	GSVector4i a0((int)0x85ebca77);
+	GSVector4i a1((int)0xc2b2ae3d);
+	GSVector4i a2(0x27d4eb2f);
+	GSVector4i a3(0x165667b1);
+
+	for(int i = 0; i < 16; i++)
+	{
+		uint32 p = pages_as_bit[i];
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, p))
+		{
+			p ^= 1U << j;
+
+			uint32 page = (i << 5) + j;
+
+			const GSVector4i* RESTRICT src = (const GSVector4i*)&vm[page << 13];
+
+			a0 ^= GSVector4i((int)page);
+
+			for(int k = 0; k < 512; k += 4)
+			{
+				a0 = HashMul32(a0 + src[k + 0], prime);
+				a1 = HashMul32(a1 + src[k + 1], prime);
+				a2 = HashMul32(a2 + src[k + 2], prime);
+				a3 = HashMul32(a3 + src[k + 3], prime);
+
+				a0 ^= a0.srl32(15);
+				a1 ^= a1.srl32(15);
+				a2 ^= a2.srl32(15);
+				a3 ^= a3.srl32(15);
+			}
+
+			bytes += 8192;
+		}
+	}
+
+	GSVector4i h = HashMul32(a0 ^ a1.srl32(7), prime) ^ HashMul32(a2 ^ a3.srl32(7), prime).sll32(1);
+
+	uint64 lo = (uint64)(uint32)h.extract32<0>() | ((uint64)(uint32)h.extract32<1>() << 32);
+	uint64 hi = (uint64)(uint32)h.extract32<2>() | ((uint64)(uint32)h.extract32<3>() << 32);
+
+	return lo ^ (hi * 0x9e3779b97f4a7c15ull);
+}
+
+void GSTextureCache::Source::SaveHash()
+{
+	if(m_valid_hashed == NULL)
+	{
+		m_valid_hashed = (uint32*)_aligned_malloc(sizeof(m_valid), 32);
+	}
+
+	uint32 any = 0;
+
+	for(int i = 0; i < 16; i++)
+	{
+		uint32 p = m_pages_as_bit[i];
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, p))
+		{
+			p ^= 1U << j;
+
+			uint32 page = (i << 5) + j;
+
+			m_valid_hashed[page] = m_valid[page];
+
+			any |= m_valid[page];
+		}
+	}
+
+	if(any == 0)
+	{
+		return; // nothing uploaded yet, nothing to save
+	}
+
+	uint64 bytes = 0;
+
+	m_hash = HashPages(m_renderer->m_mem.m_vm8, m_pages_as_bit, bytes);
+	m_complete_hashed = m_complete;
+	m_hashed = true;
+
+	m_renderer->m_perfmon.Put(GSPerfMon::TextureHash, bytes);
+}
+
+bool GSTextureCache::Source::RestoreHash()
+{
+	m_hashed = false;
+
+	uint64 bytes = 0;
+
+	uint64 hash = HashPages(m_renderer->m_mem.m_vm8, m_pages_as_bit, bytes);
+
+	m_renderer->m_perfmon.Put(GSPerfMon::TextureHash, bytes);
+
+	if(hash != m_hash)
+	{
+		m_renderer->m_perfmon.Put(GSPerfMon::TextureReupload, 1);
+
+		return false;
+	}
+
+	for(int i = 0; i < 16; i++)
+	{
+		uint32 p = m_pages_as_bit[i];
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, p))
+		{
+			p ^= 1U << j;
+
+			uint32 page = (i << 5) + j;
+
+			m_valid[page] |= m_valid_hashed[page];
+		}
+	}
+
+	m_complete |= m_complete_hashed;
+
+	m_renderer->m_perfmon.Put(GSPerfMon::TextureHashHit, 1);
+
+	return true;
 }
 
 void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
@@ -1661,6 +1829,16 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 		return;
 	}
 
+	if(layer == 0)
+	{
+		m_hash_blocked = false;
+
+		if(m_hashed && RestoreHash() && m_complete)
+		{
+			return;
+		}
+	}
+
 	const GSVector2i& bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
 
 	int tw = std::max<int>(1 << m_TEX0.TW, bs.x);
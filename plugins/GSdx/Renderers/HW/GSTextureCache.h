@@ -118,6 +118,17 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		uint32* m_pages_as_bit;
+		// Content hash of the GS memory pages, taken on the first invalidation after the
+		// texture was in sync. m_valid_hashed keeps the matching valid bits so they can be
+		// restored when a transfer leaves the data unchanged.
+		uint64 m_hash;
+		uint32* m_valid_hashed;
+		bool m_complete_hashed;
+		bool m_hashed;
+		bool m_hash_blocked; // a draw wrote into the pages, GS memory isn't authoritative
+
+		void SaveHash();
+		bool RestoreHash();
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container = false);
@@ -212,6 +223,8 @@ protected:
 	static bool m_disable_partial_invalidation;
 	bool m_texture_inside_rt;
 	static bool m_wrap_gs_mem;
+	static bool m_texture_hashing;
+
 	uint8 m_texture_inside_rt_cache_size = 255;
 	std::vector<TexInsideRtCacheEntry> m_texture_inside_rt_cache;
 
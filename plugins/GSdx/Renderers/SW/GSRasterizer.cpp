@@ -44,6 +44,7 @@ GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* pe
 	, m_ds(ds)
 	, m_id(id)
 	, m_threads(threads)
+	, m_trace(format("GSdx rasterizer %d", id).c_str())
 {
 	memset(&m_pixels, 0, sizeof(m_pixels));
 
@@ -134,6 +135,7 @@ int GSRasterizer::GetPixels(bool reset)
 void GSRasterizer::Draw(GSRasterizerData* data)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
+	TraceEvents::Scope trace(m_trace, "GSRasterizer::Draw");
 
 	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
 
@@ -1139,6 +1141,8 @@ void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& sca
 
 GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 	: m_perfmon(perfmon)
+	, m_pending(threads)
+	, m_sleeps(0)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
@@ -1172,20 +1176,60 @@ void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 
 	while(top < bottom)
 	{
-		m_workers[m_scanline[top++]]->Push(data);
+		int i = m_scanline[top++];
+
+		m_pending[i].push_back(data);
+
+		// a worker which ran dry needs the job now, a busy one gets a batch later
+
+		if(m_pending[i].size() >= MAX_PENDING || m_workers[i]->IsEmpty())
+		{
+			Flush(i);
+		}
+	}
+
+	// a busy worker may have run dry since its jobs were held back, don't let it idle until the next sync
+
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		if(!m_pending[i].empty() && m_workers[i]->IsEmpty())
+		{
+			Flush(i);
+		}
 	}
 }
 
+void GSRasterizerList::Flush(int i)
+{
+	m_workers[i]->Push(m_pending[i].data(), m_pending[i].size());
+	m_pending[i].clear();
+}
+
 void GSRasterizerList::Sync()
 {
 	if(!IsSynced())
 	{
+		for(size_t i = 0; i < m_workers.size(); i++)
+		{
+			if(!m_pending[i].empty())
+			{
+				Flush(i);
+			}
+		}
+
+		uint64 sleeps = 0;
+
 		for(size_t i = 0; i < m_workers.size(); i++)
 		{
 			m_workers[i]->Wait();
+
+			sleeps += m_workers[i]->GetStats().sleeps;
 		}
 
 		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
+		m_perfmon->Put(GSPerfMon::WorkerSleep, (double)(sleeps - m_sleeps));
+
+		m_sleeps = sleeps;
 	}
 }
 
@@ -1193,7 +1237,7 @@ bool GSRasterizerList::IsSynced() const
 {
 	for(size_t i = 0; i < m_workers.size(); i++)
 	{
-		if(!m_workers[i]->IsEmpty())
+		if(!m_pending[i].empty() || !m_workers[i]->IsEmpty())
 		{
 			return false;
 		}
@@ -27,6 +27,7 @@
 #include "GSAlignedClass.h"
 #include "GSPerfMon.h"
 #include "GSThread_CXX11.h"
+#include "Utilities/TraceEvents.h"
 
 class alignas(32) GSRasterizerData : public GSAlignedClass<32>
 {
@@ -136,6 +137,7 @@ protected:
 	GSVector4 m_fscissor_y;
 	struct {GSVertexSW* buff; int count;} m_edge;
 	struct {int sum, actual, total;} m_pixels;
+	TraceEvents::Track m_trace;
 
 	typedef void (GSRasterizer::*DrawPrimPtr)(const GSVertexSW* v, int count);
 
@@ -187,11 +189,18 @@ protected:
 	// Worker threads depend on the rasterizers, so don't change the order.
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
 	std::vector<std::unique_ptr<GSWorker>> m_workers;
+	// Jobs not pushed yet, a busy worker gets up to MAX_PENDING of them with one Push.
+	std::vector<std::vector<std::shared_ptr<GSRasterizerData>>> m_pending;
 	uint8* m_scanline;
 	int m_thread_height;
+	uint64 m_sleeps; // worker sleeps already reported to m_perfmon
+
+	static const size_t MAX_PENDING = 8;
 
 	GSRasterizerList(int threads, GSPerfMon* perfmon);
 
+	void Flush(int i);
+
 public:
 	virtual ~GSRasterizerList();
 
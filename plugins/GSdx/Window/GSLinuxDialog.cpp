@@ -555,8 +555,10 @@ void populate_record_table(GtkWidget* record_table)
 	GtkWidget* resxy_label   = left_label("Resolution:");
 	GtkWidget* resx_spin     = CreateSpinButton(256, 8192, "CaptureWidth");
 	GtkWidget* resy_spin     = CreateSpinButton(256, 8192, "CaptureHeight");
-	GtkWidget* threads_label = left_label("Saving Threads:");
-	GtkWidget* threads_spin  = CreateSpinButton(1, 32, "capture_threads");
+	GtkWidget* threads_label = left_label("Saving Threads (0 = auto):");
+	GtkWidget* threads_spin  = CreateSpinButton(0, 32, "capture_threads");
+	GtkWidget* format_label  = left_label("Format:");
+	GtkWidget* format_combo  = CreateComboBoxFromVector(theApp.m_gs_capture_format, "capture_format");
 	GtkWidget* out_dir_label = left_label("Output Directory:");
 	GtkWidget* out_dir       = CreateFileChooser(GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER, "Select a directory", "capture_out_dir");
 	GtkWidget* png_label     = left_label("PNG Compression Level:");
@@ -565,6 +567,7 @@ void populate_record_table(GtkWidget* record_table)
 	InsertWidgetInTable(record_table , capture_check);
 	InsertWidgetInTable(record_table , resxy_label   , resx_spin      , resy_spin);
 	InsertWidgetInTable(record_table , threads_label , threads_spin);
+	InsertWidgetInTable(record_table , format_label  , format_combo);
 	InsertWidgetInTable(record_table , png_label     , png_level);
 	InsertWidgetInTable(record_table , out_dir_label , out_dir);
 }
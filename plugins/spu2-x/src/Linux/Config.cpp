@@ -76,6 +76,7 @@ bool _visual_debug_enabled = false; // windows only feature
 u32 OutputModule = 0;
 int SndOutLatencyMS = 300;
 int SynchMode = 0; // Time Stretch, Async or Disabled
+bool ThreadedOutput = false; // Run dsp/timestretch/output on their own thread
 static u32 OutputAPI = 0;
 static u32 SdlOutputAPI = 0;
 
@@ -157,6 +158,7 @@ void ReadSettings()
 
     SndOutLatencyMS = CfgReadInt(L"OUTPUT", L"Latency", 300);
     SynchMode = CfgReadInt(L"OUTPUT", L"Synch_Mode", 0);
+    ThreadedOutput = CfgReadBool(L"OUTPUT", L"Threaded_Output", false);
 
     PortaudioOut->ReadSettings();
 #ifdef __unix__
@@ -207,6 +209,7 @@ void WriteSettings()
     CfgWriteStr(L"OUTPUT", L"Output_Module", mods[OutputModule]->GetIdent());
     CfgWriteInt(L"OUTPUT", L"Latency", SndOutLatencyMS);
     CfgWriteInt(L"OUTPUT", L"Synch_Mode", SynchMode);
+    CfgWriteBool(L"OUTPUT", L"Threaded_Output", ThreadedOutput);
     CfgWriteInt(L"DEBUG", L"DelayCycles", delayCycles);
 
     PortaudioOut->WriteSettings();
@@ -281,6 +284,7 @@ void DisplayDialog()
     GtkWidget *volume_label, *volume_slide;
     GtkWidget *sync_label, *sync_box;
     GtkWidget *advanced_button;
+    GtkWidget *thread_check;
 
     /* Create the widgets */
     dialog = gtk_dialog_new_with_buttons(
@@ -356,6 +360,8 @@ void DisplayDialog()
 
     advanced_button = gtk_button_new_with_label("Advanced...");
 
+    thread_check = gtk_check_button_new_with_label("Filter and output on a separate thread");
+
     main_box = ps_gtk_hbox_new(5);
 
     mixing_box = ps_gtk_vbox_new(5);
@@ -396,6 +402,7 @@ void DisplayDialog()
     gtk_container_add(GTK_CONTAINER(output_box), volume_label);
     gtk_container_add(GTK_CONTAINER(output_box), volume_slide);
     gtk_container_add(GTK_CONTAINER(output_box), advanced_button);
+    gtk_container_add(GTK_CONTAINER(output_box), thread_check);
 
     gtk_box_pack_start(GTK_BOX(main_box), mixing_frame, TRUE, TRUE, 5);
     gtk_box_pack_start(GTK_BOX(main_box), output_frame, TRUE, TRUE, 5);
@@ -403,6 +410,7 @@ void DisplayDialog()
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(effects_check), EffectsDisabled);
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(dealias_filter), postprocess_filter_dealias);
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(debug_check), DebugEnabled);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(thread_check), ThreadedOutput);
     gtk_widget_set_sensitive(GTK_WIDGET(debug_button), DebugEnabled);
     temp_debug_state = DebugEnabled;
 
@@ -426,6 +434,7 @@ void DisplayDialog()
             Interpolation = gtk_combo_box_get_active(GTK_COMBO_BOX(int_box));
 
         EffectsDisabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(effects_check));
+        ThreadedOutput = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(thread_check));
 
         if (gtk_combo_box_get_active(GTK_COMBO_BOX(mod_box)) != -1)
             OutputModule = gtk_combo_box_get_active(GTK_COMBO_BOX(mod_box));
@@ -16,6 +16,7 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
 
 // Games have turned out to be surprisingly sensitive to whether a parked, silent voice is being fully emulated.
 // With Silent Hill: Shattered Memories requiring full processing for no obvious reason, we've decided to
@@ -329,39 +330,109 @@ static __forceinline void CalculateADSR(V_Core &thiscore, uint voiceidx)
     pxAssume(vc.ADSR.Value >= 0); // ADSR should never be negative...
 }
 
+// Per-voice state handed from the (scalar) voice update to the vectorised mixing pass.
+// Everything that can raise IRQs, set ENDX or stop a voice -- pitch, ADPCM fetch, ADSR,
+// crest and the voice 1/3 write-back -- still runs one voice at a time and in order.
+// Interpolation, the ADSR multiply, volume and the dry/wet gating then run four voices
+// per instruction on these arrays, using the same integer arithmetic as the scalar
+// formulas so the output is bit-exact.
+struct VoiceMixLanes
+{
+    __aligned16 s32 PV1[V_Core::NumVoices];
+    __aligned16 s32 PV2[V_Core::NumVoices];
+    __aligned16 s32 PV3[V_Core::NumVoices];
+    __aligned16 s32 PV4[V_Core::NumVoices];
+    __aligned16 s32 SP[V_Core::NumVoices];
+    __aligned16 s32 Noise[V_Core::NumVoices];
+    __aligned16 s32 NoiseMask[V_Core::NumVoices];
+    __aligned16 s32 ADSR[V_Core::NumVoices];
+    __aligned16 s32 VolL[V_Core::NumVoices];
+    __aligned16 s32 VolR[V_Core::NumVoices];
+    __aligned16 s32 DryL[V_Core::NumVoices];
+    __aligned16 s32 DryR[V_Core::NumVoices];
+    __aligned16 s32 WetL[V_Core::NumVoices];
+    __aligned16 s32 WetR[V_Core::NumVoices];
+};
+
+static_assert((V_Core::NumVoices & 3) == 0, "Voice lanes are processed four at a time");
+
+// SSE2 has no 32 bit mullo; the low half of the unsigned product is the same for
+// signed inputs.
+static __forceinline __m128i MulLo32(const __m128i &a, const __m128i &b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Vector MulShr32: signed 32x32 multiply, returning the high 32 bits.  Built from the
+// unsigned products with the usual sign corrections.
+static __forceinline __m128i MulShr32(const __m128i &a, const __m128i &b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    __m128i hi = _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 3, 1)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 3, 1)));
+
+    hi = _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(a, 31), b));
+    hi = _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(b, 31), a));
+
+    return hi;
+}
+
 /*
    Tension: 65535 is high, 32768 is normal, 0 is low
 */
 template <s32 i_tension>
-__forceinline static s32 HermiteInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+__forceinline static __m128i HermiteInterpolate(
+    const __m128i &y0, // 16.0
+    const __m128i &y1, // 16.0
+    const __m128i &y2, // 16.0
+    const __m128i &y3, // 16.0
+    const __m128i &mu  //  0.12
     )
 {
-    s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
-    s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m0 = m00 + m01;
+    const __m128i tension = _mm_set1_epi32(i_tension);
 
-    s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
-    s32 m1 = m10 + m11;
+    __m128i m00 = _mm_srai_epi32(MulLo32(_mm_sub_epi32(y1, y0), tension), 16); // 16.0
+    __m128i m01 = _mm_srai_epi32(MulLo32(_mm_sub_epi32(y2, y1), tension), 16); // 16.0
+    __m128i m0 = _mm_add_epi32(m00, m01);
 
-    s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
-    val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
-    val = ((val + m0) * mu) >> 11;                            // 16.0
+    __m128i m10 = m01;                                                         // 16.0
+    __m128i m11 = _mm_srai_epi32(MulLo32(_mm_sub_epi32(y3, y2), tension), 16); // 16.0
+    __m128i m1 = _mm_add_epi32(m10, m11);
 
-    return (val + (y1 << 1));
+    const __m128i y1x2 = _mm_slli_epi32(y1, 1);
+    const __m128i y2x2 = _mm_slli_epi32(y2, 1);
+
+    // ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12
+    __m128i val = _mm_sub_epi32(_mm_add_epi32(_mm_add_epi32(y1x2, m0), m1), y2x2);
+    val = _mm_srai_epi32(MulLo32(val, mu), 12);
+
+    // ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12
+    val = _mm_sub_epi32(val, _mm_add_epi32(y1x2, y1));
+    val = _mm_sub_epi32(val, _mm_slli_epi32(m0, 1));
+    val = _mm_sub_epi32(val, m1);
+    val = _mm_add_epi32(val, _mm_add_epi32(y2x2, y2));
+    val = _mm_srai_epi32(MulLo32(val, mu), 12);
+
+    // ((val + m0) * mu) >> 11
+    val = _mm_srai_epi32(MulLo32(_mm_add_epi32(val, m0), mu), 11);
+
+    return _mm_add_epi32(val, y1x2);
 }
 
-__forceinline static s32 CatmullRomInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+__forceinline static __m128i CatmullRomInterpolate(
+    const __m128i &y0, // 16.0
+    const __m128i &y1, // 16.0
+    const __m128i &y2, // 16.0
+    const __m128i &y3, // 16.0
+    const __m128i &mu  //  0.12
     )
 {
     //q(t) = 0.5 *(    	(2 * P1) +
@@ -369,42 +440,51 @@ __forceinline static s32 CatmullRomInterpolate(
     //	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
     //	(-P0 + 3*P1- 3*P2 + P3) * t3)
 
-    s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
-    s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
-    s32 a1 = (-y0 + y2);
-    s32 a0 = (2 * y1);
-
-    s32 val = ((a3)*mu) >> 12;
-    val = ((a2 + val) * mu) >> 12;
-    val = ((a1 + val) * mu) >> 12;
-
-    return (a0 + val);
+    const __m128i y1x3 = _mm_add_epi32(_mm_slli_epi32(y1, 1), y1);
+    const __m128i y2x3 = _mm_add_epi32(_mm_slli_epi32(y2, 1), y2);
+
+    // a3 = -y0 + 3 * y1 - 3 * y2 + y3
+    const __m128i a3 = _mm_add_epi32(_mm_sub_epi32(_mm_sub_epi32(y1x3, y0), y2x3), y3);
+    // a2 = 2 * y0 - 5 * y1 + 4 * y2 - y3
+    const __m128i a2 = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(_mm_slli_epi32(y0, 1), _mm_slli_epi32(y2, 2)),
+                                                   _mm_add_epi32(_mm_slli_epi32(y1, 2), y1)),
+                                     y3);
+    // a1 = -y0 + y2
+    const __m128i a1 = _mm_sub_epi32(y2, y0);
+    // a0 = 2 * y1
+    const __m128i a0 = _mm_slli_epi32(y1, 1);
+
+    __m128i val = _mm_srai_epi32(MulLo32(a3, mu), 12);
+    val = _mm_srai_epi32(MulLo32(_mm_add_epi32(a2, val), mu), 12);
+    val = _mm_srai_epi32(MulLo32(_mm_add_epi32(a1, val), mu), 12);
+
+    return _mm_add_epi32(a0, val);
 }
 
-__forceinline static s32 CubicInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+__forceinline static __m128i CubicInterpolate(
+    const __m128i &y0, // 16.0
+    const __m128i &y1, // 16.0
+    const __m128i &y2, // 16.0
+    const __m128i &y3, // 16.0
+    const __m128i &mu  //  0.12
     )
 {
-    const s32 a0 = y3 - y2 - y0 + y1;
-    const s32 a1 = y0 - y1 - a0;
-    const s32 a2 = y2 - y0;
+    const __m128i a0 = _mm_add_epi32(_mm_sub_epi32(_mm_sub_epi32(y3, y2), y0), y1);
+    const __m128i a1 = _mm_sub_epi32(_mm_sub_epi32(y0, y1), a0);
+    const __m128i a2 = _mm_sub_epi32(y2, y0);
 
-    s32 val = ((a0)*mu) >> 12;
-    val = ((val + a1) * mu) >> 12;
-    val = ((val + a2) * mu) >> 11;
+    __m128i val = _mm_srai_epi32(MulLo32(a0, mu), 12);
+    val = _mm_srai_epi32(MulLo32(_mm_add_epi32(val, a1), mu), 12);
+    val = _mm_srai_epi32(MulLo32(_mm_add_epi32(val, a2), mu), 11);
 
-    return (val + (y1 << 1));
+    return _mm_add_epi32(val, _mm_slli_epi32(y1, 1));
 }
 
-// Returns a 16 bit result in Value.
-// Uses standard template-style optimization techniques to statically generate five different
-// versions of this function (one for each type of interpolation).
+// Advances the voice's sample position, decoding ADPCM as needed.  This can trigger IRQs
+// and loop/end events, so it stays scalar; the interpolation itself is done by
+// InterpolateVoices.
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
+static __forceinline void FetchVoiceValues(V_Core &thiscore, uint voiceidx)
 {
     V_Voice &vc(thiscore.Voices[voiceidx]);
 
@@ -417,26 +497,44 @@ static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
         vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
         vc.SP -= 4096;
     }
+}
 
-    const s32 mu = vc.SP + 4096;
+// Returns four 16 bit results, one per voice lane.
+// Uses standard template-style optimization techniques to statically generate five different
+// versions of this function (one for each type of interpolation).
+template <int InterpType>
+static __forceinline __m128i InterpolateVoices(const VoiceMixLanes &lanes, uint voiceidx)
+{
+    const __m128i PV1 = _mm_load_si128((const __m128i *)&lanes.PV1[voiceidx]);
+    const __m128i PV2 = _mm_load_si128((const __m128i *)&lanes.PV2[voiceidx]);
+    const __m128i SP = _mm_load_si128((const __m128i *)&lanes.SP[voiceidx]);
 
     switch (InterpType) {
         case 0:
-            return vc.PV1 << 1;
+            return _mm_slli_epi32(PV1, 1);
         case 1:
-            return (vc.PV1 << 1) - (((vc.PV2 - vc.PV1) * vc.SP) >> 11);
+            return _mm_sub_epi32(_mm_slli_epi32(PV1, 1), _mm_srai_epi32(MulLo32(_mm_sub_epi32(PV2, PV1), SP), 11));
+
+        default:
+            break;
+    }
 
+    const __m128i PV3 = _mm_load_si128((const __m128i *)&lanes.PV3[voiceidx]);
+    const __m128i PV4 = _mm_load_si128((const __m128i *)&lanes.PV4[voiceidx]);
+    const __m128i mu = _mm_add_epi32(SP, _mm_set1_epi32(4096));
+
+    switch (InterpType) {
         case 2:
-            return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return CubicInterpolate(PV4, PV3, PV2, PV1, mu);
         case 3:
-            return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return HermiteInterpolate<16384>(PV4, PV3, PV2, PV1, mu);
         case 4:
-            return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return CatmullRomInterpolate(PV4, PV3, PV2, PV1, mu);
 
             jNO_DEFAULT;
     }
 
-    return 0; // technically unreachable!
+    return _mm_setzero_si128(); // technically unreachable!
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -455,7 +553,7 @@ static __forceinline s32 GetNoiseValues(V_Core &thiscore, uint voiceidx)
 	}*/
 
     // GetNoiseValues can't set the phase zero on us unexpectedly
-    // like GetVoiceValues can.  Better assert just in case though..
+    // like FetchVoiceValues can.  Better assert just in case though..
     // pxAssume(vc.ADSR.Phase != 0);
 
     return retval;
@@ -485,7 +583,8 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+template <int InterpType>
+static __forceinline void UpdateVoice(VoiceMixLanes &lanes, uint coreidx, uint voiceidx)
 {
     V_Core &thiscore(Cores[coreidx]);
     V_Voice &vc(thiscore.Voices[voiceidx]);
@@ -507,44 +606,31 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
     if (vc.ADSR.Phase > 0) {
         UpdatePitch(coreidx, voiceidx);
 
-        s32 Value = 0;
-
-        if (vc.Noise)
-            Value = GetNoiseValues(thiscore, voiceidx);
-        else {
-            // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-            // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-            switch (Interpolation) {
-                case 0:
-                    Value = GetVoiceValues<0>(thiscore, voiceidx);
-                    break;
-                case 1:
-                    Value = GetVoiceValues<1>(thiscore, voiceidx);
-                    break;
-                case 2:
-                    Value = GetVoiceValues<2>(thiscore, voiceidx);
-                    break;
-                case 3:
-                    Value = GetVoiceValues<3>(thiscore, voiceidx);
-                    break;
-                case 4:
-                    Value = GetVoiceValues<4>(thiscore, voiceidx);
-                    break;
-
-                    jNO_DEFAULT;
-            }
+        if (vc.Noise) {
+            lanes.Noise[voiceidx] = GetNoiseValues(thiscore, voiceidx);
+            lanes.NoiseMask[voiceidx] = -1;
+        } else {
+            FetchVoiceValues<InterpType>(thiscore, voiceidx);
+            lanes.NoiseMask[voiceidx] = 0;
         }
 
-        // Update and Apply ADSR  (applies to normal and noise sources)
+        lanes.PV1[voiceidx] = vc.PV1;
+        lanes.PV2[voiceidx] = vc.PV2;
+        lanes.PV3[voiceidx] = vc.PV3;
+        lanes.PV4[voiceidx] = vc.PV4;
+        lanes.SP[voiceidx] = vc.SP;
+
+        // Update ADSR  (applied to normal and noise sources by MixVoices)
         //
         // Note!  It's very important that ADSR stay as accurate as possible.  By the way
         // it is used, various sound effects can end prematurely if we truncate more than
         // one or two bits.  Best result comes from no truncation at all, which is why we
-        // use a full 64-bit multiply/result here.
+        // use a full 64-bit multiply/result there.
 
         CalculateADSR(thiscore, voiceidx);
-        Value = MulShr32(Value, vc.ADSR.Value);
+        lanes.ADSR[voiceidx] = vc.ADSR.Value;
+        lanes.VolL[voiceidx] = vc.Volume.Left.Value;
+        lanes.VolR[voiceidx] = vc.Volume.Right.Value;
 
         // Store Value for eventual modulation later
         // Pseudonym's Crest calculation idea. Actually calculates a crest, unlike the old code which was just peak.
@@ -565,8 +651,6 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, vc.OutX);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, vc.OutX);
-
-        return ApplyVolume(StereoOut32(Value, Value), vc.Volume);
     } else {
         // Continue processing voice, even if it's "off". Or else we miss interrupts! (Fatal Frame engine died because of this.)
         if (NEVER_SKIP_VOICES || (*GetMemPtr(vc.NextA & 0xFFFF8) >> 8 & 3) != 3 || vc.LoopStartA != (vc.NextA & ~7)    // not in a tight loop
@@ -579,31 +663,236 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
                 GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
         }
 
+        // A silent lane: all zero inputs interpolate to zero, and a zero envelope keeps
+        // it that way for the noise path too.
+        lanes.PV1[voiceidx] = 0;
+        lanes.PV2[voiceidx] = 0;
+        lanes.PV3[voiceidx] = 0;
+        lanes.PV4[voiceidx] = 0;
+        lanes.SP[voiceidx] = 0;
+        lanes.NoiseMask[voiceidx] = 0;
+        lanes.ADSR[voiceidx] = 0;
+        lanes.VolL[voiceidx] = 0;
+        lanes.VolR[voiceidx] = 0;
+
         // Write-back of raw voice data (some zeros since the voice is "dead")
         if (voiceidx == 1)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, 0);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, 0);
+    }
+}
+
+static __forceinline s32 HorizontalSum(const __m128i &v)
+{
+    __m128i sum = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// Interpolation, envelope, volume and gating for all voices of a core, four at a time.
+// Results from each voice are ranged at 16 bits.
+template <int InterpType>
+static __forceinline void MixVoices(VoiceMixSet &dest, const VoiceMixLanes &lanes)
+{
+    __m128i dryL = _mm_setzero_si128();
+    __m128i dryR = _mm_setzero_si128();
+    __m128i wetL = _mm_setzero_si128();
+    __m128i wetR = _mm_setzero_si128();
+
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; voiceidx += 4) {
+        const __m128i noiseMask = _mm_load_si128((const __m128i *)&lanes.NoiseMask[voiceidx]);
+        const __m128i noise = _mm_load_si128((const __m128i *)&lanes.Noise[voiceidx]);
+
+        __m128i Value = InterpolateVoices<InterpType>(lanes, voiceidx);
+        Value = _mm_or_si128(_mm_and_si128(noiseMask, noise), _mm_andnot_si128(noiseMask, Value));
+
+        Value = MulShr32(Value, _mm_load_si128((const __m128i *)&lanes.ADSR[voiceidx]));
 
-        return StereoOut32(0, 0);
+        // ApplyVolume: data is shifted up by 1 bit to give the output an effective 16 bit range.
+        Value = _mm_slli_epi32(Value, 1);
+        const __m128i Left = MulShr32(Value, _mm_load_si128((const __m128i *)&lanes.VolL[voiceidx]));
+        const __m128i Right = MulShr32(Value, _mm_load_si128((const __m128i *)&lanes.VolR[voiceidx]));
+
+        dryL = _mm_add_epi32(dryL, _mm_and_si128(Left, _mm_load_si128((const __m128i *)&lanes.DryL[voiceidx])));
+        dryR = _mm_add_epi32(dryR, _mm_and_si128(Right, _mm_load_si128((const __m128i *)&lanes.DryR[voiceidx])));
+        wetL = _mm_add_epi32(wetL, _mm_and_si128(Left, _mm_load_si128((const __m128i *)&lanes.WetL[voiceidx])));
+        wetR = _mm_add_epi32(wetR, _mm_and_si128(Right, _mm_load_si128((const __m128i *)&lanes.WetR[voiceidx])));
+    }
+
+    dest.Dry.Left += HorizontalSum(dryL);
+    dest.Dry.Right += HorizontalSum(dryR);
+    dest.Wet.Left += HorizontalSum(wetL);
+    dest.Wet.Right += HorizontalSum(wetR);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Scalar reference mixer
+//
+// The per-voice integer math MixVoices replaced, kept for checking the lanes against:
+// the benchmark's compare mode replays a log through both and compares the output hashes.
+// It reads the same lanes, so the voice updates (ADPCM, ADSR, IRQs) are shared by both.
+
+template <s32 i_tension>
+__forceinline static s32 HermiteInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
+    s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
+    s32 m0 = m00 + m01;
+
+    s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
+    s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
+    s32 m1 = m10 + m11;
+
+    s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
+    val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
+    val = ((val + m0) * mu) >> 11;                            // 16.0
+
+    return (val + (y1 << 1));
+}
+
+__forceinline static s32 CatmullRomInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
+    s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
+    s32 a1 = (-y0 + y2);
+    s32 a0 = (2 * y1);
+
+    s32 val = ((a3)*mu) >> 12;
+    val = ((a2 + val) * mu) >> 12;
+    val = ((a1 + val) * mu) >> 12;
+
+    return (a0 + val);
+}
+
+__forceinline static s32 CubicInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    const s32 a0 = y3 - y2 - y0 + y1;
+    const s32 a1 = y0 - y1 - a0;
+    const s32 a2 = y2 - y0;
+
+    s32 val = ((a0)*mu) >> 12;
+    val = ((val + a1) * mu) >> 12;
+    val = ((val + a2) * mu) >> 11;
+
+    return (val + (y1 << 1));
+}
+
+template <int InterpType>
+static __forceinline s32 InterpolateVoice(const VoiceMixLanes &lanes, uint voiceidx)
+{
+    const s32 PV1 = lanes.PV1[voiceidx];
+    const s32 PV2 = lanes.PV2[voiceidx];
+    const s32 PV3 = lanes.PV3[voiceidx];
+    const s32 PV4 = lanes.PV4[voiceidx];
+    const s32 SP = lanes.SP[voiceidx];
+    const s32 mu = SP + 4096;
+
+    switch (InterpType) {
+        case 0:
+            return PV1 << 1;
+        case 1:
+            return (PV1 << 1) - (((PV2 - PV1) * SP) >> 11);
+
+        case 2:
+            return CubicInterpolate(PV4, PV3, PV2, PV1, mu);
+        case 3:
+            return HermiteInterpolate<16384>(PV4, PV3, PV2, PV1, mu);
+        case 4:
+            return CatmullRomInterpolate(PV4, PV3, PV2, PV1, mu);
+
+            jNO_DEFAULT;
+    }
+
+    return 0; // technically unreachable!
+}
+
+template <int InterpType>
+static __noinline void MixVoicesScalar(VoiceMixSet &dest, const VoiceMixLanes &lanes)
+{
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
+        s32 Value = lanes.NoiseMask[voiceidx] ? lanes.Noise[voiceidx] : InterpolateVoice<InterpType>(lanes, voiceidx);
+
+        Value = MulShr32(Value, lanes.ADSR[voiceidx]);
+
+        const s32 Left = MulShr32(Value << 1, lanes.VolL[voiceidx]);
+        const s32 Right = MulShr32(Value << 1, lanes.VolR[voiceidx]);
+
+        dest.Dry.Left += Left & lanes.DryL[voiceidx];
+        dest.Dry.Right += Right & lanes.DryR[voiceidx];
+        dest.Wet.Left += Left & lanes.WetL[voiceidx];
+        dest.Wet.Right += Right & lanes.WetR[voiceidx];
     }
 }
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
+template <int InterpType>
+static __forceinline void MixCoreVoices(VoiceMixSet &dest, VoiceMixLanes &lanes, const uint coreidx)
+{
+    // Voices have to be updated in order: modulation reads the previous voice's OutX,
+    // and IRQs/ENDX are raised in the order the voices pass their addresses.
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+        UpdateVoice<InterpType>(lanes, coreidx, voiceidx);
+
+    if (s2r_bench_scalar)
+        MixVoicesScalar<InterpType>(dest, lanes);
+    else
+        MixVoices<InterpType>(dest, lanes);
+}
+
 static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
 {
+    static __aligned16 VoiceMixLanes lanes;
+
     V_Core &thiscore(Cores[coreidx]);
 
     for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
-        StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+        lanes.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+        lanes.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+        lanes.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+        lanes.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+    }
+
+    // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+    // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
 
-        // Note: Results from MixVoice are ranged at 16 bits.
+    switch (Interpolation) {
+        case 0:
+            MixCoreVoices<0>(dest, lanes, coreidx);
+            break;
+        case 1:
+            MixCoreVoices<1>(dest, lanes, coreidx);
+            break;
+        case 2:
+            MixCoreVoices<2>(dest, lanes, coreidx);
+            break;
+        case 3:
+            MixCoreVoices<3>(dest, lanes, coreidx);
+            break;
+        case 4:
+            MixCoreVoices<4>(dest, lanes, coreidx);
+            break;
 
-        dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-        dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-        dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-        dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+            jNO_DEFAULT;
     }
 }
 
@@ -684,7 +973,11 @@ StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, c
 
     WaveDump::WriteCore(Index, CoreSrc_PreReverb, TW);
 
-    StereoOut32 RV = DoReverb(TW);
+    StereoOut32 RV;
+    {
+        S2R_StageTimer timer(S2R_StageReverb);
+        RV = DoReverb(TW);
+    }
 
     WaveDump::WriteCore(Index, CoreSrc_PostReverb, RV);
 
@@ -771,6 +1064,43 @@ StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
     return SoundStream;
 }
 
+// Post-processing of the final mix: the output filters, the final clamp (both skipped for
+// CDDA) and the output volume.  Nothing here feeds back into the emulated SPU2, so it can
+// run on the output thread.
+StereoOut32 ApplyOutputProcessing(StereoOut32 Out, bool filter)
+{
+    if (filter) {
+#ifdef DEBUG_KEYS
+        if (postprocess_filter_enabled)
+#endif
+        {
+            S2R_StageTimer timer(S2R_StageFilters);
+
+            if (postprocess_filter_dealias) {
+                // Dealias filter emphasizes the highs too much.
+                Out = Apply_Dealias_Filter(Out);
+            }
+            Out = Apply_Frequency_Response_Filter(Out);
+        }
+
+        // Final Clamp!
+        // Like any good audio system, the PS2 pumps the volume and incurs some distortion in its
+        // output, giving us a nice thumpy sound at times.  So we add 1 above (2x volume pump) and
+        // then clamp it all here.
+
+        // Edit: I'm sorry Jake, but I know of no good audio system that arbitrary distorts and clips
+        // output by design.
+        // Good thing though that this code gets the volume exactly right, as per tests :)
+        Out = clamp_mix(Out, SndOutVolumeShift);
+    }
+
+    // Configurable output volume
+    Out.Left *= FinalVolume;
+    Out.Right *= FinalVolume;
+
+    return Out;
+}
+
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter = 0;
 
@@ -782,6 +1112,9 @@ __forceinline
     void
     Mix()
 {
+    if (bench_mode)
+        s2r_bench_next_sample();
+
     // Note: Playmode 4 is SPDIF, which overrides other inputs.
     StereoOut32 InputData[2] =
         {
@@ -799,8 +1132,11 @@ __forceinline
 
     // Todo: Replace me with memzero initializer!
     VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-    MixCoreVoices(VoiceData[0], 0);
-    MixCoreVoices(VoiceData[1], 1);
+    {
+        S2R_StageTimer timer(S2R_StageVoices);
+        MixCoreVoices(VoiceData[0], 0);
+        MixCoreVoices(VoiceData[1], 1);
+    }
 
     StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32::Empty));
 
@@ -828,34 +1164,11 @@ __forceinline
     } else {
         Out.Left = MulShr32(Out.Left << (SndOutVolumeShift + 1), Cores[1].MasterVol.Left.Value);
         Out.Right = MulShr32(Out.Right << (SndOutVolumeShift + 1), Cores[1].MasterVol.Right.Value);
-
-#ifdef DEBUG_KEYS
-        if (postprocess_filter_enabled)
-#endif
-        {
-            if (postprocess_filter_dealias) {
-                // Dealias filter emphasizes the highs too much.
-                Out = Apply_Dealias_Filter(Out);
-            }
-            Out = Apply_Frequency_Response_Filter(Out);
-        }
-
-        // Final Clamp!
-        // Like any good audio system, the PS2 pumps the volume and incurs some distortion in its
-        // output, giving us a nice thumpy sound at times.  So we add 1 above (2x volume pump) and
-        // then clamp it all here.
-
-        // Edit: I'm sorry Jake, but I know of no good audio system that arbitrary distorts and clips
-        // output by design.
-        // Good thing though that this code gets the volume exactly right, as per tests :)
-        Out = clamp_mix(Out, SndOutVolumeShift);
     }
 
-    // Configurable output volume
-    Out.Left *= FinalVolume;
-    Out.Right *= FinalVolume;
-
-    SndBuffer::Write(Out);
+    // The filters and the output volume (see ApplyOutputProcessing) are applied by SndBuffer,
+    // which may run them on the output thread.
+    SndBuffer::Write(Out, !(PlayMode & 8));
 
     // Update AutoDMA output positioning
     OutPos++;
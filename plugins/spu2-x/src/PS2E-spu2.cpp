@@ -16,6 +16,8 @@
  */
 
 #include "Global.h"
+#include "Utilities/Telemetry.h"
+#include "Utilities/TraceEvents.h"
 #include "PS2E-spu2.h"
 #include "Dma.h"
 #include "Dialogs.h"
@@ -152,6 +154,14 @@ SPU2configure()
     configure();
 }
 
+// Lets the emulator enable the timeline markers of the output back end and export them along
+// with its own.
+EXPORT_C_(void *)
+SPU2traceRegistry()
+{
+    return &TraceEvents::GetRegistry();
+}
+
 EXPORT_C_(s32)
 SPU2test()
 {
@@ -409,6 +419,9 @@ SPU2open(void *pDsp)
 
     FileLog("[%10d] SPU2 Open\n", Cycles);
 
+    // Publishes the output buffer metrics, if the emulator has enabled telemetry
+    Telemetry::Attach();
+
     if (pDsp != NULL)
         gsWindowHandle = *(uptr *)pDsp;
     else
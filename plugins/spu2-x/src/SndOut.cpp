@@ -16,7 +16,14 @@
  */
 
 #include "Global.h"
+#include "Utilities/Telemetry.h"
+#include "Utilities/TraceEvents.h"
+#include "Spu2replay.h"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 StereoOut32 StereoOut32::Empty(0, 0);
 
@@ -128,9 +135,13 @@ int GetAlignedBufferSize(int comp)
 // is available to be copied.
 bool SndBuffer::CheckUnderrunStatus(int &nSamples, int &quietSampleCount)
 {
+    static Telemetry::Gauge bufferFill("spu2.buffer_fill_pct");
+    static Telemetry::Counter underruns("spu2.underruns");
+
     quietSampleCount = 0;
 
     int data = _GetApproximateDataInBuffer();
+    bufferFill.Set(data * 100.0 / m_size);
     if (m_underrun_freeze) {
         int toFill = m_size / ((SynchMode == 2) ? 32 : 400); // TimeStretch and Async off?
         toFill = GetAlignedBufferSize(toFill);
@@ -150,6 +161,7 @@ bool SndBuffer::CheckUnderrunStatus(int &nSamples, int &quietSampleCount)
         nSamples = data;
         quietSampleCount = SndOutPacketSize - data;
         m_underrun_freeze = true;
+        underruns.Add();
 
         if (SynchMode == 0) // TimeStrech on
             timeStretchUnderrun();
@@ -393,12 +405,20 @@ void SndBuffer::Init()
     soundtouchInit(); // initializes the timestretching
 
     // initialize module
-    if (mods[OutputModule]->Init() == -1)
+    if (mods[OutputModule]->Init() == -1) {
         _InitFail();
+        return;
+    }
+
+    // null output doesn't need buffering or stretching, so there's nothing to move to a thread
+    if (ThreadedOutput && mods[OutputModule] != &NullOut)
+        StartOutputThread();
 }
 
 void SndBuffer::Cleanup()
 {
+    StopOutputThread();
+
     mods[OutputModule]->Close();
 
     soundtouchCleanup();
@@ -413,20 +433,167 @@ int SndBuffer::m_dsp_progress = 0;
 int SndBuffer::m_timestretch_progress = 0;
 int SndBuffer::ssFreeze = 0;
 
+// --------------------------------------------------------------------------------------
+//  Threaded output
+// --------------------------------------------------------------------------------------
+// When ThreadedOutput is enabled the mixer (which has to stay on the IOP thread, since it
+// raises IRQs and updates SPU2 memory) only collects mixed packets.  Everything after
+// that -- the output filters, the DSP plugin, the timestretcher and the copy into the
+// output buffer -- runs on a dedicated thread fed through a single producer / single
+// consumer packet ring.
+//
+// Voice mixing and reverb are not moved: running them ahead of the IOP would need the
+// register writes and DMA to be queued with timestamps, and the mixer caught up whenever
+// the IOP reads IRQ or ENDX state.
+
+static const int OutputQueuePackets = 64; // about 85ms of audio
+
+static StereoOut32 s_outputQueue[OutputQueuePackets][SndOutPacketSize];
+static bool s_outputQueueFilter[OutputQueuePackets][SndOutPacketSize];
+static std::atomic<int> s_outputQueueRead(0);
+static std::atomic<int> s_outputQueueWrite(0);
+static std::atomic<bool> s_outputClear(false);
+
+static std::thread s_outputThread;
+static std::mutex s_outputLock;
+static std::condition_variable s_outputWake;  // signalled when packets are queued
+static std::condition_variable s_outputSpace; // signalled when the output thread frees a packet
+static bool s_outputExit = false;
+static bool s_outputRunning = false;
+
+// Packets are written by the emulator's thread, or by the output thread when it runs.
+static TraceEvents::Track s_traceMixer("SPU2");
+static TraceEvents::Track s_traceOutput("SPU2 output");
+
+void SndBuffer::StartOutputThread()
+{
+    s_outputQueueRead = 0;
+    s_outputQueueWrite = 0;
+    s_outputClear = false;
+    s_outputExit = false;
+
+    s_outputThread = std::thread(&SndBuffer::OutputThreadProc);
+    s_outputRunning = true;
+}
+
+void SndBuffer::StopOutputThread()
+{
+    if (!s_outputRunning)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_outputLock);
+        s_outputExit = true;
+    }
+    s_outputWake.notify_one();
+
+    s_outputThread.join();
+    s_outputRunning = false;
+}
+
+void SndBuffer::OutputThreadProc()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(s_outputLock);
+
+            while (s_outputQueueRead.load(std::memory_order_relaxed) == s_outputQueueWrite.load(std::memory_order_acquire) && !s_outputClear) {
+                if (s_outputExit)
+                    return;
+
+                s_outputWake.wait(lock);
+            }
+        }
+
+        // Savestate loads ask for the stretcher to be flushed; do it here so SoundTouch is
+        // only ever touched from this thread.
+        if (s_outputClear.exchange(false)) {
+            soundtouchClearContents();
+            ssFreeze = 256;
+        }
+
+        int rpos = s_outputQueueRead.load(std::memory_order_relaxed);
+
+        while (rpos != s_outputQueueWrite.load(std::memory_order_acquire)) {
+            for (int i = 0; i < SndOutPacketSize; ++i)
+                sndTempBuffer[i] = _ProcessSample(s_outputQueue[rpos][i], s_outputQueueFilter[rpos][i]);
+            _WritePacket();
+
+            rpos = (rpos + 1) % OutputQueuePackets;
+            {
+                std::lock_guard<std::mutex> lock(s_outputLock);
+                s_outputQueueRead.store(rpos, std::memory_order_release);
+            }
+            s_outputSpace.notify_one();
+        }
+    }
+}
+
 void SndBuffer::ClearContents()
 {
+    if (s_outputRunning) {
+        {
+            std::lock_guard<std::mutex> lock(s_outputLock);
+            s_outputClear = true;
+        }
+        s_outputWake.notify_one();
+        return;
+    }
+
     SndBuffer::soundtouchClearContents();
     SndBuffer::ssFreeze = 256; //Delays sound output for about 1 second.
 }
 
-void SndBuffer::Write(const StereoOut32 &Sample)
+// Applies the output filters and volume to one mixed sample, and logs the result.
+StereoOut32 SndBuffer::_ProcessSample(const StereoOut32 &Mixed, bool filter)
 {
+    const StereoOut32 Sample(ApplyOutputProcessing(Mixed, filter));
+
     // Log final output to wavefile.
     WaveDump::WriteCore(1, CoreSrc_External, Sample.DownSample());
 
     if (WavRecordEnabled)
         RecordWrite(Sample.DownSample());
 
+    if (bench_mode)
+        s2r_bench_sample(Sample);
+
+    return Sample;
+}
+
+// Takes one sample from the mixer, before the output filters (which are skipped when filter
+// is false) and the output volume.
+void SndBuffer::Write(const StereoOut32 &Mixed, bool filter)
+{
+    if (s_outputRunning) {
+        const int wpos = s_outputQueueWrite.load(std::memory_order_relaxed);
+
+        s_outputQueueFilter[wpos][sndTempProgress] = filter;
+        s_outputQueue[wpos][sndTempProgress++] = Mixed;
+
+        if (sndTempProgress < SndOutPacketSize)
+            return;
+        sndTempProgress = 0;
+
+        const int next = (wpos + 1) % OutputQueuePackets;
+
+        {
+            std::unique_lock<std::mutex> lock(s_outputLock);
+
+            // The output thread is a whole ring behind; wait for it rather than drop audio.
+            while (next == s_outputQueueRead.load(std::memory_order_acquire))
+                s_outputSpace.wait(lock);
+
+            s_outputQueueWrite.store(next, std::memory_order_release);
+        }
+        s_outputWake.notify_one();
+        return;
+    }
+
+    const StereoOut32 Sample(_ProcessSample(Mixed, filter));
+
+    S2R_StageTimer timer(S2R_StageOutput);
+
     if (mods[OutputModule] == &NullOut) // null output doesn't need buffering or stretching! :p
         return;
 
@@ -437,6 +604,15 @@ void SndBuffer::Write(const StereoOut32 &Sample)
         return;
     sndTempProgress = 0;
 
+    _WritePacket();
+}
+
+// Passes one full packet in sndTempBuffer through the dsp plugin and timestretcher (when
+// enabled) into the output buffer.
+void SndBuffer::_WritePacket()
+{
+    TraceEvents::Scope trace(s_outputRunning ? s_traceOutput : s_traceMixer, "SPU2 packet");
+
     //Don't play anything directly after loading a savestate, avoids static killing your speakers.
     if (ssFreeze > 0) {
         ssFreeze--;
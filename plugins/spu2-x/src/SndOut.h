@@ -615,11 +615,17 @@ private:
 
     static int _GetApproximateDataInBuffer();
 
+    static StereoOut32 _ProcessSample(const StereoOut32 &Mixed, bool filter);
+    static void _WritePacket();
+    static void OutputThreadProc();
+    static void StartOutputThread();
+    static void StopOutputThread();
+
 public:
     static void UpdateTempoChangeAsyncMixing();
     static void Init();
     static void Cleanup();
-    static void Write(const StereoOut32 &Sample);
+    static void Write(const StereoOut32 &Mixed, bool filter);
     static s32 Test();
     static void ClearContents();
 
@@ -19,6 +19,8 @@
 #include "Global.h"
 #include "PS2E-spu2.h"
 
+#include <chrono>
+
 #ifdef _MSC_VER
 #include "Windows.h"
 #endif
@@ -100,6 +102,9 @@ void s2r_close()
 // replay code
 
 bool replay_mode = false;
+bool bench_mode = false;
+bool s2r_bench_timed = false;
+bool s2r_bench_scalar = false;
 
 u16 dmabuffer[0xFFFFF];
 
@@ -329,3 +334,220 @@ Finish:
     replay_mode = false;
 }
 #endif
+
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+// headless benchmark
+
+u64 s2r_stage_ticks[S2R_StageCount];
+
+static u64 s2r_bench_samples = 0;
+static u64 s2r_bench_hash = 0;
+static u32 s2r_bench_mixed = 0;
+
+u64 s2r_ticks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// FNV-1a over the final (pre-output-module) samples.
+void s2r_bench_sample(const StereoOut32 &sample)
+{
+    const s32 data[2] = {sample.Left, sample.Right};
+    const u8 *bytes = (const u8 *)data;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        s2r_bench_hash ^= bytes[i];
+        s2r_bench_hash *= 0x100000001b3ull;
+    }
+
+    s2r_bench_samples++;
+}
+
+void s2r_bench_next_sample()
+{
+    s2r_bench_timed = (++s2r_bench_mixed % S2R_TimedInterval) == 0;
+}
+
+static void s2r_bench_dummy()
+{
+}
+
+static void s2r_bench_dma4()
+{
+    SPU2interruptDMA4();
+}
+
+static void s2r_bench_dma7()
+{
+    SPU2interruptDMA7();
+}
+
+// Same event loop as s2r_replay, but the clock simply jumps to each event instead of
+// following wall time.  It advances in 10ms steps so TimeUpdate never hits its sanity
+// limit and skips mixing.
+static int s2r_bench_run(const char *filename, bool scalar)
+{
+    FILE *file = fopen(filename, "rb");
+
+    if (!file) {
+        fprintf(stderr, "SPU2-X bench: could not open %s\n", filename);
+        return -1;
+    }
+
+    u32 cycle = 0;
+    u32 events = 0;
+    bool failed = false;
+
+    if (fread(&cycle, 4, 1, file) < 1) {
+        fclose(file);
+        return -1;
+    }
+
+    replay_mode = true;
+    bench_mode = true;
+    s2r_bench_scalar = scalar;
+    memzero(s2r_stage_ticks);
+    s2r_bench_samples = 0;
+    s2r_bench_hash = 0xcbf29ce484222325ull;
+    s2r_bench_mixed = 0;
+
+    SPU2init();
+
+    // SPU2init reads the user's settings, so the output module has to be swapped after it.
+    const u32 SavedOutputModule = OutputModule;
+    OutputModule = FindOutputModuleById(L"nullout");
+
+    SPU2irqCallback(s2r_bench_dummy, s2r_bench_dma4, s2r_bench_dma7);
+    SPU2setClockPtr(&cycle);
+    SPU2open(NULL);
+
+    cycle = 0;
+    SPU2async(0);
+
+    const u64 start = s2r_ticks();
+    const u32 StepCycles = 768 * 480; // 10ms
+
+    while (!failed) {
+        u32 ccycle, sval, tval = 0;
+
+        if (fread(&ccycle, 4, 1, file) < 1 || fread(&sval, 4, 1, file) < 1)
+            break;
+
+        const u32 evid = sval >> 29;
+        sval &= 0x1FFFFFFF;
+
+        const u32 TargetCycle = ccycle * 768;
+
+        while (TargetCycle > cycle) {
+            cycle += std::min(TargetCycle - cycle, StepCycles);
+            SPU2async(0);
+        }
+
+        switch (evid) {
+            case 0:
+                SPU2read(sval);
+                break;
+            case 1:
+                failed = fread(&tval, 2, 1, file) < 1;
+                if (!failed)
+                    SPU2write(sval, tval);
+                break;
+            case 2:
+                failed = fread(dmabuffer, 2, sval, file) < sval;
+                if (!failed)
+                    SPU2writeDMA4Mem(dmabuffer, sval);
+                break;
+            case 3:
+                failed = fread(dmabuffer, 2, sval, file) < sval;
+                if (!failed)
+                    SPU2writeDMA7Mem(dmabuffer, sval);
+                break;
+            default:
+                failed = true;
+                break;
+        }
+        events++;
+    }
+
+    const u64 elapsed = s2r_ticks() - start;
+
+    SPU2close();
+    SPU2shutdown();
+    fclose(file);
+
+    bench_mode = false;
+    s2r_bench_timed = false;
+    s2r_bench_scalar = false;
+    replay_mode = false;
+    OutputModule = SavedOutputModule;
+
+    const double seconds = elapsed / 1e9;
+
+    printf("SPU2-X bench: %s%s\n", filename, scalar ? " (scalar reference mixer)" : "");
+    printf("  %u events, %llu samples (%.2fs of audio) in %.3fs\n",
+           events, (unsigned long long)s2r_bench_samples, s2r_bench_samples / 48000.0, seconds);
+    printf("  %.0f samples/sec (%.1fx realtime)\n",
+           s2r_bench_samples / seconds, s2r_bench_samples / 48000.0 / seconds);
+
+    // Estimated from the timed samples
+    static const char *const StageNames[S2R_StageCount] = {"voices", "reverb", "filters", "output"};
+    for (int i = 0; i < S2R_StageCount; i++) {
+        const double ticks = (double)s2r_stage_ticks[i] * S2R_TimedInterval;
+        printf("  %-8s %8.3fs (%5.1f%%)\n", StageNames[i], ticks / 1e9, ticks * 100.0 / elapsed);
+    }
+
+    printf("  output hash %016llx\n", (unsigned long long)s2r_bench_hash);
+
+    return failed ? -1 : 0;
+}
+
+EXPORT_C_(int)
+s2r_bench_file(const char *filename)
+{
+    return s2r_bench_run(filename, false);
+}
+
+// Replays the log through the SSE2 voice mixer and then through the scalar reference,
+// and fails if the two don't produce the same output.
+EXPORT_C_(int)
+s2r_bench_compare(const char *filename)
+{
+    if (s2r_bench_run(filename, false) != 0)
+        return -1;
+    const u64 simd_hash = s2r_bench_hash;
+
+    if (s2r_bench_run(filename, true) != 0)
+        return -1;
+    const u64 scalar_hash = s2r_bench_hash;
+
+    if (simd_hash != scalar_hash) {
+        printf("  MISMATCH: SSE2 mixer %016llx, scalar reference %016llx\n",
+               (unsigned long long)simd_hash, (unsigned long long)scalar_hash);
+        return -1;
+    }
+
+    printf("  SSE2 mixer matches the scalar reference\n");
+    return 0;
+}
+
+#ifdef _MSC_VER
+EXPORT_C_(void)
+s2r_bench(HWND hwnd, HINSTANCE hinst, LPSTR filename, int nCmdShow)
+{
+    AllocConsole();
+    freopen("CONOUT$", "w", stdout);
+    freopen("CONOUT$", "w", stderr);
+
+    s2r_bench_file(filename);
+
+    printf("Press Enter to exit.\n");
+    freopen("CONIN$", "r", stdin);
+    getchar();
+
+    FreeConsole();
+}
+#endif
@@ -29,3 +29,54 @@ void s2r_writedma7(u32 ticks, u16 *data, u32 len);
 void s2r_close();
 
 extern bool replay_mode;
+
+// s2r headless benchmark
+//
+// Replays a log through the mixer as fast as possible with the null output module, and
+// reports speed, per-stage mixer time and a hash of the final PCM.
+struct StereoOut32;
+
+enum S2R_BenchStage {
+    S2R_StageVoices,
+    S2R_StageReverb,
+    S2R_StageFilters,
+    S2R_StageOutput,
+    S2R_StageCount
+};
+
+// The stages run once per sample, which is too short to time without the clock reads
+// skewing the result.  Only one sample out of every S2R_TimedInterval is timed, and the
+// totals are scaled up when reported.
+static const u32 S2R_TimedInterval = 64;
+
+extern bool bench_mode;
+extern bool s2r_bench_timed;
+// Mix voices with the scalar reference instead of the SSE2 lanes (compare mode)
+extern bool s2r_bench_scalar;
+extern u64 s2r_stage_ticks[S2R_StageCount];
+
+u64 s2r_ticks();
+void s2r_bench_sample(const StereoOut32 &sample);
+// Called by the mixer at the start of every sample while a benchmark is running
+void s2r_bench_next_sample();
+
+// Adds the time spent in its scope to a benchmark stage; only reads the clock for the
+// timed samples of a benchmark run.
+class S2R_StageTimer
+{
+    const S2R_BenchStage m_stage;
+    const u64 m_start;
+
+public:
+    S2R_StageTimer(S2R_BenchStage stage)
+        : m_stage(stage)
+        , m_start(s2r_bench_timed ? s2r_ticks() : 0)
+    {
+    }
+
+    ~S2R_StageTimer()
+    {
+        if (s2r_bench_timed)
+            s2r_stage_ticks[m_stage] += s2r_ticks() - m_start;
+    }
+};
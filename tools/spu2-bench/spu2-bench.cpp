@@ -0,0 +1,86 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// pcsx2-spu2-bench - replays SPU2-X register logs (.s2r) through the mixer headless.
+//
+//   pcsx2-spu2-bench [--compare] <plugin> <log.s2r> [log.s2r ...]
+//
+// The plugin does the actual work (s2r_bench_file), this only loads it and runs each log
+// in turn, so the same runner works with any build of the plugin.  With --compare each log
+// is replayed through both the SSE2 voice mixer and its scalar reference
+// (s2r_bench_compare), and the two output hashes have to match.  The exit status is
+// non-zero if a log could not be replayed completely or a comparison failed.
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#define BENCH_CALL __stdcall
+#else
+#include <dlfcn.h>
+#if defined(__i386__)
+#define BENCH_CALL __attribute__((stdcall))
+#else
+#define BENCH_CALL
+#endif
+#endif
+
+typedef int(BENCH_CALL *BenchFileFn)(const char *filename);
+
+static BenchFileFn LoadBench(const char *plugin, const char *entry)
+{
+#ifdef _WIN32
+    HMODULE lib = LoadLibraryA(plugin);
+    if (!lib)
+        return NULL;
+    return (BenchFileFn)GetProcAddress(lib, entry);
+#else
+    void *lib = dlopen(plugin, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        fprintf(stderr, "%s\n", dlerror());
+        return NULL;
+    }
+    return (BenchFileFn)dlsym(lib, entry);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    int arg = 1;
+    const bool compare = argc > 1 && strcmp(argv[1], "--compare") == 0;
+    if (compare)
+        arg++;
+
+    if (argc - arg < 2) {
+        fprintf(stderr, "usage: %s [--compare] <plugin> <log.s2r> [log.s2r ...]\n", argv[0]);
+        return 2;
+    }
+
+    BenchFileFn bench = LoadBench(argv[arg], compare ? "s2r_bench_compare" : "s2r_bench_file");
+    if (!bench) {
+        fprintf(stderr, "%s is not an SPU2-X plugin with benchmark support\n", argv[arg]);
+        return 2;
+    }
+
+    int result = 0;
+    for (int i = arg + 1; i < argc; i++) {
+        if (bench(argv[i]) != 0)
+            result = 1;
+        fflush(stdout);
+    }
+
+    return result;
+}
@@ -0,0 +1,184 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// pcsx2-telemetry - samples the live metrics of a running PCSX2 process.
+//
+//   pcsx2-telemetry <pid> [interval_ms] [samples]
+//
+// Telemetry has to be enabled in the emulator (EmuCore/EnableTelemetry).  Counters are
+// shown with their rate over the interval, gauges with their last value and histograms
+// with the samples of the interval (count, mean and approximate percentiles).
+
+#include "Utilities/Telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace Telemetry;
+
+// Mapped read/write: 64-bit atomic loads may need write access on 32-bit hosts.
+static const Header *OpenSegment(u32 pid)
+{
+    char name[64];
+    FormatSegmentName(name, sizeof(name), pid);
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+    if (!mapping)
+        return NULL;
+    return (const Header *)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, SegmentSize);
+#else
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        return NULL;
+    void *ptr = mmap(NULL, SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return (ptr == MAP_FAILED) ? NULL : (const Header *)ptr;
+#endif
+}
+
+struct Sample
+{
+    u64 value;
+    u64 sum;
+    u64 buckets[HistogramBuckets];
+};
+
+static void Read(const Metric &metric, Sample &sample)
+{
+    sample.value = metric.value.load(std::memory_order_relaxed);
+    sample.sum = metric.sum.load(std::memory_order_relaxed);
+    for (u32 i = 0; i < HistogramBuckets; i++)
+        sample.buckets[i] = metric.buckets[i].load(std::memory_order_relaxed);
+}
+
+// Upper bound of the bucket holding the given fraction of the samples.
+static u64 Percentile(const Sample &cur, const Sample &prev, u64 count, double fraction)
+{
+    const u64 target = (u64)(count * fraction);
+    u64 seen = 0;
+    for (u32 i = 0; i < HistogramBuckets; i++) {
+        seen += cur.buckets[i] - prev.buckets[i];
+        if (seen > target)
+            return i ? (1ULL << i) - 1 : 0;
+    }
+    return ~0ULL;
+}
+
+static void Print(const Metric &metric, const Sample &cur, const Sample &prev, double seconds)
+{
+    const char *name = metric.name;
+
+    switch (metric.type.load(std::memory_order_acquire)) {
+        case Metric_Counter: {
+            const double rate = (cur.value - prev.value) / seconds;
+            const size_t len = strlen(name);
+
+            // CPU times in microseconds read better as the load of one core
+            if (len > 3 && !strcmp(name + len - 3, "_us"))
+                printf("  %-28s %16llu  %12.1f/s  (%.1f%%)\n", name, (unsigned long long)cur.value, rate, rate / 10000.0);
+            else
+                printf("  %-28s %16llu  %12.1f/s\n", name, (unsigned long long)cur.value, rate);
+            break;
+        }
+
+        case Metric_Gauge: {
+            double value;
+            memcpy(&value, &cur.value, sizeof(value));
+            printf("  %-28s %16.2f\n", name, value);
+            break;
+        }
+
+        case Metric_Histogram: {
+            const u64 count = cur.value - prev.value;
+            if (!count) {
+                printf("  %-28s %16s\n", name, "-");
+                break;
+            }
+
+            printf("  %-28s %16.1f  n=%llu p50<=%llu p99<=%llu\n", name, (double)(cur.sum - prev.sum) / count,
+                   (unsigned long long)count,
+                   (unsigned long long)Percentile(cur, prev, count, 0.50),
+                   (unsigned long long)Percentile(cur, prev, count, 0.99));
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <pid> [interval_ms] [samples]\n", argv[0]);
+        return 1;
+    }
+
+    const u32 pid = strtoul(argv[1], NULL, 10);
+    const u32 interval = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000;
+    const u32 samples = (argc > 3) ? strtoul(argv[3], NULL, 10) : 0;
+
+    const Header *header = OpenSegment(pid);
+    if (!header) {
+        fprintf(stderr, "No telemetry for process %u (is EnableTelemetry set, and the emulation running?)\n", pid);
+        return 1;
+    }
+
+    if (header->magic.load(std::memory_order_acquire) != Magic || header->version != Version) {
+        fprintf(stderr, "Unsupported telemetry block (version %u, expected %u)\n", header->version, Version);
+        return 1;
+    }
+
+    const Metric *metrics = (const Metric *)(header + 1);
+    std::vector<Sample> prev(MaxMetrics), cur(MaxMetrics);
+
+    auto last = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < MaxMetrics; i++)
+        Read(metrics[i], prev[i]);
+
+    for (u32 n = 0; !samples || n < samples; n++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - last).count();
+        last = now;
+
+        const u32 count = std::min(header->count.load(std::memory_order_acquire), MaxMetrics);
+        printf("[%u metrics, %.3fs]\n", count, seconds);
+
+        for (u32 i = 0; i < count; i++) {
+            Read(metrics[i], cur[i]);
+            Print(metrics[i], cur[i], prev[i], seconds);
+            prev[i] = cur[i];
+        }
+
+        fflush(stdout);
+    }
+
+    return 0;
+}